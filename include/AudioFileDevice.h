@@ -64,6 +64,10 @@ protected:
 private:
 	QFile m_outputFile;
 	OutputSettings m_outputSettings;
+
+	// fetches and encodes buffers on different threads
+	friend class ProjectRenderer;
+
 } ;
 
 
@@ -64,6 +64,11 @@ private:
 private:
 	SF_INFO m_si;
 	SNDFILE * m_sf;
+
+	// conversion buffers for one period, only the one matching the bit
+	// depth is allocated
+	float * m_floatBuffer;
+	int_sample_t * m_intBuffer;
 } ;
 
 #endif
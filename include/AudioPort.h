@@ -29,6 +29,7 @@
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
 
+#include "CompensationDelay.h"
 #include "MemoryManager.h"
 #include "PlayHandle.h"
 
@@ -88,6 +89,24 @@ public:
 	}
 
 
+	// latency of whatever renders into this port, e.g. the instrument
+	void setSourceLatency( f_cnt_t _frames )
+	{
+		m_sourceLatency = _frames;
+	}
+
+	// latency of the signal when it leaves the port, not counting the
+	// compensation delay
+	f_cnt_t latency() const;
+
+	// delays the output so that it arrives at the FX channel in sync with
+	// paths of higher latency - managed by FxMixer
+	CompensationDelay * compensation()
+	{
+		return &m_compensation;
+	}
+
+
 	const QString & name() const
 	{
 		return m_name;
@@ -121,6 +140,9 @@ private:
 
 	EffectChain * m_effects;
 
+	f_cnt_t m_sourceLatency;
+	CompensationDelay m_compensation;
+
 	PlayHandleList m_playHandles;
 	QMutex m_playHandleLock;
 
@@ -28,6 +28,9 @@
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
 
+#include <functional>
+
+#include "AtomicInt.h"
 #include "JournallingObject.h"
 #include "Model.h"
 #include "MidiTime.h"
@@ -69,6 +72,7 @@ class EXPORT AutomatableModel : public Model, public JournallingObject
 	MM_OPERATORS
 public:
 	typedef QVector<AutomatableModel *> AutoModelVector;
+	typedef std::function<void()> ValueListener;
 
 	enum ScaleType
 	{
@@ -286,6 +290,23 @@ public:
 		s_periodCounter = 0;
 	}
 
+	//! @brief Registers a callback for audio-side state which has to follow
+	//! every value change. Unlike dataChanged(), which is only delivered
+	//! from the GUI thread for changes made elsewhere, it's invoked
+	//! synchronously from whichever thread changed the value - so keep it
+	//! cheap. If it may become invalid before the model is destroyed, pass
+	//! an owner and call removeValueListeners() with it in time.
+	void addValueListener( const ValueListener & listener,
+						const void * owner = NULL );
+
+	//! @brief Removes all value listeners registered with owner
+	void removeValueListeners( const void * owner );
+
+	//! @brief Emits dataChanged() for all models changed by other threads
+	//! (usually the mixer thread playing automation) since the last call.
+	//! Must be called from the GUI thread.
+	static void sendPendingNotifications();
+
 public slots:
 	virtual void reset();
 	virtual void copyValue();
@@ -293,6 +314,13 @@ public slots:
 	void unlinkControllerConnection();
 
 
+private slots:
+	void controllerValueChanged()
+	{
+		notifyValueChanged();
+	}
+
+
 protected:
 	//! returns a value which is in range between min() and
 	//! max() and aligned according to the step size (step size 0.05 -> value
@@ -315,6 +343,8 @@ private:
 	void linkModel( AutomatableModel* model );
 	void unlinkModel( AutomatableModel* model );
 
+	void notifyValueChanged();
+
 	//! @brief Scales @value from linear to logarithmic.
 	//! Value should be within [0,1]
 	template<class T> T logToLinearScale( T value ) const;
@@ -363,6 +393,19 @@ private:
 	// prevent several threads from attempting to write the same vb at the same time
 	QMutex m_valueBufferMutex;
 
+	struct ValueListenerEntry
+	{
+		ValueListener listener;
+		const void * owner;
+	} ;
+
+	QVector<ValueListenerEntry> m_valueListeners;
+	// listeners are called from the rendering thread while owners may
+	// remove theirs from the GUI thread
+	QMutex m_valueListenersMutex;
+	// set while this model is queued for sendPendingNotifications()
+	AtomicInt m_notificationPending;
+
 signals:
 	void initValueChanged( float val );
 	void destroyed( jo_id_t id );
@@ -41,6 +41,7 @@
 #include "lmms_basics.h"
 #include "templates.h"
 #include "lmms_constants.h"
+#include "lmms_math.h"
 #include "interpolation.h"
 #include "MemoryManager.h"
 
@@ -129,6 +130,40 @@ public:
 		return y;
 	}
 
+	/*! processes a whole block with fixed coefficients, producing the same
+	    output as calling update() for every frame and channel */
+	inline void processBuffer( sample_t ( * buf )[CHANNELS], const fpp_t frames )
+	{
+		frame z1, z2, z3, z4;
+		for( int ch = 0; ch < CHANNELS; ++ch )
+		{
+			z1[ch] = m_z1[ch]; z2[ch] = m_z2[ch];
+			z3[ch] = m_z3[ch]; z4[ch] = m_z4[ch];
+		}
+
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			for( int ch = 0; ch < CHANNELS; ++ch )
+			{
+				const double x = buf[f][ch] - ( z1[ch] * m_b1 ) - ( z2[ch] * m_b2 ) -
+					( z3[ch] * m_b3 ) - ( z4[ch] * m_b4 );
+				const double y = ( m_a0 * x ) + ( z1[ch] * m_a1 ) + ( z2[ch] * m_a2 ) +
+					( z3[ch] * m_a1 ) + ( z4[ch] * m_a0 );
+				z4[ch] = z3[ch];
+				z3[ch] = z2[ch];
+				z2[ch] = z1[ch];
+				z1[ch] = x;
+				buf[f][ch] = y;
+			}
+		}
+
+		for( int ch = 0; ch < CHANNELS; ++ch )
+		{
+			m_z1[ch] = z1[ch]; m_z2[ch] = z2[ch];
+			m_z3[ch] = z3[ch]; m_z4[ch] = z4[ch];
+		}
+	}
+
 private:
 	float m_sampleRate;
 	double m_wc4;
@@ -146,7 +181,8 @@ class BiQuad
 {
 	MM_OPERATORS
 public:
-	BiQuad() 
+	BiQuad() :
+		m_gliding( false )
 	{
 		clearHistory();
 	}
@@ -159,6 +195,20 @@ public:
 		m_b0 = b0;
 		m_b1 = b1;
 		m_b2 = b2;
+		m_gliding = false;
+	}
+
+	/*! sets coefficients the next processBuffer() call moves to linearly
+	    over its block, so coefficients updated once per block don't cause
+	    steps in the output - update() doesn't glide */
+	inline void glideCoeffs( float a1, float a2, float b0, float b1, float b2 )
+	{
+		m_targetA1 = a1;
+		m_targetA2 = a2;
+		m_targetB0 = b0;
+		m_targetB1 = b1;
+		m_targetB2 = b2;
+		m_gliding = true;
 	}
 	inline void clearHistory()
 	{
@@ -176,8 +226,82 @@ public:
 		m_z2[ch] = m_b2 * in - m_a2 * out;
 		return out;
 	}
+
+	/*! processes a whole block with fixed coefficients, producing the same
+	    output as calling update() for every frame and channel
+
+	    The filter state is kept in locals for the duration of the block and
+	    all channels are handled in the inner loop, so the compiler can keep
+	    them in registers and process the channels in SIMD lanes. */
+	inline void processBuffer( sample_t ( * buf )[CHANNELS], const fpp_t frames )
+	{
+		if( m_gliding )
+		{
+			processBufferGliding( buf, frames );
+			return;
+		}
+
+		const float a1 = m_a1, a2 = m_a2;
+		const float b0 = m_b0, b1 = m_b1, b2 = m_b2;
+		float z1[CHANNELS], z2[CHANNELS];
+		for( int ch = 0; ch < CHANNELS; ++ch )
+		{
+			z1[ch] = m_z1[ch];
+			z2[ch] = m_z2[ch];
+		}
+
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			for( int ch = 0; ch < CHANNELS; ++ch )
+			{
+				const float in = buf[f][ch];
+				const float out = z1[ch] + b0 * in;
+				z1[ch] = b1 * in + z2[ch] - a1 * out;
+				z2[ch] = b2 * in - a2 * out;
+				buf[f][ch] = out;
+			}
+		}
+
+		for( int ch = 0; ch < CHANNELS; ++ch )
+		{
+			m_z1[ch] = z1[ch];
+			m_z2[ch] = z2[ch];
+		}
+	}
 private:
+	// the coefficients reach the target ones with the last frame
+	void processBufferGliding( sample_t ( * buf )[CHANNELS], const fpp_t frames )
+	{
+		const float step = 1.0f / frames;
+		const float da1 = ( m_targetA1 - m_a1 ) * step;
+		const float da2 = ( m_targetA2 - m_a2 ) * step;
+		const float db0 = ( m_targetB0 - m_b0 ) * step;
+		const float db1 = ( m_targetB1 - m_b1 ) * step;
+		const float db2 = ( m_targetB2 - m_b2 ) * step;
+
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			const float a1 = m_a1 + da1 * ( f + 1 );
+			const float a2 = m_a2 + da2 * ( f + 1 );
+			const float b0 = m_b0 + db0 * ( f + 1 );
+			const float b1 = m_b1 + db1 * ( f + 1 );
+			const float b2 = m_b2 + db2 * ( f + 1 );
+			for( int ch = 0; ch < CHANNELS; ++ch )
+			{
+				const float in = buf[f][ch];
+				const float out = m_z1[ch] + b0 * in;
+				m_z1[ch] = b1 * in + m_z2[ch] - a1 * out;
+				m_z2[ch] = b2 * in - a2 * out;
+				buf[f][ch] = out;
+			}
+		}
+
+		setCoeffs( m_targetA1, m_targetA2, m_targetB0, m_targetB1, m_targetB2 );
+	}
+
 	float m_a1, m_a2, m_b0, m_b1, m_b2;
+	float m_targetA1, m_targetA2, m_targetB0, m_targetB1, m_targetB2;
+	bool m_gliding;
 	float m_z1 [CHANNELS], m_z2 [CHANNELS];
 	
 	friend class BasicFilters<CHANNELS>; // needed for subfilter stuff in BasicFilters
@@ -775,7 +899,7 @@ public:
 			// (Empirical tunning)
 			m_p = ( 3.6f - 3.2f * f ) * f;
 			m_k = 2.0f * m_p - 1;
-			m_r = _q * powf( F_E, ( 1 - m_p ) * 1.386249f );
+			m_r = _q * fastExpf( ( 1 - m_p ) * 1.386249f );
 
 			if( m_doubleFilter )
 			{
@@ -792,7 +916,7 @@ public:
 			
 			m_p = ( 3.6f - 3.2f * f ) * f;
 			m_k = 2.0f * m_p - 1.0f;
-			m_r = _q * 0.1f * powf( F_E, ( 1 - m_p ) * 1.386249f );
+			m_r = _q * 0.1f * fastExpf( ( 1 - m_p ) * 1.386249f );
 			
 			return;
 		}
@@ -802,7 +926,7 @@ public:
 			m_type == Highpass_SV ||
 			m_type == Notch_SV )
 		{
-			const float f = sinf( qMax( minFreq(), _freq ) * m_sampleRatio * F_PI );
+			const float f = fastSinf( qMax( minFreq(), _freq ) * m_sampleRatio * F_PI );
 			m_svf1 = qMin( f, 0.825f );
 			m_svf2 = qMin( f * 2.0f, 0.825f );
 			m_svq = qMax( 0.0001f, 2.0f - ( _q * 0.1995f ) );
@@ -812,8 +936,8 @@ public:
 		// other filters
 		_freq = qBound( minFreq(), _freq, 20000.0f );
 		const float omega = F_2PI * _freq * m_sampleRatio;
-		const float tsin = sinf( omega ) * 0.5f;
-		const float tcos = cosf( omega );
+		const float tsin = fastSinf( omega ) * 0.5f;
+		const float tcos = fastCosf( omega );
 
 		const float alpha = tsin / _q;
 
@@ -0,0 +1,109 @@
+/*
+ * CompactSampleData.h - memory saving storage for sample data
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef COMPACT_SAMPLE_DATA_H
+#define COMPACT_SAMPLE_DATA_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+#include "export.h"
+#include "lmms_basics.h"
+#include "MemoryManager.h"
+
+
+/** \brief Stores sample data in a fraction of the memory of sampleFrames.
+ *
+ * 	Samples are quantized to 16 bit and kept as a single channel if both
+ * 	channels are equal. Data decoded from 16 bit files keeps its exact
+ * 	values, louder or finer data is quantized relative to its peak. Every block of
+ * 	BlockFrames frames is coded on its own with a second order predictor
+ * 	whose residuals are bit-packed in small groups, which is lossless with
+ * 	respect to the 16 bit samples.
+ *
+ * 	read() decodes whole blocks and keeps the last few of them in a cache,
+ * 	so sequential reads cost a single decode per block. It can be called
+ * 	from several threads at once.
+ */
+class EXPORT CompactSampleData
+{
+	MM_OPERATORS
+public:
+	static const f_cnt_t BlockFrames = 1024;
+
+	CompactSampleData( const sampleFrame * _data, f_cnt_t _frames );
+	~CompactSampleData();
+
+	inline f_cnt_t frames() const
+	{
+		return m_frames;
+	}
+
+	inline ch_cnt_t channels() const
+	{
+		return m_channels;
+	}
+
+	//! memory used for the coded data, without the cache
+	int size() const
+	{
+		return m_stream.size() + m_blockOffsets.size() * sizeof( int );
+	}
+
+	//! writes _frames frames starting at _from to _dst, frames outside of
+	//! the data are silent
+	void read( f_cnt_t _from, f_cnt_t _frames, sampleFrame * _dst ) const;
+
+	//! decodes a whole block to _dst, bypassing the cache
+	void decodeBlock( int _block, sampleFrame * _dst ) const;
+
+
+private:
+	static const int GroupSize = 32;
+	static const int CacheBlocks = 8;
+
+	f_cnt_t blockFrames( int _block ) const
+	{
+		return qMin( BlockFrames, m_frames - _block * BlockFrames );
+	}
+
+	void encodeBlock( const sampleFrame * _data, f_cnt_t _frames );
+	const sampleFrame * cachedBlock( int _block ) const;
+
+	f_cnt_t m_frames;
+	ch_cnt_t m_channels;
+	float m_scale;
+
+	QByteArray m_stream;
+	QVector<int> m_blockOffsets;
+
+	mutable QMutex m_cacheLock;
+	mutable sampleFrame * m_cache;
+	mutable int m_cachedBlocks[CacheBlocks];
+	mutable unsigned int m_cacheUse[CacheBlocks];
+	mutable unsigned int m_cacheClock;
+
+} ;
+
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * CompensationDelay.h - fixed delay line for aligning signal paths with
+ *                       different processing latency
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef COMPENSATION_DELAY_H
+#define COMPENSATION_DELAY_H
+
+#include <cstring>
+
+#include "lmms_basics.h"
+
+
+/** \brief Integer delay line used by the FX mixer for plugin delay
+ * 	compensation.
+ *
+ * 	Besides delaying the signal it keeps track of how much of it is still
+ * 	stored, so callers can skip silent paths just as they did without
+ * 	compensation while still flushing the tail once the input stopped.
+ */
+class CompensationDelay
+{
+public:
+	CompensationDelay() :
+		m_buffer( NULL ),
+		m_delay( 0 ),
+		m_position( 0 ),
+		m_pending( 0 )
+	{
+	}
+
+	~CompensationDelay()
+	{
+		delete[] m_buffer;
+	}
+
+	inline f_cnt_t delay() const
+	{
+		return m_delay;
+	}
+
+	//! changes the delay, clearing the history if it actually changed
+	void setDelay( f_cnt_t delay )
+	{
+		if( delay == m_delay )
+		{
+			return;
+		}
+
+		delete[] m_buffer;
+		m_buffer = delay > 0 ? new sampleFrame[delay] : NULL;
+		m_delay = delay;
+		clear();
+	}
+
+	void clear()
+	{
+		if( m_buffer )
+		{
+			memset( m_buffer, 0, sizeof( sampleFrame ) * m_delay );
+		}
+		m_position = 0;
+		m_pending = 0;
+	}
+
+	/*! Writes frames from src (or silence if hasInput is false) and
+	    stores the same number of delayed frames to dst. src and dst may be
+	    the same buffer. Returns false if dst is known to be silent, in which
+	    case it has not been touched at all. */
+	bool process( const sampleFrame * src, sampleFrame * dst,
+					const fpp_t frames, const bool hasInput )
+	{
+		if( m_delay == 0 )
+		{
+			if( hasInput && src != dst )
+			{
+				memcpy( dst, src, sizeof( sampleFrame ) * frames );
+			}
+			return hasInput;
+		}
+
+		if( !hasInput && m_pending <= 0 )
+		{
+			return false;
+		}
+
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			const sample_t l = m_buffer[m_position][0];
+			const sample_t r = m_buffer[m_position][1];
+			if( hasInput )
+			{
+				m_buffer[m_position][0] = src[f][0];
+				m_buffer[m_position][1] = src[f][1];
+			}
+			else
+			{
+				m_buffer[m_position][0] = 0.0f;
+				m_buffer[m_position][1] = 0.0f;
+			}
+			dst[f][0] = l;
+			dst[f][1] = r;
+
+			if( ++m_position >= m_delay )
+			{
+				m_position = 0;
+			}
+		}
+
+		m_pending = hasInput ? m_delay : m_pending - frames;
+
+		return true;
+	}
+
+
+private:
+	sampleFrame * m_buffer;
+	f_cnt_t m_delay;
+	f_cnt_t m_position;
+	f_cnt_t m_pending;
+
+} ;
+
+
+#endif
@@ -27,9 +27,13 @@
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
 
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
 #include "Engine.h"
 #include "Model.h"
 #include "JournallingObject.h"
+#include "ThreadableJob.h"
 #include "templates.h"
 #include "ValueBuffer.h"
 
@@ -40,7 +44,7 @@ class ControllerConnection;
 typedef QVector<Controller *> ControllerVector;
 
 
-class Controller : public Model, public JournallingObject
+class Controller : public Model, public JournallingObject, public ThreadableJob
 {
 	Q_OBJECT
 public:
@@ -124,6 +128,16 @@ public:
 	static void triggerFrameCounter();
 	static void resetFrameCounter();
 
+	// called by the mixer once per period before anything else is
+	// processed: updates the value buffers of all connected controllers in
+	// dependency order so they're read-only for the rest of the period
+	static void evaluateControllers();
+
+	virtual bool requiresProcessing() const
+	{
+		return true;
+	}
+
 	//Accepts a ControllerConnection * as it may be used in the future.
 	void addConnection( ControllerConnection * );
 	void removeConnection( ControllerConnection * );
@@ -147,6 +161,8 @@ protected:
 
 	virtual void updateValueBuffer();
 
+	virtual void doProcessing();
+
 	// buffer for storing sample-exact values in case there
 	// are more than one model wanting it, so we don't have to create it
 	// again every time
@@ -161,11 +177,24 @@ protected:
 	QString m_name;
 	ControllerTypes m_type;
 
+	// whether evaluateControllers() takes care of this controller
+	bool m_scheduled;
+
 	static ControllerVector s_controllers;
 
 	static long s_periods;
 
 
+private:
+	static void updateEvaluationOrder();
+	static int evaluationLevel( Controller * c,
+				QHash<Controller *, int> & levels );
+
+	static QMutex s_controllersMutex;
+	static bool s_evaluationOrderDirty;
+	static QVector<ControllerVector> s_evaluationOrder;
+
+
 signals:
 	// The value changed while the mixer isn't running (i.e: MIDI CC)
 	void valueChanged();
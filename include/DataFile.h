@@ -84,6 +84,10 @@ public:
 		return m_type;
 	}
 
+	// type of the DataFile _doc was created as, UnknownType for other
+	// documents
+	static Type documentType( const QDomDocument& doc );
+
 private:
 	static Type type( const QString& typeName );
 	static QString typeName( Type type );
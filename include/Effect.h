@@ -34,6 +34,7 @@
 #include "MemoryManager.h"
 
 class EffectChain;
+class Oversampler;
 class EffectControls;
 
 
@@ -59,6 +60,33 @@ public:
 	virtual bool processAudioBuffer( sampleFrame * _buf,
 						const fpp_t _frames ) = 0;
 
+	// number of frames the output of processAudioBuffer() lags behind
+	// its input - effects with look-ahead or asynchronous processing
+	// re-implement this
+	virtual f_cnt_t latency() const
+	{
+		return 0;
+	}
+
+	// effects whose processing does not depend on the sample rate (e.g.
+	// waveshapers) can be run oversampled - processAudioBuffer() then gets
+	// oversampling() times as many frames, while value buffers of
+	// automated models still hold one value per frame at the engine rate
+	virtual bool supportsOversampling() const
+	{
+		return false;
+	}
+
+	// factor the effect is currently run at
+	int oversampling() const;
+
+	// runs processAudioBuffer(), up- and downsampling around it if
+	// oversampling is enabled for this effect
+	bool process( sampleFrame * _buf, const fpp_t _frames );
+
+	// overall latency at the engine rate including the oversampling filters
+	f_cnt_t processingLatency() const;
+
 	inline ch_cnt_t processorCount() const
 	{
 		return m_processors;
@@ -194,6 +222,10 @@ protected:
 	void reinitSRC();
 
 
+private slots:
+	void updateOversampling();
+
+
 private:
 	EffectChain * m_parent;
 	void resample( int _i, const sampleFrame * _src_buf,
@@ -214,9 +246,13 @@ private:
 	FloatModel m_wetDryModel;
 	FloatModel m_gateModel;
 	TempoSyncKnobModel m_autoQuitModel;
+	// log2 of the oversampling factor
+	IntModel m_oversamplingModel;
 	
 	bool m_autoQuitDisabled;
 
+	Oversampler * m_oversampler;
+
 	SRC_DATA m_srcData[2];
 	SRC_STATE * m_srcState[2];
 
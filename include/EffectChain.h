@@ -55,6 +55,9 @@ public:
 	bool processAudioBuffer( sampleFrame * _buf, const fpp_t _frames, bool hasInputNoise );
 	void startRunning();
 
+	// total latency of all enabled effects in this chain
+	f_cnt_t latency() const;
+
 	void clear();
 
 	void setEnabled( bool _on )
@@ -30,6 +30,7 @@
 #include "PluginView.h"
 #include "Effect.h"
 
+class QAction;
 class QGroupBox;
 class QLabel;
 class QPushButton;
@@ -65,6 +66,7 @@ public slots:
 	void deletePlugin();
 	void displayHelp();
 	void closeEffects();
+	void setOversampling( QAction * _action );
 
 
 signals:
@@ -31,6 +31,7 @@
 
 
 #include "export.h"
+#include "lmms_basics.h"
 
 class BBTrackContainer;
 class DummyTrackContainer;
@@ -57,7 +58,9 @@ class EXPORT LmmsCore : public QObject
 {
 	Q_OBJECT
 public:
-	static void init( bool renderOnly );
+	//! renderFramesPerPeriod overrides the period size when rendering only,
+	//! 0 keeps the default
+	static void init( bool renderOnly, fpp_t renderFramesPerPeriod = 0 );
 	static void destroy();
 
 	// core
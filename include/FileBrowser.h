@@ -28,6 +28,7 @@
 
 #include <QtCore/QDir>
 #include <QtCore/QMutex>
+#include <QtCore/QTimer>
 #include <QTreeWidget>
 
 
@@ -106,6 +107,12 @@ private:
 	PlayHandle* m_previewPlayHandle;
 	QMutex m_pphMutex;
 
+	// preset loaded ahead by prefetchPreset() once the user paused
+	// for m_prefetchTimer - loading blocks the GUI
+	QString m_prefetchFile;
+	bool m_prefetchByPlugin;
+	QTimer m_prefetchTimer;
+
 	FileItem * m_contextMenuItem;
 
 
@@ -115,6 +122,7 @@ private slots:
 	void openInNewInstrumentTrackSE( void );
 	void sendToActiveInstrumentTrack( void );
 	void updateDirectory( QTreeWidgetItem * item );
+	void prefetchPreset();
 
 } ;
 
@@ -59,6 +59,9 @@ public:
 	inline int channelIndex() { return m_channelIndex; }
 	void setChannelIndex(int index);
 
+	// percentage of the period spent on this channel, -1 if not measured
+	void setCpuLoad( int load );
+
 	Knob * m_sendKnob;
 	SendButtonIndicator * m_sendBtn;
 
@@ -86,6 +89,7 @@ private:
 	FxMixerView * m_mv;
 	LcdWidget* m_lcd;
 	int m_channelIndex;
+	int m_cpuLoad;
 	QBrush m_backgroundActive;
 	QColor m_strokeOuterActive;
 	QColor m_strokeOuterInactive;
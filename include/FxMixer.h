@@ -26,11 +26,13 @@
 #define FX_MIXER_H
 
 #include "Model.h"
+#include "CompensationDelay.h"
 #include "EffectChain.h"
 #include "JournallingObject.h"
 #include "ThreadableJob.h"
 
 
+class AudioPort;
 class FxRoute;
 typedef QVector<FxRoute *> FxRouteVector;
 
@@ -59,6 +61,7 @@ class FxChannel : public ThreadableJob
 		int m_channelIndex; // what channel index are we
 		bool m_queued; // are we queued up for rendering yet?
 		bool m_muted; // are we muted? updated per period so we don't have to call m_muteModel.value() twice
+		int m_cpuLoad; // percentage of a period spent on this channel and the tracks sending to it, see MixerProfiler
 
 		// pointers to other channels that this one sends to
 		FxRouteVector m_sends;
@@ -110,6 +113,12 @@ class FxRoute : public QObject
 	{
 		return m_to;
 	}
+
+	// delays the sent signal if the receiver gets input with higher latency
+	CompensationDelay * compensation()
+	{
+		return &m_compensation;
+	}
 	
 	void updateName();
 		
@@ -117,6 +126,7 @@ class FxRoute : public QObject
 		FxChannel * m_from;
 		FxChannel * m_to;
 		FloatModel m_amount;
+		CompensationDelay m_compensation;
 };
 
 
@@ -193,6 +203,13 @@ public:
 		return m_fxChannels.size();
 	}
 
+	// latency of the master output relative to the tracks' input,
+	// i.e. of the slowest path through the mixer
+	inline f_cnt_t latency() const
+	{
+		return m_latency;
+	}
+
 	FxRouteVector m_fxRoutes;
 
 private:
@@ -202,8 +219,27 @@ private:
 	// make sure we have at least num channels
 	void allocateChannelsTo(int num);
 
+	// plugin delay compensation
+	bool latencyChanged() const;
+	void updateLatencyCompensation();
+	f_cnt_t channelOutputLatency( int index );
+
 	int m_lastSoloed;
 
+	struct PortLatency
+	{
+		AudioPort * port;
+		fx_ch_t channel;
+		f_cnt_t latency;
+	} ;
+
+	bool m_routingChanged;
+	QVector<PortLatency> m_portLatencies;
+	QVector<f_cnt_t> m_chainLatencies;
+	QVector<f_cnt_t> m_inputLatencies;
+	QVector<f_cnt_t> m_outputLatencies;
+	f_cnt_t m_latency;
+
 } ;
 
 
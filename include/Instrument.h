@@ -100,6 +100,13 @@ public:
 		return NoFlags;
 	}
 
+	// number of frames the rendered output lags behind incoming notes,
+	// e.g. because the instrument is processed asynchronously
+	virtual f_cnt_t latency() const
+	{
+		return 0;
+	}
+
 	// sub-classes can re-implement this for receiving all incoming
 	// MIDI-events
 	inline virtual bool handleMidiEvent( const MidiEvent&, const MidiTime& = MidiTime(), f_cnt_t offset = 0 )
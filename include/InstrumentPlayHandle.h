@@ -69,6 +69,8 @@ public:
 		return false;
 	}
 
+	virtual bool requiresProcessing() const;
+
 	virtual bool isFromTrack( const Track* _track ) const
 	{
 		return m_instrument->isFromTrack( _track );
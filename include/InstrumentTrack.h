@@ -210,6 +210,11 @@ public:
 
 	void setPreviewMode( const bool );
 
+	bool isPreviewMode() const
+	{
+		return m_previewMode;
+	}
+
 
 signals:
 	void instrumentChanged();
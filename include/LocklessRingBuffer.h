@@ -0,0 +1,148 @@
+/*
+ * LocklessRingBuffer.h - single-producer/single-consumer ring buffer with
+ *                        lockless read and write
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LOCKLESS_RING_BUFFER_H
+#define LOCKLESS_RING_BUFFER_H
+
+#include <QAtomicInt>
+
+#include <cstring>
+
+
+/** \brief Fixed-size FIFO for passing POD data from exactly one writer
+ * 	thread to exactly one reader thread without locking.
+ *
+ * 	Neither write() nor read() ever blocks or allocates, so the buffer can
+ * 	be fed from the audio thread. If the reader does not keep up, write()
+ * 	drops whatever does not fit and reports how much was stored.
+ */
+template<typename T>
+class LocklessRingBuffer
+{
+public:
+	LocklessRingBuffer( int capacity ) :
+		m_capacity( capacity + 1 ),
+		m_data( new T[capacity + 1] ),
+		m_readPos( 0 ),
+		m_writePos( 0 )
+	{
+	}
+
+	~LocklessRingBuffer()
+	{
+		delete[] m_data;
+	}
+
+	int capacity() const
+	{
+		return m_capacity - 1;
+	}
+
+	//! number of elements which can be read right now (reader side)
+	int available() const
+	{
+		const int w = load( m_writePos );
+		const int r = load( m_readPos );
+		return w >= r ? w - r : w + m_capacity - r;
+	}
+
+	//! number of elements which can be written right now (writer side)
+	int free() const
+	{
+		return capacity() - available();
+	}
+
+	//! append up to count elements, returns number of elements written
+	int write( const T * src, int count )
+	{
+		const int w = load( m_writePos );
+		const int r = load( m_readPos );
+		const int space = ( r > w ? r - w : r + m_capacity - w ) - 1;
+		if( count > space )
+		{
+			count = space;
+		}
+
+		const int first = qMin( count, m_capacity - w );
+		memcpy( m_data + w, src, first * sizeof( T ) );
+		memcpy( m_data, src + first, ( count - first ) * sizeof( T ) );
+
+		store( m_writePos, ( w + count ) % m_capacity );
+		return count;
+	}
+
+	//! fetch up to count elements, returns number of elements read
+	int read( T * dst, int count )
+	{
+		const int r = load( m_readPos );
+		const int w = load( m_writePos );
+		const int avail = w >= r ? w - r : w + m_capacity - r;
+		if( count > avail )
+		{
+			count = avail;
+		}
+
+		const int first = qMin( count, m_capacity - r );
+		memcpy( dst, m_data + r, first * sizeof( T ) );
+		memcpy( dst + first, m_data, ( count - first ) * sizeof( T ) );
+
+		store( m_readPos, ( r + count ) % m_capacity );
+		return count;
+	}
+
+	//! drop everything currently queued - must be called from reader side
+	void skip()
+	{
+		store( m_readPos, load( m_writePos ) );
+	}
+
+
+private:
+	static inline int load( const QAtomicInt & a )
+	{
+#if QT_VERSION >= 0x050000
+		return a.loadAcquire();
+#else
+		return a;
+#endif
+	}
+
+	static inline void store( QAtomicInt & a, int v )
+	{
+#if QT_VERSION >= 0x050000
+		a.storeRelease( v );
+#else
+		a.fetchAndStoreOrdered( v );
+#endif
+	}
+
+	const int m_capacity;
+	T * m_data;
+
+	QAtomicInt m_readPos;
+	QAtomicInt m_writePos;
+
+} ;
+
+
+#endif
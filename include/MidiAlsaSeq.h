@@ -69,6 +69,7 @@ public:
 	virtual void processOutEvent( const MidiEvent & _me,
 						const MidiTime & _time,
 						const MidiPort * _port );
+	virtual void flushOutEvents();
 
 	virtual void applyPortMode( MidiPort * _port );
 	virtual void applyPortName( MidiPort * _port );
@@ -130,6 +131,13 @@ private:
 		private: int p[2];
 	} ;
 	QMap<MidiPort *, Ports> m_portIDs;
+
+	// queued input events refer to their source by pointer, so keep
+	// copies of the addresses as the event they were taken from gets freed
+	// right after queueing
+	static const int SourceAddressCount = 1024;
+	snd_seq_addr_t m_sourceAddresses[SourceAddressCount];
+	int m_sourceAddressPos;
 #endif
 
 	int m_queueID;
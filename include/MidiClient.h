@@ -49,6 +49,19 @@ public:
 						const MidiTime & _time,
 						const MidiPort * _port ) = 0;
 
+	// called by the mixer at the end of each period - clients which
+	// buffer output events have to send them out here
+	virtual void flushOutEvents()
+	{
+	}
+
+	// called by the mixer at the beginning of each period for applying
+	// MIDI input queued by MidiPort::queueInEvent()
+	void processQueuedInEvents( fpp_t _frames, sample_rate_t _sample_rate );
+
+	// microseconds on a monotonic clock, used for timestamping MIDI input
+	static qint64 timestamp();
+
 	// inheriting classes can re-implement this for being able to update
 	// their internal port-structures etc.
 	virtual void applyPortMode( MidiPort * _port );
@@ -131,8 +144,13 @@ public:
 
 
 protected:
-	// generic raw-MIDI-parser which generates appropriate MIDI-events
-	void parseData( const unsigned char c );
+	// generic raw-MIDI-parser which generates appropriate MIDI-events -
+	// timestamp is the time the byte was received at
+	void parseData( const unsigned char c, qint64 timestamp );
+	void parseData( const unsigned char c )
+	{
+		parseData( c, MidiClient::timestamp() );
+	}
 
 	// to be implemented by actual client-implementation
 	virtual void sendByte( const unsigned char c ) = 0;
@@ -140,7 +158,7 @@ protected:
 
 private:
 	// this does MIDI-event-process
-	void processParsedEvent();
+	void processParsedEvent( qint64 timestamp );
 	virtual void processOutEvent( const MidiEvent& event, const MidiTime& time, const MidiPort* port );
 
 	// small helper function returning length of a certain event - this
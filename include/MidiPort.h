@@ -31,12 +31,13 @@
 #include <QtCore/QMap>
 
 #include "Midi.h"
+#include "MidiEvent.h"
 #include "MidiTime.h"
 #include "AutomatableModel.h"
+#include "LocklessRingBuffer.h"
 
 
 class MidiClient;
-class MidiEvent;
 class MidiEventProcessor;
 class MidiPortMenu;
 
@@ -99,9 +100,20 @@ public:
 		return outputChannel() - 1;
 	}
 
-	void processInEvent( const MidiEvent& event, const MidiTime& time = MidiTime() );
+	void processInEvent( const MidiEvent& event, const MidiTime& time = MidiTime(), f_cnt_t offset = 0 );
 	void processOutEvent( const MidiEvent& event, const MidiTime& time = MidiTime() );
 
+	// used by the input threads of MIDI clients instead of processInEvent()
+	// - timestamp is the time the event arrived at (see
+	// MidiClient::timestamp()), the event is applied by the rendering thread
+	// at the beginning of the next period
+	void queueInEvent( const MidiEvent& event, const MidiTime& time, qint64 timestamp );
+
+	// called from the rendering thread - applies all queued events with
+	// offsets matching their distance in time, which delays them by
+	// exactly one period instead of up to one period
+	void processQueuedInEvents( qint64 now, fpp_t frames, sample_rate_t sampleRate );
+
 
 	virtual void saveSettings( QDomDocument& doc, QDomElement& thisElement );
 	virtual void loadSettings( const QDomElement& thisElement );
@@ -161,6 +173,14 @@ private:
 	Map m_readablePorts;
 	Map m_writablePorts;
 
+	struct QueuedInEvent
+	{
+		MidiEvent event;
+		MidiTime time;
+		qint64 timestamp;
+	} ;
+	LocklessRingBuffer<QueuedInEvent> m_inEventQueue;
+
 
 	friend class ControllerConnectionDialog;
 	friend class InstrumentMidiIOView;
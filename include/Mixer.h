@@ -27,6 +27,7 @@
 
 #include <QtCore/QMutex>
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
 #include <QtCore/QVector>
 #include <QtCore/QWaitCondition>
 #include <samplerate.h>
@@ -46,6 +47,10 @@ class AudioPort;
 
 const fpp_t MINIMUM_BUFFER_SIZE = 32;
 const fpp_t DEFAULT_BUFFER_SIZE = 256;
+// several instruments and effects keep per-frame scratch buffers on the
+// stack (Monstro needs about 60 bytes per frame), so larger periods could
+// overflow the 512 KB stacks secondary threads get on some platforms
+const fpp_t MAXIMUM_RENDER_BUFFER_SIZE = 4096;
 
 const int BYTES_PER_SAMPLE = sizeof( sample_t );
 const int BYTES_PER_INT_SAMPLE = sizeof( int_sample_t );
@@ -194,6 +199,11 @@ public:
 
 	void removeAudioPort( AudioPort * _port );
 
+	inline const QVector<AudioPort *> & audioPorts() const
+	{
+		return m_audioPorts;
+	}
+
 
 	// MIDI-client-stuff
 	inline const QString & midiClientName() const
@@ -319,6 +329,10 @@ signals:
 	void nextAudioBuffer( const surroundSampleFrame * buffer );
 
 
+private slots:
+	void sendModelNotifications();
+
+
 private:
 	typedef fifoBuffer<surroundSampleFrame *> fifo;
 
@@ -342,7 +356,7 @@ private:
 	} ;
 
 
-	Mixer( bool renderOnly );
+	Mixer( bool renderOnly, fpp_t renderFramesPerPeriod );
 	virtual ~Mixer();
 
 	void startProcessing( bool _needs_fifo = true );
@@ -425,6 +439,9 @@ private:
 
 	bool m_waitingForWrite;
 
+	// announces model changes made by the rendering threads in the GUI thread
+	QTimer m_modelNotificationTimer;
+
 	friend class LmmsCore;
 	friend class MixerWorkerThread;
 	friend class ProjectRenderer;
@@ -26,12 +26,54 @@
 #define MIXER_PROFILER_H
 
 #include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QVector>
 
 #include "MicroTimer.h"
 
 class MixerProfiler
 {
 public:
+	// what a probe measures - determines how its source pointer is
+	// interpreted when the probe records its event
+	enum ProbeTypes
+	{
+		PlayHandleProbe,	// source: AudioPort the play handle renders to
+		AudioPortProbe,		// source: AudioPort
+		FxChannelProbe,		// source: FxChannel
+		EffectProbe,		// source: Effect
+		RemotePluginProbe,	// source: RemotePlugin
+		NumProbeTypes
+	} ;
+
+	// measures the time spent in its scope and records it into a buffer
+	// owned by the current thread - costs no more than a flag check as
+	// long as detailed profiling is disabled
+	class Probe
+	{
+	public:
+		inline Probe( ProbeTypes type, const void * source ) :
+			m_source( s_detailedProfiling ? source : NULL ),
+			m_type( type ),
+			m_start( m_source ? now() : 0 )
+		{
+		}
+
+		inline ~Probe()
+		{
+			if( m_source )
+			{
+				record( m_type, m_source, m_start, now() );
+			}
+		}
+
+	private:
+		const void * m_source;
+		ProbeTypes m_type;
+		qint64 m_start;
+	} ;
+
 	MixerProfiler();
 	~MixerProfiler();
 
@@ -49,12 +91,62 @@ public:
 
 	void setOutputFile( const QString& outputFile );
 
+	// write all probe events to outputFile in Chrome trace event format,
+	// which can be loaded into chrome://tracing or Perfetto
+	void setTraceFile( const QString& outputFile );
+
+	// measure the CPU load caused by each FX channel including the tracks
+	// sending to it (see FxChannel::m_cpuLoad)
+	void setChannelLoadEnabled( bool enabled )
+	{
+		m_channelLoadEnabled = enabled;
+	}
+
+	// microseconds since the epoch
+	static inline qint64 now()
+	{
+		struct timeval t;
+		gettimeofday( &t, NULL );
+		return (qint64) t.tv_sec * 1000 * 1000 + t.tv_usec;
+	}
+
 
 private:
+	// everything needed from the source is copied when the event is
+	// recorded, as the source may be gone by the end of the period
+	struct ProbeEvent
+	{
+		ProbeTypes type;
+		int channel;	// FX channel the time is accounted to or -1
+		QString name;	// only set while tracing
+		qint64 start;
+		qint64 end;
+	} ;
+
+	struct ThreadBuffer;
+
+	static void record( ProbeTypes type, const void * source,
+						qint64 start, qint64 end );
+	void closeTraceFile();
+	void collectEvents( qint64 periodStart, qint64 periodEnd,
+						float periodLength );
+	void writeTraceEvent( const QString& name, const char * category,
+				int thread, qint64 start, qint64 end );
+
+	static volatile bool s_detailedProfiling;
+	static volatile bool s_tracing;
+	static QVector<ThreadBuffer *> s_threadBuffers;
+	static QMutex s_threadBuffersMutex;
+
 	MicroTimer m_periodTimer;
 	int m_cpuLoad;
 	QFile m_outputFile;
 
+	QFile m_traceFile;
+	bool m_traceEventsWritten;
+	volatile bool m_channelLoadEnabled;
+	QVector<qint64> m_channelTimes;
+
 };
 
 #endif
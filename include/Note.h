@@ -128,6 +128,12 @@ public:
 		return ( (int)( *lhs ).key() > (int)( *rhs ).key() );
 	}
 
+	// for searching notes sorted with lessThan by position
+	static inline bool startsBefore( const Note * note, const MidiTime & pos )
+	{
+		return (int)( *note ).pos() < (int)pos;
+	}
+
 	inline bool selected() const
 	{
 		return m_selected;
@@ -207,6 +213,7 @@ public:
 
 	static MidiTime quantized( const MidiTime & m, const int qGrid );
 
+	// NULL unless createDetuning() was called
 	DetuningHelper * detuning() const
 	{
 		return m_detuning;
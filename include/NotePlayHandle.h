@@ -29,6 +29,7 @@
 #include "AtomicInt.h"
 #include "Note.h"
 #include "PlayHandle.h"
+#include "RandomGenerator.h"
 #include "Track.h"
 #include "MemoryManager.h"
 
@@ -249,6 +250,7 @@ public:
 	void setSongGlobalParentOffset( const MidiTime& offset )
 	{
 		m_songGlobalParentOffset = offset;
+		seedRandomGenerator();
 	}
 
 	/*! Returns song-global offset */
@@ -286,6 +288,7 @@ private:
 	} ;
 
 	void updateFrequency();
+	void seedRandomGenerator();
 
 	InstrumentTrack* m_instrumentTrack;		// needed for calling
 											// InstrumentTrack::playNote
@@ -324,6 +327,9 @@ private:
 	Origin m_origin;
 
 	bool m_frequencyNeedsUpdate;				// used to update pitch
+
+	uint32_t m_randomSeed;
+	RandomGenerator m_randomGenerator;		// current() while playing
 } ;
 
 
@@ -85,6 +85,18 @@ public:
 		m_userWave = _wave;
 	}
 
+	//! starts over at the phase offset like a new oscillator, including
+	//! the sub-oscillators, so voices can be reused for other notes
+	inline void reset()
+	{
+		m_phaseOffset = m_ext_phaseOffset;
+		m_phase = m_phaseOffset;
+		if( m_subOsc != NULL )
+		{
+			m_subOsc->reset();
+		}
+	}
+
 	void update( sampleFrame * _ab, const fpp_t _frames,
 							const ch_cnt_t _chnl );
 
@@ -0,0 +1,261 @@
+/*
+ * Oversampler.h - polyphase up- and downsampling for running single
+ *                 processors at a multiple of the engine's sample rate
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef OVERSAMPLER_H
+#define OVERSAMPLER_H
+
+#include <cmath>
+#include <cstring>
+
+#include "CompensationDelay.h"
+#include "lmms_basics.h"
+#include "lmms_constants.h"
+#include "MemoryManager.h"
+
+
+/** \brief One 2x stage of the Oversampler.
+ *
+ * 	Uses a windowed-sinc halfband FIR split into its two polyphase
+ * 	branches. Every other tap of a halfband filter is zero and one branch
+ * 	is a plain delay, so each output sample costs only Taps multiplies.
+ */
+class HalfbandStage
+{
+	MM_OPERATORS
+public:
+	//! taps of the non-trivial polyphase branch
+	static const int Taps = 16;
+	//! group delay of the filter in samples at the higher rate
+	static const int Delay = Taps - 1;
+
+	HalfbandStage()
+	{
+		// halfband filter h[j] = 0.5 * sinc( ( j - c ) / 2 ) with
+		// Blackman window - only the taps at even j are non-zero apart
+		// from h[c] = 0.5, which becomes the delay branch
+		const int length = 2 * Taps - 1;
+		const int center = Delay;
+		float sum = 0.0f;
+		for( int k = 0; k < Taps; ++k )
+		{
+			const int j = 2 * k;
+			const double x = 0.5 * ( j - center );
+			const double w = 0.42 - 0.5 * cos( 2 * D_PI * j / ( length - 1 ) )
+					+ 0.08 * cos( 4 * D_PI * j / ( length - 1 ) );
+			m_coeffs[k] = 0.5 * sin( D_PI * x ) / ( D_PI * x ) * w;
+			sum += m_coeffs[k];
+		}
+		// the non-trivial branch has to contribute exactly half of the
+		// DC gain
+		for( int k = 0; k < Taps; ++k )
+		{
+			m_coeffs[k] *= 0.5f / sum;
+		}
+		reset();
+	}
+
+	void reset()
+	{
+		memset( m_upHistory, 0, sizeof( m_upHistory ) );
+		memset( m_evenHistory, 0, sizeof( m_evenHistory ) );
+		memset( m_oddHistory, 0, sizeof( m_oddHistory ) );
+		m_upPos = 0;
+		m_downPos = 0;
+	}
+
+	//! writes 2 * frames frames to dst
+	void up( const sampleFrame * src, sampleFrame * dst, const fpp_t frames )
+	{
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			m_upPos = ( m_upPos == 0 ? Taps : m_upPos ) - 1;
+			for( int ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+			{
+				// history is stored twice so the taps can be read
+				// without wrapping around
+				m_upHistory[m_upPos][ch] = src[f][ch];
+				m_upHistory[m_upPos + Taps][ch] = src[f][ch];
+
+				float even = 0.0f;
+				for( int k = 0; k < Taps; ++k )
+				{
+					even += m_coeffs[k] * m_upHistory[m_upPos + k][ch];
+				}
+				// gain of 2 makes up for the inserted zeros
+				dst[2 * f][ch] = 2.0f * even;
+				dst[2 * f + 1][ch] = m_upHistory[m_upPos + Taps / 2 - 1][ch];
+			}
+		}
+	}
+
+	//! reads 2 * frames frames from src, src and dst may be the same
+	void down( const sampleFrame * src, sampleFrame * dst, const fpp_t frames )
+	{
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			m_downPos = ( m_downPos == 0 ? Taps : m_downPos ) - 1;
+			for( int ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+			{
+				const sample_t even = src[2 * f][ch];
+				const sample_t odd = src[2 * f + 1][ch];
+				m_evenHistory[m_downPos][ch] = even;
+				m_evenHistory[m_downPos + Taps][ch] = even;
+				m_oddHistory[m_downPos][ch] = odd;
+				m_oddHistory[m_downPos + Taps][ch] = odd;
+
+				float sum = 0.0f;
+				for( int k = 0; k < Taps; ++k )
+				{
+					sum += m_coeffs[k] * m_evenHistory[m_downPos + k][ch];
+				}
+				dst[f][ch] = sum + 0.5f *
+					m_oddHistory[m_downPos + Taps / 2][ch];
+			}
+		}
+	}
+
+
+private:
+	float m_coeffs[Taps];
+
+	sampleFrame m_upHistory[2 * Taps];
+	sampleFrame m_evenHistory[2 * Taps];
+	sampleFrame m_oddHistory[2 * Taps];
+	int m_upPos;
+	int m_downPos;
+
+} ;
+
+
+
+
+/** \brief Runs a processor at 2, 4 or 8 times the sample rate.
+ *
+ * 	up() returns an internal buffer holding the upsampled input which is
+ * 	processed in place and then handed back via down().
+ */
+class Oversampler
+{
+	MM_OPERATORS
+public:
+	//! factor has to be 2, 4 or 8, maxFrames is the largest number of
+	//! (not oversampled) frames passed to up() and down()
+	Oversampler( int factor, fpp_t maxFrames ) :
+		m_stageCount( 0 ),
+		m_maxFrames( maxFrames )
+	{
+		while( ( 1 << m_stageCount ) < factor && m_stageCount < MaxStages )
+		{
+			++m_stageCount;
+		}
+		for( int s = 0; s < m_stageCount; ++s )
+		{
+			m_buffers[s] = new sampleFrame[maxFrames << ( s + 1 )];
+		}
+
+		// the stages delay by a fractional number of frames at the
+		// original rate, so delay a bit more at the highest rate to make
+		// latency() exact
+		const int f = 1 << m_stageCount;
+		m_alignment.setDelay( ( f - stageDelay() % f ) % f );
+	}
+
+	~Oversampler()
+	{
+		for( int s = 0; s < m_stageCount; ++s )
+		{
+			delete[] m_buffers[s];
+		}
+	}
+
+	int factor() const
+	{
+		return 1 << m_stageCount;
+	}
+
+	fpp_t maxFrames() const
+	{
+		return m_maxFrames;
+	}
+
+	//! delay of a round trip through up() and down() in frames at the
+	//! original rate
+	f_cnt_t latency() const
+	{
+		return ( stageDelay() + m_alignment.delay() ) / factor();
+	}
+
+	void reset()
+	{
+		for( int s = 0; s < m_stageCount; ++s )
+		{
+			m_stages[s].reset();
+		}
+		m_alignment.clear();
+	}
+
+	//! returns a buffer holding frames * factor() frames
+	sampleFrame * up( const sampleFrame * src, const fpp_t frames )
+	{
+		for( int s = 0; s < m_stageCount; ++s )
+		{
+			m_stages[s].up( src, m_buffers[s], frames << s );
+			src = m_buffers[s];
+		}
+
+		sampleFrame * buf = m_buffers[m_stageCount - 1];
+		m_alignment.process( buf, buf, frames << m_stageCount, true );
+		return buf;
+	}
+
+	//! writes frames frames to dst, taken from the buffer returned by up()
+	void down( sampleFrame * dst, const fpp_t frames )
+	{
+		for( int s = m_stageCount - 1; s > 0; --s )
+		{
+			m_stages[s].down( m_buffers[s], m_buffers[s - 1], frames << s );
+		}
+		m_stages[0].down( m_buffers[0], dst, frames );
+	}
+
+
+private:
+	static const int MaxStages = 3;
+
+	//! delay of all stages in frames at the highest rate - each stage
+	//! filters in both directions at 2^(s+1) times the original rate
+	int stageDelay() const
+	{
+		return 2 * HalfbandStage::Delay * ( factor() - 1 );
+	}
+
+	HalfbandStage m_stages[MaxStages];
+	sampleFrame * m_buffers[MaxStages];
+	int m_stageCount;
+	fpp_t m_maxFrames;
+	CompensationDelay m_alignment;
+
+} ;
+
+
+#endif
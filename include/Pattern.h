@@ -67,6 +67,10 @@ public:
 
 	// note management
 	Note * addNote( const Note & _new_note, const bool _quant_pos = true );
+	// adds many notes at once, sorting them, taking the lock, updating the
+	// length and emitting dataChanged() only once
+	void addNotes( const QVector<Note> & _new_notes,
+						const bool _quant_pos = true );
 
 	void removeNote( Note * _note_to_del );
 
@@ -80,6 +84,9 @@ public:
 		return m_notes;
 	}
 
+	// first note starting at or after _pos, found by binary search
+	NoteVector::ConstIterator firstNoteFrom( const MidiTime & _pos ) const;
+
 	Note * addStepNote( int step );
 	void setStep( int step, bool enabled );
 
@@ -52,6 +52,13 @@ public:
 	static void cleanup();
 	static ConstNotePlayHandleList nphsOfInstrumentTrack( const InstrumentTrack* instrumentTrack );
 
+	//! loads a preset into an idle preview track, so previewing it later
+	//! starts at once
+	static void prefetch( const QString& presetFile, bool loadByPlugin = false, DataFile *dataFile = 0 );
+
+	//! whether instrumentTrack keeps a preset loaded but isn't previewed now
+	static bool isIdle( const InstrumentTrack* instrumentTrack );
+
 	static bool isPreviewing();
 
 
@@ -106,6 +106,11 @@ private:
 	} ;
 	typedef QStack<CheckPoint> CheckPointStack;
 
+	// drop what the checkpoints' data keeps alive, call before
+	// discarding them
+	static void releaseCheckPoint( CheckPoint & c );
+	static void releaseCheckPoints( CheckPointStack & stack );
+
 	JoIdMap m_joIDs;
 
 	CheckPointStack m_undoCheckPoints;
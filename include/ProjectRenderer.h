@@ -25,6 +25,10 @@
 #ifndef PROJECT_RENDERER_H
 #define PROJECT_RENDERER_H
 
+#include <QtCore/QSemaphore>
+#include <QtCore/QVector>
+
+#include "AtomicInt.h"
 #include "AudioFileDevice.h"
 #include "lmmsconfig.h"
 #include "Mixer.h"
@@ -65,6 +69,11 @@ public:
 		return m_fileDev != NULL;
 	}
 
+	//! encode the same rendering into another file - call before
+	//! startProcessing()
+	bool addOutput( ExportFileFormats fileFormat,
+					const QString & outputFilename );
+
 	static ExportFileFormats getFileFormatFromExtension(
 							const QString & _ext );
 
@@ -84,11 +93,39 @@ signals:
 
 
 private:
+	class EncoderThread;
+
+	// number of rendered periods which can wait for being encoded
+	static const int PipelineDepth = 16;
+
+	struct Period
+	{
+		surroundSampleFrame * buffer;
+		fpp_t frames;
+		float masterGain;
+		// encoders which still have to write this period
+		AtomicInt pendingEncoders;
+	} ;
+
 	virtual void run();
 
+	static AudioFileDevice * createFileDevice( ExportFileFormats fileFormat,
+					const OutputSettings & outputSettings,
+					const QString & outputFilename );
+
+	void renderPeriod();
+	void encodePeriod( AudioFileDevice * fileDev, int period );
+
 	AudioFileDevice * m_fileDev;
+	QVector<AudioFileDevice *> m_additionalFileDevs;
+	OutputSettings m_outputSettings;
 	Mixer::qualitySettings m_qualitySettings;
 
+	QVector<EncoderThread *> m_encoders;
+	Period m_periods[PipelineDepth];
+	int m_nextPeriod;
+	QSemaphore m_freePeriods;
+
 	volatile int m_progress;
 	volatile bool m_abort;
 
@@ -0,0 +1,161 @@
+/*
+ * RandomGenerator.h - fast counter based random numbers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef RANDOM_GENERATOR_H
+#define RANDOM_GENERATOR_H
+
+#include <stdint.h>
+
+#include "AtomicInt.h"
+#include "export.h"
+
+
+/** \brief Generates random numbers, e.g. for noise.
+ *
+ * 	Every number is a hash of the key, derived from the seed, and its
+ * 	position in the sequence. The state is a single counter and a block of
+ * 	numbers can be generated independently of each other, which lets the
+ * 	compiler vectorize fillNoise().
+ *
+ * 	A generator must not be used by several threads at once. Voices
+ * 	have their own generator, seeded from their identity, which Scope
+ * 	makes the current() one while they render, so they produce the same
+ * 	noise on every run. Everything else falls back to forThread(), the
+ * 	generator of the calling thread.
+ */
+class EXPORT RandomGenerator
+{
+public:
+	static const uint32_t DefaultSeed = 0x4c4d4d53;
+
+	RandomGenerator( uint32_t _seed = DefaultSeed ) :
+		m_key( hash( _seed ) ),
+		m_counter( 0 )
+	{
+	}
+
+	//! restarts the sequence, the same seed always gives the same numbers
+	void seed( uint32_t _seed )
+	{
+		m_key = hash( _seed );
+		m_counter = 0;
+	}
+
+	inline uint32_t next()
+	{
+		return hash( m_key + m_counter++ );
+	}
+
+	//! returns a number in [-1, 1)
+	inline float nextFloat()
+	{
+		return toFloat( next() );
+	}
+
+	//! writes _samples numbers in [-1, 1) to _dst, the same ones
+	//! nextFloat() would return
+	void fillNoise( float * _dst, int _samples )
+	{
+		const uint32_t base = m_key + m_counter;
+		for( int i = 0; i < _samples; ++i )
+		{
+			_dst[i] = toFloat( hash( base + i ) );
+		}
+		m_counter += _samples;
+	}
+
+	//! derives a seed from _seed and _value, e.g. to seed a generator
+	//! from several properties of what it generates numbers for
+	static inline uint32_t combine( uint32_t _seed, uint32_t _value )
+	{
+		return hash( _seed ^ hash( _value + 0x9e3779b9u ) );
+	}
+
+	//! the generator of the calling thread, the threads are seeded with
+	//! consecutive seeds starting at DefaultSeed in the order they use
+	//! their generator first - so don't use it for anything that should
+	//! sound the same on every run
+	static inline RandomGenerator & forThread()
+	{
+		static thread_local RandomGenerator generator( nextThreadSeed() );
+		return generator;
+	}
+
+	//! the generator set by the innermost Scope on the calling thread,
+	//! or forThread() if there is none
+	static RandomGenerator & current();
+
+	//! makes a generator the current() one of the calling thread for its
+	//! lifetime
+	class Scope
+	{
+	public:
+		Scope( RandomGenerator & _generator ) :
+			m_previous( setCurrent( &_generator ) )
+		{
+		}
+
+		~Scope()
+		{
+			setCurrent( m_previous );
+		}
+
+	private:
+		RandomGenerator * m_previous;
+
+	} ;
+
+
+private:
+	// integer hash with good avalanche properties, see
+	// https://nullprogram.com/blog/2018/07/31/
+	static inline uint32_t hash( uint32_t _x )
+	{
+		_x ^= _x >> 16;
+		_x *= 0x7feb352du;
+		_x ^= _x >> 15;
+		_x *= 0x846ca68bu;
+		_x ^= _x >> 16;
+		return _x;
+	}
+
+	static inline float toFloat( uint32_t _x )
+	{
+		return static_cast<int32_t>( _x ) * ( 1.0f / 2147483648.0f );
+	}
+
+	// returns the previous generator
+	static RandomGenerator * setCurrent( RandomGenerator * _generator );
+
+	static uint32_t nextThreadSeed()
+	{
+		static AtomicInt threads;
+		return DefaultSeed + threads.fetchAndAddOrdered( 1 );
+	}
+
+	uint32_t m_key;
+	uint32_t m_counter;
+
+} ;
+
+
+#endif
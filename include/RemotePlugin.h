@@ -808,6 +808,28 @@ public:
 
 	bool process( const sampleFrame * _in_buf, sampleFrame * _out_buf );
 
+	/*! In pipelined mode process() hands the current period over to the
+	    remote process and returns the output of the previous one instead of
+	    waiting for it, so the plugin can run in parallel to the engine at
+	    the cost of one period of latency */
+	void setPipelined( bool _on )
+	{
+		m_pipelined = _on;
+	}
+
+	inline bool isPipelined() const
+	{
+		return m_pipelined;
+	}
+
+	//! number of frames the output lags behind the input
+	f_cnt_t latency() const;
+
+	/*! Drops the output of the period handed over last in pipelined mode,
+	    so it isn't returned by the next process() - to be called when
+	    processing resumes after periods which weren't processed */
+	void discardPendingOutput();
+
 	void processMidiEvent( const MidiEvent&, const f_cnt_t _offset );
 
 	void updateSampleRate( sample_rate_t _sr )
@@ -864,6 +886,11 @@ protected:
 private:
 	void resizeSharedProcessingMemory();
 
+	bool processPipelined( const sampleFrame * _in_buf,
+					sampleFrame * _out_buf, const fpp_t frames );
+	void writeInput( const sampleFrame * _in_buf, const fpp_t frames );
+	void readOutput( sampleFrame * _out_buf, const fpp_t frames );
+
 
 	bool m_failed;
 
@@ -886,6 +913,10 @@ private:
 	int m_inputCount;
 	int m_outputCount;
 
+	volatile bool m_pipelined;
+	bool m_processingInFlight;
+	bool m_outputPending;
+
 #ifndef SYNC_WITH_SHM_FIFO
 	int m_server;
 	QString m_socketFile;
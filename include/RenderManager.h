@@ -44,6 +44,9 @@ public:
 
 	virtual ~RenderManager();
 
+	/// Additionally encode into the given format, next to the main output
+	void addFormat( ProjectRenderer::ExportFileFormats fmt );
+
 	/// Export all unmuted tracks into a single file
 	void renderProject();
 
@@ -62,12 +65,14 @@ private slots:
 
 private:
 	QString pathForTrack( const Track *track, int num );
+	void addAdditionalOutputs( const QString & path );
 	void restoreMutedState();
 
 	const Mixer::qualitySettings m_qualitySettings;
 	const Mixer::qualitySettings m_oldQualitySettings;
 	const OutputSettings m_outputSettings;
 	ProjectRenderer::ExportFileFormats m_format;
+	QVector<ProjectRenderer::ExportFileFormats> m_additionalFormats;
 	QString m_outputPath;
 
 	ProjectRenderer* m_activeRenderer;
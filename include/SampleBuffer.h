@@ -28,6 +28,7 @@
 
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QObject>
+#include <QtXml/QDomElement>
 
 #include <samplerate.h>
 
@@ -41,6 +42,8 @@
 
 class QPainter;
 class QRect;
+class SampleDecoder;
+class SharedSampleData;
 
 // values for buffer margins, used for various libsamplerate interpolation modes
 // the array positions correspond to the converter_type parameter values in libsamplerate
@@ -206,28 +209,49 @@ public:
 		m_sampleRate = _rate;
 	}
 
+	// NULL for compact buffers, use readFrames() for those
 	inline const sampleFrame * data() const
 	{
 		return m_data;
 	}
 
+	// copies _frames frames starting at _from to _dst, works for compact
+	// buffers as well
+	void readFrames( f_cnt_t _from, f_cnt_t _frames,
+						sampleFrame * _dst ) const;
+
+	inline bool isCompact() const
+	{
+		return m_compact;
+	}
+
+	// keep the data in a CompactSampleData instead of plain frames to save
+	// memory - data() and userWaveSample() are not available then
+	void setCompact( bool _on );
+
 	QString openAudioFile() const;
 	QString openAndSetAudioFile();
 	QString openAndSetWaveformFile();
 
 	QString & toBase64( QString & _dst ) const;
 
+	// stores the data in _this - as base64 text in _attribute or, for the
+	// clipboard and the undo journal, as a reference to the shared data,
+	// which saves encoding it on every copy and checkpoint
+	void saveData( QDomDocument & _doc, QDomElement & _this,
+					const QString & _attribute ) const;
+	// loads what saveData() stored, returns false if _this has neither
+	bool loadData( const QDomElement & _this, const QString & _attribute );
+
 
 	// protect calls from the GUI to this function with dataReadLock() and
 	// dataUnlock()
 	SampleBuffer * resample( const sample_rate_t _src_sr,
 						const sample_rate_t _dst_sr );
 
-	void normalizeSampleRate( const sample_rate_t _src_sr,
-						bool _keep_settings = false );
-
 	// protect calls from the GUI to this function with dataReadLock() and
-	// dataUnlock(), out of loops for efficiency
+	// dataUnlock(), out of loops for efficiency, not available for compact
+	// buffers
 	inline sample_t userWaveSample( const float _sample ) const
 	{
 		f_cnt_t frames = m_frames;
@@ -257,6 +281,9 @@ public:
 
 public slots:
 	void setAudioFile( const QString & _audio_file );
+	// decodes the file on the global thread pool and replaces the data
+	// once done, emitting loadingProgress() meanwhile
+	void loadAudioFileAsync( const QString & _audio_file );
 	void loadFromBase64( const QString & _data );
 	void setStartFrame( const f_cnt_t _s );
 	void setEndFrame( const f_cnt_t _e );
@@ -264,27 +291,27 @@ public slots:
 	void setReversed( bool _on );
 	void sampleRateChanged();
 
+private slots:
+	void asyncLoadFinished();
+
 private:
 	void update( bool _keep_settings = false );
-
-	void convertIntToFloat ( int_sample_t * & _ibuf, f_cnt_t _frames, int _channels);
-	void directFloatWrite ( sample_t * & _fbuf, f_cnt_t _frames, int _channels);
-
-	f_cnt_t decodeSampleSF( QString _f, sample_t * & _buf,
-						ch_cnt_t & _channels,
-						sample_rate_t & _sample_rate );
-#ifdef LMMS_HAVE_OGGVORBIS
-	f_cnt_t decodeSampleOGGVorbis( QString _f, int_sample_t * & _buf,
-						ch_cnt_t & _channels,
-						sample_rate_t & _sample_rate );
-#endif
-	f_cnt_t decodeSampleDS( QString _f, int_sample_t * & _buf,
-						ch_cnt_t & _channels,
-						sample_rate_t & _sample_rate );
+	void cancelPendingLoad();
+	// key under which the data decoded from _file is shared
+	QString fileKey( const QString & _file, bool _reversed ) const;
+	SharedSampleData * takeDecodedData( SampleDecoder & _decoder,
+						const QString & _key );
+	SharedSampleData * decodeBase64( const QString & _data ) const;
+	// takes over the reference to _data as data not coming from a file
+	void setOrigData( SharedSampleData * _data );
+	// takes over the reference to _data and publishes it to the mixer
+	void setData( SharedSampleData * _data, bool _keep_settings );
+	void showLoadError();
 
 	QString m_audioFile;
-	sampleFrame * m_origData;
-	f_cnt_t m_origFrames;
+	// data not coming from a file, kept for update()
+	SharedSampleData * m_origData;
+	// data of m_sharedData for quick access while playing, NULL if compact
 	sampleFrame * m_data;
 	QReadWriteLock m_varLock;
 	f_cnt_t m_frames;
@@ -296,18 +323,24 @@ private:
 	bool m_reversed;
 	float m_frequency;
 	sample_rate_t m_sampleRate;
+	SampleDecoder * m_decoder;
+	bool m_compact;
+	SharedSampleData * m_sharedData;
 
 	sampleFrame * getSampleFragment( f_cnt_t _index, f_cnt_t _frames,
 						LoopMode _loopmode,
 						sampleFrame * * _tmp,
 						bool * _backwards, f_cnt_t _loopstart, f_cnt_t _loopend,
 						f_cnt_t _end ) const;
+	void readFramesBackwards( f_cnt_t _from, f_cnt_t _frames,
+						sampleFrame * _dst ) const;
 	f_cnt_t getLoopedIndex( f_cnt_t _index, f_cnt_t _startf, f_cnt_t _endf  ) const;
 	f_cnt_t getPingPongIndex( f_cnt_t _index, f_cnt_t _startf, f_cnt_t _endf  ) const;
 
 
 signals:
 	void sampleUpdated();
+	void loadingProgress( int _percent );
 
 } ;
 
@@ -0,0 +1,147 @@
+/*
+ * SampleDecoder.h - decodes audio files into sample data at a given rate
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SAMPLE_DECODER_H
+#define SAMPLE_DECODER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QRunnable>
+#include <QtCore/QString>
+
+#include <samplerate.h>
+
+#include "lmmsconfig.h"
+#include "AtomicInt.h"
+#include "export.h"
+#include "lmms_basics.h"
+#include "MemoryManager.h"
+
+
+/** \brief Decodes an audio file into stereo frames in a single pass.
+ *
+ * 	The file is read in blocks which are converted to floats, spread to
+ * 	two channels and - if the file's rate differs from the target rate -
+ * 	streamed through the resampler right away, so no intermediate copy of
+ * 	the whole file is made.
+ *
+ * 	decode() can be called from any thread. As a QRunnable the decoder can
+ * 	also be started on a thread pool - it then reports its progress and
+ * 	emits finished() when done. Such decoders have to be deleted by whoever
+ * 	receives finished() or via deleteLater() connected to it.
+ */
+class EXPORT SampleDecoder : public QObject, public QRunnable
+{
+	Q_OBJECT
+	MM_OPERATORS
+public:
+	enum Results
+	{
+		Decoded,
+		Failed,
+		TooLarge,	// file exceeds FileSizeMax or SampleLengthMax
+		Cancelled
+	} ;
+	typedef Results Result;
+
+	// limits for audio files in MB and minutes
+	static const int FileSizeMax = 300;
+	static const int SampleLengthMax = 90;
+
+	SampleDecoder( const QString & _file, sample_rate_t _sample_rate,
+							bool _reversed = false );
+	virtual ~SampleDecoder();
+
+	Result decode();
+
+	// can be called from any thread while decode() is running
+	void cancel();
+
+	// 0 to 100
+	int progress() const;
+
+	Result result() const
+	{
+		return m_result;
+	}
+
+	inline f_cnt_t frames() const
+	{
+		return m_frames;
+	}
+
+	// hands over the decoded data, which has to be freed with MM_FREE()
+	sampleFrame * takeData();
+
+	virtual void run();
+
+	// converts _frames frames of interleaved samples with _channels
+	// channels to stereo frames, mono is copied to both channels and any
+	// channels beyond the second are dropped
+	static void toStereo( const float * _src, sampleFrame * _dst,
+					f_cnt_t _frames, int _channels );
+	static void toStereo( const int_sample_t * _src, sampleFrame * _dst,
+					f_cnt_t _frames, int _channels );
+
+
+signals:
+	void progressChanged( int _percent );
+	void finished();
+
+
+private:
+	Result decodeSndfile();
+#ifdef LMMS_HAVE_OGGVORBIS
+	Result decodeOggVorbis();
+#endif
+	Result decodeDrumSynth();
+
+	// prepare for receiving _frames frames at _sample_rate
+	bool begin( f_cnt_t _frames, sample_rate_t _sample_rate );
+	// append a block of stereo frames, returns false if cancelled
+	bool write( const sampleFrame * _block, f_cnt_t _frames );
+	void resample( const sampleFrame * _block, f_cnt_t _frames,
+							bool _end_of_input );
+	// flush the resampler and finish the output
+	void end();
+
+	bool isCancelled() const;
+
+	QString m_file;
+	sample_rate_t m_sampleRate;
+	bool m_reversed;
+
+	AtomicInt m_cancelled;
+	AtomicInt m_progress;
+
+	sampleFrame * m_data;
+	f_cnt_t m_frames;
+	f_cnt_t m_capacity;
+	f_cnt_t m_inputFrames;
+	f_cnt_t m_inputDone;
+	SRC_STATE * m_resampler;
+	double m_ratio;
+	Result m_result;
+
+} ;
+
+
+#endif
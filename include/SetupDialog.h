@@ -121,6 +121,8 @@ private slots:
 	void toggleOneInstrumentTrackWindow( bool _enabled );
 	void toggleCompactTrackButtons( bool _enabled );
 	void toggleSyncVSTPlugins( bool _enabled );
+	void togglePipelinedRemotePlugins( bool _enabled );
+	void toggleCompactSamples( bool _enabled );
 	void toggleAnimateAFP( bool _enabled );
 	void toggleNoteLabels( bool en );
 	void toggleDisplayWaveform( bool en );
@@ -191,6 +193,8 @@ private:
 	bool m_oneInstrumentTrackWindow;
 	bool m_compactTrackButtons;
 	bool m_syncVSTPlugins;
+	bool m_pipelinedRemotePlugins;
+	bool m_compactSamples;
 	bool m_animateAFP;
 	bool m_printNoteLabels;
 	bool m_displayWaveform;
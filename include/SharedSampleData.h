@@ -0,0 +1,135 @@
+/*
+ * SharedSampleData.h - immutable sample data shared between SampleBuffers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SHARED_SAMPLE_DATA_H
+#define SHARED_SAMPLE_DATA_H
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtXml/QDomElement>
+
+#include "export.h"
+#include "lmms_basics.h"
+#include "MemoryManager.h"
+
+class CompactSampleData;
+
+
+/** \brief Reference counted, read-only sample data.
+ *
+ * 	Data can be published under a key describing where it came from, e.g.
+ * 	a file and the settings it was decoded with or the hash of the data a
+ * 	project stored. SampleBuffers loading the same thing again then share
+ * 	the data instead of decoding another copy. The data is never changed
+ * 	once created, edits create new data.
+ *
+ * 	Unlike sharedObject, all reference counting happens under the lock of
+ * 	the registry, so data that is just about to be deleted can't be found
+ * 	anymore.
+ */
+class EXPORT SharedSampleData
+{
+	MM_OPERATORS
+public:
+	//! takes ownership of _data, which is turned into CompactSampleData
+	//! right away if _compact is set, the data has a single reference
+	SharedSampleData( sampleFrame * _data, f_cnt_t _frames, bool _compact );
+
+	//! returns the data published under _key with an additional
+	//! reference or NULL
+	static SharedSampleData * find( const QString & _key, bool _compact );
+
+	//! makes this data findable under _key until it is deleted, does
+	//! nothing if other data already is
+	void publish( const QString & _key );
+
+	SharedSampleData * ref();
+	void unref();
+
+	//! returns this data in the requested storage with an additional
+	//! reference, converting it if necessary
+	SharedSampleData * convert( bool _compact );
+
+	//! returns a reversed copy with a single reference
+	SharedSampleData * reversed() const;
+
+	//! Keeps this data alive for a document which never leaves memory
+	//! (clipboard, undo journal) and stores a reference to it in
+	//! RETAINED_ATTRIBUTE of _elem, instead of the data itself. Each
+	//! call has to be matched by releaseRetained() on the document.
+	void retain( QDomElement & _elem );
+
+	//! returns the data retained in _elem with an additional reference
+	//! or NULL
+	static SharedSampleData * findRetained( const QDomElement & _elem );
+
+	//! drops what retain() kept alive for _elem and all its children,
+	//! call when the document is discarded
+	static void releaseRetained( const QDomElement & _elem );
+
+	static const char * const RETAINED_ATTRIBUTE;
+
+	inline f_cnt_t frames() const
+	{
+		return m_frames;
+	}
+
+	//! NULL for compact data
+	inline sampleFrame * data() const
+	{
+		return m_data;
+	}
+
+	inline bool isCompact() const
+	{
+		return m_compactData != NULL;
+	}
+
+	//! see CompactSampleData::read()
+	void read( f_cnt_t _from, f_cnt_t _frames, sampleFrame * _dst ) const;
+
+
+private:
+	~SharedSampleData();
+
+	static QString registryKey( const QString & _key, bool _compact );
+
+	sampleFrame * m_data;
+	CompactSampleData * m_compactData;
+	f_cnt_t m_frames;
+
+	int m_referenceCount;
+	QString m_key;
+	// number of retain() calls not released yet
+	int m_retainCount;
+	QString m_retainedKey;
+
+	static QMutex s_lock;
+	static QHash<QString, SharedSampleData *> s_registry;
+	static QHash<QString, SharedSampleData *> s_retained;
+	static int s_lastRetainedKey;
+
+} ;
+
+
+#endif
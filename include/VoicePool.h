@@ -0,0 +1,96 @@
+/*
+ * VoicePool.h - recycles the per-note data of instruments
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef VOICE_POOL_H
+#define VOICE_POOL_H
+
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+
+/** \brief Keeps the voices of finished notes for the next ones.
+ *
+ * 	Instruments creating an object per note, e.g. an emulated chip, acquire()
+ * 	an idle one in Instrument::playNote() and only create a new one if the
+ * 	pool is empty. Instrument::deleteNotePluginData() hands it back with
+ * 	release() instead of deleting it. The pool grows to the most notes
+ * 	played at once and then notes don't allocate anymore.
+ *
+ * 	Voices are returned as they were released, resetting them is up to the
+ * 	instrument. Notes are played by several threads at once, so the pool is
+ * 	locked for the few instructions of acquire() and release().
+ */
+template<class T>
+class VoicePool
+{
+public:
+	VoicePool( int _reserve = 32 )
+	{
+		m_idle.reserve( _reserve );
+	}
+
+	~VoicePool()
+	{
+		clear();
+	}
+
+	//! returns an idle voice or NULL if there is none
+	T * acquire()
+	{
+		QMutexLocker lock( &m_lock );
+		if( m_idle.isEmpty() )
+		{
+			return NULL;
+		}
+		T * voice = m_idle.last();
+		// the reserved capacity keeps this from reallocating
+		m_idle.resize( m_idle.size() - 1 );
+		return voice;
+	}
+
+	//! takes ownership of _voice, the next acquire() may return it
+	void release( T * _voice )
+	{
+		QMutexLocker lock( &m_lock );
+		m_idle.append( _voice );
+	}
+
+	//! deletes all idle voices, e.g. if they can't be reused anymore
+	void clear()
+	{
+		QMutexLocker lock( &m_lock );
+		for( int i = 0; i < m_idle.size(); ++i )
+		{
+			delete m_idle[i];
+		}
+		m_idle.resize( 0 );
+	}
+
+
+private:
+	QMutex m_lock;
+	QVector<T *> m_idle;
+
+} ;
+
+
+#endif
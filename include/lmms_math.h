@@ -29,6 +29,7 @@
 #include <stdint.h>
 #include "lmms_constants.h"
 #include "lmmsconfig.h"
+#include "RandomGenerator.h"
 #include <QtCore/QtGlobal>
 
 #include <cmath>
@@ -125,9 +126,9 @@ static inline float absFraction( float _x )
 #define FAST_RAND_MAX 32767
 static inline int fast_rand()
 {
-	static unsigned long next = 1;
-	next = next * 1103515245 + 12345;
-	return( (unsigned)( next / 65536 ) % 32768 );
+	// voices have their own generator, everything else uses the one of
+	// the calling thread, so rendering threads don't share any state
+	return RandomGenerator::current().next() >> 17;
 }
 
 static inline double fastRand( double range )
@@ -200,6 +201,213 @@ static inline double sinc( double _x )
 }
 
 
+// Fast approximations of transcendental functions for code running per
+// sample. They don't branch, so loops calling them get vectorized, e.g. the
+// block versions below. The error bounds are the ones of the float results
+// compared to the exact values, see FastMathTest.
+
+// clamps x to [lo, hi] for lo < 0 < hi. The bit patterns of negative floats
+// are ordered like unsigned integers, the ones of positive floats like signed
+// integers, and integer minimums don't keep loops from being vectorized like
+// float comparisons do. NaNs end up at one of the bounds.
+static inline float fastClampf( float x, float lo, float hi )
+{
+	union
+	{
+		float f;
+		uint32_t u;
+		int32_t i;
+	} v, l, h;
+	v.f = x;
+	l.f = lo;
+	h.f = hi;
+	v.u = v.u > l.u ? l.u : v.u;
+	v.i = v.i > h.i ? h.i : v.i;
+	return v.f;
+}
+
+
+//! @brief 2^x with a relative error below 3e-7, x is clamped to [-126, 127]
+static inline float fastExp2f( float x )
+{
+	x = fastClampf( x, -126.0f, 127.0f );
+	// split into integer and fractional part in [-0.5, 0.5], adding
+	// 1.5 * 2^23 rounds x to an integer which ends up in the low bits of
+	// the mantissa
+	union
+	{
+		float f;
+		int32_t i;
+	} r;
+	r.f = x + 12582912.0f;
+	const int32_t i = r.i - 0x4b400000;
+	const float f = x - ( r.f - 12582912.0f );
+	// Taylor polynomial of 2^f
+	const float p = 1.0f + f * ( 6.931471806e-1f + f * ( 2.402265070e-1f +
+		f * ( 5.550410866e-2f + f * ( 9.618129108e-3f +
+		f * ( 1.333355815e-3f + f * 1.540353039e-4f ) ) ) ) );
+	union
+	{
+		int32_t i;
+		float f;
+	} u;
+	u.i = ( i + 127 ) << 23;
+	return p * u.f;
+}
+
+
+//! @brief log2(x) for normal x > 0 with an absolute error below 4e-7 for x
+//! in [0.01, 4] and a relative one below 1e-7 outside of it
+static inline float fastLog2f( float x )
+{
+	union
+	{
+		float f;
+		int32_t i;
+	} u;
+	u.f = x;
+	float e = static_cast<float>( ( ( u.i >> 23 ) & 0xff ) - 127 );
+	// move the mantissa to [sqrt(0.5), sqrt(2)) so the series below
+	// converges fast, 0x3504f3 are the mantissa bits of sqrt(2)
+	const bool big = ( u.i & 0x007fffff ) > 0x3504f3;
+	u.i = ( u.i & 0x007fffff ) | ( big ? 0x3f000000 : 0x3f800000 );
+	e += big ? 1.0f : 0.0f;
+	const float m = u.f;
+	// log2(m) = 2 / ln(2) * atanh(t)
+	const float t = ( m - 1.0f ) / ( m + 1.0f );
+	const float t2 = t * t;
+	return e + t * ( 2.885390082f + t2 * ( 9.617966939e-1f +
+		t2 * ( 5.770780164e-1f + t2 * 4.121985831e-1f ) ) );
+}
+
+
+//! @brief e^x with a relative error below 4e-6 for x in [-87, 88], the
+//! error grows with |x| and is below 5e-7 for |x| < 1
+static inline float fastExpf( float x )
+{
+	return fastExp2f( x * 1.442695041f );
+}
+
+
+//! @brief a^b for a > 0, based on fastExp2f() and fastLog2f()
+static inline float fastPowf( float a, float b )
+{
+	return fastExp2f( b * fastLog2f( a ) );
+}
+
+
+//! @brief tanh(x) with an absolute error below 2e-7
+static inline float fastTanhf( float x )
+{
+	const float e = fastExp2f( fastClampf( x, -9.0f, 9.0f ) * 2.885390082f );
+	return ( e - 1.0f ) / ( e + 1.0f );
+}
+
+
+// sine and cosine of r in [-pi/2, pi/2] by their Taylor polynomials
+static inline float fastSinReduced( float r )
+{
+	const float r2 = r * r;
+	return r * ( 1.0f + r2 * ( -1.666666667e-1f + r2 * ( 8.333333333e-3f +
+		r2 * ( -1.984126984e-4f + r2 * ( 2.755731922e-6f +
+		r2 * -2.505210839e-8f ) ) ) ) );
+}
+
+
+static inline float fastCosReduced( float r )
+{
+	const float r2 = r * r;
+	return 1.0f + r2 * ( -0.5f + r2 * ( 4.166666667e-2f +
+		r2 * ( -1.388888889e-3f + r2 * ( 2.480158730e-5f +
+		r2 * ( -2.755731922e-7f + r2 * 2.087675699e-9f ) ) ) ) );
+}
+
+
+// returns x - k * pi in [-pi/2, pi/2] and k
+static inline float fastReduceToHalfPi( float x, int32_t & k )
+{
+	// rounding by conversion, floorf() keeps loops from being vectorized
+	k = static_cast<int32_t>( x * F_PI_R + 1024.5f ) - 1024;
+	const float kf = static_cast<float>( k );
+	// pi split in two parts, so that the first product is exact
+	return ( x - kf * 3.140625f ) - kf * 9.676535897e-4f;
+}
+
+
+//! @brief sin(x) with an absolute error below 3e-7 for |x| < 3000
+static inline float fastSinf( float x )
+{
+	int32_t k;
+	const float s = fastSinReduced( fastReduceToHalfPi( x, k ) );
+	return ( k & 1 ) ? -s : s;
+}
+
+
+//! @brief cos(x) with an absolute error below 3e-7 for |x| < 3000
+static inline float fastCosf( float x )
+{
+	int32_t k;
+	const float c = fastCosReduced( fastReduceToHalfPi( x, k ) );
+	return ( k & 1 ) ? -c : c;
+}
+
+
+//! @brief tan(x) with a relative error below 1e-6 for |x| < 3000 not
+//! closer than 1e-3 to a pole
+static inline float fastTanf( float x )
+{
+	int32_t k;
+	const float r = fastReduceToHalfPi( x, k );
+	return fastSinReduced( r ) / fastCosReduced( r );
+}
+
+
+//! @brief block versions of the functions above
+static inline void fastExp2f( const float * in, float * out, int n )
+{
+	for( int i = 0; i < n; ++i )
+	{
+		out[i] = fastExp2f( in[i] );
+	}
+}
+
+
+static inline void fastSinf( const float * in, float * out, int n )
+{
+	for( int i = 0; i < n; ++i )
+	{
+		out[i] = fastSinf( in[i] );
+	}
+}
+
+
+static inline void fastTanhf( const float * in, float * out, int n )
+{
+	for( int i = 0; i < n; ++i )
+	{
+		out[i] = fastTanhf( in[i] );
+	}
+}
+
+
+static inline void fastLog2f( const float * in, float * out, int n )
+{
+	for( int i = 0; i < n; ++i )
+	{
+		out[i] = fastLog2f( in[i] );
+	}
+}
+
+
+static inline void fastCosf( const float * in, float * out, int n )
+{
+	for( int i = 0; i < n; ++i )
+	{
+		out[i] = fastCosf( in[i] );
+	}
+}
+
+
 //! @brief Exponential function that deals with negative bases
 static inline float signedPowf( float v, float e )
 {
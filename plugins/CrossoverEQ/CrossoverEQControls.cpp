@@ -43,9 +43,9 @@ CrossoverEQControls::CrossoverEQControls( CrossoverEQEffect * eff ) :
 	m_mute4( true, this, "Mute Band 4" )
 {
 	connect( Engine::mixer(), SIGNAL( sampleRateChanged() ), this, SLOT( sampleRateChanged() ) );
-	connect( &m_xover12, SIGNAL( dataChanged() ), this, SLOT( xover12Changed() ) );
-	connect( &m_xover23, SIGNAL( dataChanged() ), this, SLOT( xover23Changed() ) );
-	connect( &m_xover34, SIGNAL( dataChanged() ), this, SLOT( xover34Changed() ) );
+	m_xover12.addValueListener( [this]() { xover12Changed(); } );
+	m_xover23.addValueListener( [this]() { xover23Changed(); } );
+	m_xover34.addValueListener( [this]() { xover34Changed(); } );
 	
 	m_xover12.setScaleLogarithmic( true );
 	m_xover23.setScaleLogarithmic( true );
@@ -50,12 +50,70 @@ Plugin::Descriptor PLUGIN_EXPORT eq_plugin_descriptor =
 }
 
 
+// number of frames processed with the same filter coefficients when
+// parameters are automated sample-exactly
+const fpp_t PARAMETER_BLOCK_SIZE = 16;
+
+
+
+
+EqAnalysisThread::EqAnalysisThread( EqEffect * effect ) :
+	m_effect( effect ),
+	m_quit( false )
+{
+}
+
+
+
+
+void EqAnalysisThread::requestAnalysis()
+{
+	// both spectrum views ask for an update, one pending request is enough
+	if( m_requests.available() == 0 )
+	{
+		m_requests.release();
+	}
+}
+
+
+
+
+void EqAnalysisThread::stop()
+{
+	m_quit = true;
+	m_requests.release();
+	wait();
+}
+
+
+
+
+void EqAnalysisThread::run()
+{
+	while( true )
+	{
+		m_requests.acquire();
+		if( m_quit )
+		{
+			break;
+		}
+		m_effect->analyzePendingFrames();
+	}
+}
+
+
+
+
 EqEffect::EqEffect( Model *parent, const Plugin::Descriptor::SubPluginFeatures::Key *key) :
 	Effect( &eq_plugin_descriptor, parent, key ),
 	m_eqControls( this ),
+	m_analysisThread( this ),
 	m_inGain( 1.0 ),
 	m_outGain( 1.0 )
 {
+	m_eqControls.m_inFftBands.setAnalysisThread( &m_analysisThread );
+	m_eqControls.m_outFftBands.setAnalysisThread( &m_analysisThread );
+	m_analysisThread.start( QThread::LowPriority );
 }
 
 
@@ -63,6 +121,7 @@ EqEffect::EqEffect( Model *parent, const Plugin::Descriptor::SubPluginFeatures::
 
 EqEffect::~EqEffect()
 {
+	m_analysisThread.stop();
 }
 
 
@@ -73,7 +132,6 @@ bool EqEffect::processAudioBuffer( sampleFrame *buf, const fpp_t frames )
 	//wet/dry controls
 	const float dry = dryLevel();
 	const float wet = wetLevel();
-	sample_t dryS[2];
 	// setup sample exact controls
 	float hpRes = m_eqControls.m_hpResModel.value();
 	float lowShelfRes = m_eqControls.m_lowShelfResModel.value();
@@ -196,7 +254,7 @@ bool EqEffect::processAudioBuffer( sampleFrame *buf, const fpp_t frames )
 
 	if(m_eqControls.m_analyseInModel.value( true ) &&  outSum > 0 )
 	{
-		m_eqControls.m_inFftBands.analyze( buf, frames );
+		m_eqControls.m_inFftBands.queueFrames( buf, frames );
 	}
 	else
 	{
@@ -207,124 +265,124 @@ bool EqEffect::processAudioBuffer( sampleFrame *buf, const fpp_t frames )
 	m_eqControls.m_inPeakL = m_eqControls.m_inPeakL < m_inPeak[0] ? m_inPeak[0] : m_eqControls.m_inPeakL;
 	m_eqControls.m_inPeakR = m_eqControls.m_inPeakR < m_inPeak[1] ? m_inPeak[1] : m_eqControls.m_inPeakR;
 
-	for( fpp_t f = 0; f < frames; f++)
+	// Every band processes a whole sub-block at once. Automated parameters
+	// (ValueBuffers) are sampled at the end of each sub-block, so
+	// coefficients are recalculated at most once per PARAMETER_BLOCK_SIZE
+	// frames instead of for every single frame. The filters glide to the new
+	// coefficients over the sub-block, so there are no steps in between.
+	sampleFrame dryBuf[PARAMETER_BLOCK_SIZE];
+
+	for( fpp_t offset = 0; offset < frames; offset += PARAMETER_BLOCK_SIZE )
 	{
+		const fpp_t n = qMin<fpp_t>( PARAMETER_BLOCK_SIZE, frames - offset );
+		const fpp_t last = n - 1;
+		sampleFrame * b = buf + offset;
+
 		//wet dry buffer
-		dryS[0] = buf[f][0];
-		dryS[1] = buf[f][1];
+		memcpy( dryBuf, b, n * sizeof( sampleFrame ) );
+
 		if( hpActive )
 		{
-			m_hp12.setParameters( sampleRate, *hpFreqPtr, *hpResPtr, 1 );
-			buf[f][0] = m_hp12.update( buf[f][0], 0 );
-			buf[f][1] = m_hp12.update( buf[f][1], 1 );
+			m_hp12.setParameters( sampleRate, hpFreqPtr[hpFreqInc * last], hpResPtr[hpResInc * last], 1 );
+			m_hp12.processBuffer( b, n );
 
 			if( hp24Active || hp48Active )
 			{
-				m_hp24.setParameters( sampleRate, *hpFreqPtr, *hpResPtr, 1 );
-				buf[f][0] = m_hp24.update( buf[f][0], 0 );
-				buf[f][1] = m_hp24.update( buf[f][1], 1 );
+				m_hp24.setParameters( sampleRate, hpFreqPtr[hpFreqInc * last], hpResPtr[hpResInc * last], 1 );
+				m_hp24.processBuffer( b, n );
 			}
 
 			if( hp48Active )
 			{
-				m_hp480.setParameters( sampleRate, *hpFreqPtr, *hpResPtr, 1 );
-				buf[f][0] = m_hp480.update( buf[f][0], 0 );
-				buf[f][1] = m_hp480.update( buf[f][1], 1 );
+				m_hp480.setParameters( sampleRate, hpFreqPtr[hpFreqInc * last], hpResPtr[hpResInc * last], 1 );
+				m_hp480.processBuffer( b, n );
 
-				m_hp481.setParameters( sampleRate, *hpFreqPtr, *hpResPtr, 1 );
-				buf[f][0] = m_hp481.update( buf[f][0], 0 );
-				buf[f][1] = m_hp481.update( buf[f][1], 1 );
+				m_hp481.setParameters( sampleRate, hpFreqPtr[hpFreqInc * last], hpResPtr[hpResInc * last], 1 );
+				m_hp481.processBuffer( b, n );
 			}
 		}
 
 		if( lowShelfActive )
 		{
-			m_lowShelf.setParameters( sampleRate, *lowShelfFreqPtr, *lowShelfResPtr, lowShelfGain );
-			buf[f][0] = m_lowShelf.update( buf[f][0], 0 );
-			buf[f][1] = m_lowShelf.update( buf[f][1], 1 );
+			m_lowShelf.setParameters( sampleRate, lowShelfFreqPtr[lowShelfFreqInc * last], lowShelfResPtr[lowShelfResInc * last], lowShelfGain );
+			m_lowShelf.processBuffer( b, n );
 		}
 
 		if( para1Active )
 		{
-			m_para1.setParameters( sampleRate, *para1FreqPtr, *para1BwPtr, para1Gain );
-			buf[f][0] = m_para1.update( buf[f][0], 0 );
-			buf[f][1] = m_para1.update( buf[f][1], 1 );
+			m_para1.setParameters( sampleRate, para1FreqPtr[para1FreqInc * last], para1BwPtr[para1BwInc * last], para1Gain );
+			m_para1.processBuffer( b, n );
 		}
 
 		if( para2Active )
 		{
-			m_para2.setParameters( sampleRate, *para2FreqPtr, *para2BwPtr, para2Gain );
-			buf[f][0] = m_para2.update( buf[f][0], 0 );
-			buf[f][1] = m_para2.update( buf[f][1], 1 );
+			m_para2.setParameters( sampleRate, para2FreqPtr[para2FreqInc * last], para2BwPtr[para2BwInc * last], para2Gain );
+			m_para2.processBuffer( b, n );
 		}
 
 		if( para3Active )
 		{
-			m_para3.setParameters( sampleRate, *para3FreqPtr, *para3BwPtr, para3Gain );
-			buf[f][0] = m_para3.update( buf[f][0], 0 );
-			buf[f][1] = m_para3.update( buf[f][1], 1 );
+			m_para3.setParameters( sampleRate, para3FreqPtr[para3FreqInc * last], para3BwPtr[para3BwInc * last], para3Gain );
+			m_para3.processBuffer( b, n );
 		}
 
 		if( para4Active )
 		{
-			m_para4.setParameters( sampleRate, *para4FreqPtr, *para4BwPtr, para4Gain );
-			buf[f][0] = m_para4.update( buf[f][0], 0 );
-			buf[f][1] = m_para4.update( buf[f][1], 1 );
+			m_para4.setParameters( sampleRate, para4FreqPtr[para4FreqInc * last], para4BwPtr[para4BwInc * last], para4Gain );
+			m_para4.processBuffer( b, n );
 		}
 
 		if( highShelfActive )
 		{
-			m_highShelf.setParameters( sampleRate, *hightShelfFreqPtr, *highShelfResPtr, highShelfGain );
-			buf[f][0] = m_highShelf.update( buf[f][0], 0 );
-			buf[f][1] = m_highShelf.update( buf[f][1], 1 );
+			m_highShelf.setParameters( sampleRate, hightShelfFreqPtr[highShelfFreqInc * last], highShelfResPtr[highShelfResInc * last], highShelfGain );
+			m_highShelf.processBuffer( b, n );
 		}
 
 		if( lpActive ){
-			m_lp12.setParameters( sampleRate, *lpFreqPtr, *lpResPtr, 1 );
-			buf[f][0] = m_lp12.update( buf[f][0], 0 );
-			buf[f][1] = m_lp12.update( buf[f][1], 1 );
+			m_lp12.setParameters( sampleRate, lpFreqPtr[lpFreqInc * last], lpResPtr[lpResInc * last], 1 );
+			m_lp12.processBuffer( b, n );
 
 			if( lp24Active || lp48Active )
 			{
-				m_lp24.setParameters( sampleRate, *lpFreqPtr, *lpResPtr, 1 );
-				buf[f][0] = m_lp24.update( buf[f][0], 0 );
-				buf[f][1] = m_lp24.update( buf[f][1], 1 );
+				m_lp24.setParameters( sampleRate, lpFreqPtr[lpFreqInc * last], lpResPtr[lpResInc * last], 1 );
+				m_lp24.processBuffer( b, n );
 			}
 
 			if( lp48Active )
 			{
-				m_lp480.setParameters( sampleRate, *lpFreqPtr, *lpResPtr, 1 );
-				buf[f][0] = m_lp480.update( buf[f][0], 0 );
-				buf[f][1] = m_lp480.update( buf[f][1], 1 );
+				m_lp480.setParameters( sampleRate, lpFreqPtr[lpFreqInc * last], lpResPtr[lpResInc * last], 1 );
+				m_lp480.processBuffer( b, n );
 
-				m_lp481.setParameters( sampleRate, *lpFreqPtr, *lpResPtr, 1 );
-				buf[f][0] = m_lp481.update( buf[f][0], 0 );
-				buf[f][1] = m_lp481.update( buf[f][1], 1 );
+				m_lp481.setParameters( sampleRate, lpFreqPtr[lpFreqInc * last], lpResPtr[lpResInc * last], 1 );
+				m_lp481.processBuffer( b, n );
 			}
 		}
 
 		//apply wet / dry levels
-		buf[f][1] = ( dry * dryS[1] ) + ( wet * buf[f][1] );
-		buf[f][0] = ( dry * dryS[0] ) + ( wet * buf[f][0] );
+		for( fpp_t f = 0; f < n; ++f )
+		{
+			b[f][1] = ( dry * dryBuf[f][1] ) + ( wet * b[f][1] );
+			b[f][0] = ( dry * dryBuf[f][0] ) + ( wet * b[f][0] );
+		}
 
 		//increment pointers if needed
-		hpResPtr += hpResInc;
-		lowShelfResPtr += lowShelfResInc;
-		para1BwPtr += para1BwInc;
-		para2BwPtr += para2BwInc;
-		para3BwPtr += para3BwInc;
-		para4BwPtr += para4BwInc;
-		highShelfResPtr += highShelfResInc;
-		lpResPtr += lpResInc;
-
-		hpFreqPtr += hpFreqInc;
-		lowShelfFreqPtr += lowShelfFreqInc;
-		para1FreqPtr += para1FreqInc;
-		para2FreqPtr += para2FreqInc;
-		para3FreqPtr += para3FreqInc;
-		para4FreqPtr += para4FreqInc;
-		hightShelfFreqPtr += highShelfFreqInc;
-		lpFreqPtr += lpFreqInc;
+		hpResPtr += hpResInc * n;
+		lowShelfResPtr += lowShelfResInc * n;
+		para1BwPtr += para1BwInc * n;
+		para2BwPtr += para2BwInc * n;
+		para3BwPtr += para3BwInc * n;
+		para4BwPtr += para4BwInc * n;
+		highShelfResPtr += highShelfResInc * n;
+		lpResPtr += lpResInc * n;
+
+		hpFreqPtr += hpFreqInc * n;
+		lowShelfFreqPtr += lowShelfFreqInc * n;
+		para1FreqPtr += para1FreqInc * n;
+		para2FreqPtr += para2FreqInc * n;
+		para3FreqPtr += para3FreqInc * n;
+		para4FreqPtr += para4FreqInc * n;
+		hightShelfFreqPtr += highShelfFreqInc * n;
+		lpFreqPtr += lpFreqInc * n;
 	}
 
 	sampleFrame outPeak = { 0, 0 };
@@ -336,8 +394,7 @@ bool EqEffect::processAudioBuffer( sampleFrame *buf, const fpp_t frames )
 
 	if(m_eqControls.m_analyseOutModel.value( true ) && outSum > 0 )
 	{
-		m_eqControls.m_outFftBands.analyze( buf, frames );
-		setBandPeaks( &m_eqControls.m_outFftBands , ( int )( sampleRate ) );
+		m_eqControls.m_outFftBands.queueFrames( buf, frames );
 	}
 	else
 	{
@@ -351,6 +408,19 @@ bool EqEffect::processAudioBuffer( sampleFrame *buf, const fpp_t frames )
 
 
 
+void EqEffect::analyzePendingFrames()
+{
+	m_eqControls.m_inFftBands.analyzePendingFrames();
+	if( m_eqControls.m_outFftBands.analyzePendingFrames() )
+	{
+		setBandPeaks( &m_eqControls.m_outFftBands,
+				Engine::mixer()->processingSampleRate() );
+	}
+}
+
+
+
+
 float EqEffect::peakBand( float minF, float maxF, EqAnalyser *fft, int sr )
 {
 	float peak = -60;
@@ -24,6 +24,9 @@
 #ifndef EQEFFECT_H
 #define EQEFFECT_H
 
+#include <QSemaphore>
+#include <QThread>
+
 #include "BasicFilters.h"
 #include "Effect.h"
 #include "EqControls.h"
@@ -32,6 +35,30 @@
 
 
 
+class EqEffect;
+
+// runs the spectrum analysis of both analysers with low priority, off the
+// audio thread
+class EqAnalysisThread : public QThread
+{
+public:
+	EqAnalysisThread( EqEffect * effect );
+
+	void requestAnalysis();
+	void stop();
+
+protected:
+	virtual void run();
+
+private:
+	EqEffect * m_effect;
+	QSemaphore m_requests;
+	volatile bool m_quit;
+};
+
+
+
+
 class EqEffect : public Effect
 {
 public:
@@ -63,7 +90,11 @@ public:
 	}
 
 private:
+	// called from m_analysisThread
+	void analyzePendingFrames();
+
 	EqControls m_eqControls;
+	EqAnalysisThread m_analysisThread;
 
 	EqHp12Filter m_hp12;
 	EqHp12Filter m_hp24;
@@ -95,6 +126,8 @@ private:
 	}
 
 	void setBandPeaks( EqAnalyser * fft , int );
+
+	friend class EqAnalysisThread;
 };
 
 #endif // EQEFFECT_H
@@ -31,9 +31,12 @@
 ///
 /// \brief The EqFilter class.
 /// A wrapper for the StereoBiQuad class, giving it freq, res, and gain controls.
-/// It is designed to process periods in one pass, with recalculation of coefficents
-/// upon parameter changes. The intention is to use this as a bass class, children override
-/// the calcCoefficents() function, providing the coefficents a1, a2, b0, b1, b2.
+/// It is designed to process whole periods in one pass: set the parameters for
+/// the block, which recalculates the coefficents if they changed, then run the
+/// block through StereoBiQuad::processBuffer(), which glides to the new
+/// coefficents over the block. The intention is to use this as a base class,
+/// children override the calcCoefficents() function, providing the
+/// coefficents a1, a2, b0, b1, b2.
 ///
 class EqFilter : public StereoBiQuad
 {
@@ -43,7 +46,8 @@ public:
 		m_freq(0),
 		m_res(0),
 		m_gain(0),
-		m_bw(0)
+		m_bw(0),
+		m_hasCoeffs(false)
 	{
 
 	}
@@ -127,11 +131,29 @@ protected:
 
 	}
 
+	///
+	/// \brief setCoeffs
+	///  Glides to the new coefficents during the next block, except for the
+	///  first ones
+	void setCoeffs( float a1, float a2, float b0, float b1, float b2 )
+	{
+		if( m_hasCoeffs )
+		{
+			glideCoeffs( a1, a2, b0, b1, b2 );
+		}
+		else
+		{
+			StereoBiQuad::setCoeffs( a1, a2, b0, b1, b2 );
+			m_hasCoeffs = true;
+		}
+	}
+
 	float m_sampleRate;
 	float m_freq;
 	float m_res;
 	float m_gain;
 	float m_bw;
+	bool m_hasCoeffs;
 };
 
 
@@ -406,11 +428,7 @@ public:
 
 	virtual void processBuffer( sampleFrame* buf, const fpp_t frames )
 	{
-		for ( fpp_t f = 0 ; f < frames ; ++f)
-		{
-			buf[f][0] = update( buf[f][0] , 0);
-			buf[f][1] = update( buf[f][1] , 1);
-		}
+		StereoLinkwitzRiley::processBuffer( buf, frames );
 	}
 protected:
 
@@ -24,6 +24,7 @@
 
 #include "Engine.h"
 #include "EqCurve.h"
+#include "EqEffect.h"
 #include "GuiApplication.h"
 #include "MainWindow.h"
 #include "Mixer.h"
@@ -32,7 +33,10 @@ EqAnalyser::EqAnalyser() :
 	m_framesFilledUp ( 0 ),
 	m_energy ( 0 ),
 	m_sampleRate ( 1 ),
-	m_active ( true )
+	m_active ( true ),
+	m_inputBuffer( FFT_BUFFER_SIZE * 4 ),
+	m_clearRequested( false ),
+	m_analysisThread( NULL )
 {
 	m_inProgress=false;
 	m_specBuf = ( fftwf_complex * ) fftwf_malloc( ( FFT_BUFFER_SIZE + 1 ) * sizeof( fftwf_complex ) );
@@ -51,7 +55,9 @@ EqAnalyser::EqAnalyser() :
 								+ a2 * cos(4 * F_PI * i / ((float)FFT_BUFFER_SIZE - 1.0))
 								- a3 * cos(6 * F_PI * i / ((float)FFT_BUFFER_SIZE - 1.0)));
 	}
-	clear();
+	m_framesFilledUp = 0;
+	memset( m_buffer, 0, sizeof( m_buffer ) );
+	memset( m_bands, 0, sizeof( m_bands ) );
 }
 
 
@@ -66,55 +72,113 @@ EqAnalyser::~EqAnalyser()
 
 
 
-void EqAnalyser::analyze( sampleFrame *buf, const fpp_t frames )
+void EqAnalyser::queueFrames( sampleFrame *buf, const fpp_t frames )
 {
 	//only analyse if the view is visible
 	if ( m_active )
 	{
-		m_inProgress=true;
-		const int FFT_BUFFER_SIZE = 2048;
 		fpp_t f = 0;
 		if( frames > FFT_BUFFER_SIZE )
 		{
-			m_framesFilledUp = 0;
 			f = frames - FFT_BUFFER_SIZE;
 		}
+		m_inputBuffer.write( buf + f, frames - f );
+	}
+}
+
+
+
+
+bool EqAnalyser::analyzePendingFrames()
+{
+	if( m_clearRequested )
+	{
+		m_clearRequested = false;
+		m_inputBuffer.skip();
+		m_framesFilledUp = 0;
+		m_energy = 0;
+		memset( m_buffer, 0, sizeof( m_buffer ) );
+		memset( m_bands, 0, sizeof( m_bands ) );
+		return false;
+	}
+
+	sampleFrame frames[FFT_BUFFER_SIZE];
+	int count;
+	bool haveWindow = false;
+	while( ( count = m_inputBuffer.read( frames,
+				FFT_BUFFER_SIZE - m_framesFilledUp ) ) > 0 )
+	{
 		// meger channels
-		for( ; f < frames; ++f )
+		for( int f = 0; f < count; ++f )
 		{
 			m_buffer[m_framesFilledUp] =
-					( buf[f][0] + buf[f][1] ) * 0.5;
+					( frames[f][0] + frames[f][1] ) * 0.5;
 			++m_framesFilledUp;
 		}
 
 		if( m_framesFilledUp < FFT_BUFFER_SIZE )
 		{
-			m_inProgress = false;
-			return;
+			continue;
 		}
 
-		m_sampleRate = Engine::mixer()->processingSampleRate();
-		const int LOWEST_FREQ = 0;
-		const int HIGHEST_FREQ = m_sampleRate / 2;
-
-		//apply FFT window
-		for( int i = 0; i < FFT_BUFFER_SIZE; i++ )
+		// skip windows which are outdated already
+		if( m_inputBuffer.available() >= FFT_BUFFER_SIZE )
 		{
-			m_buffer[i] = m_buffer[i] * m_fftWindow[i];
+			m_framesFilledUp = 0;
+			continue;
 		}
+		haveWindow = true;
+		break;
+	}
+
+	if( !haveWindow )
+	{
+		return false;
+	}
 
-		fftwf_execute( m_fftPlan );
-		absspec( m_specBuf, m_absSpecBuf, FFT_BUFFER_SIZE+1 );
+	m_inProgress=true;
 
-		compressbands( m_absSpecBuf, m_bands, FFT_BUFFER_SIZE+1,
-					   MAX_BANDS,
-					   ( int )( LOWEST_FREQ * ( FFT_BUFFER_SIZE + 1 ) / ( float )( m_sampleRate / 2 ) ),
-					   ( int )( HIGHEST_FREQ * ( FFT_BUFFER_SIZE +  1) / ( float )( m_sampleRate / 2 ) ) );
-		m_energy = maximum( m_bands, MAX_BANDS ) / maximum( m_buffer, FFT_BUFFER_SIZE );
+	m_sampleRate = Engine::mixer()->processingSampleRate();
+	const int LOWEST_FREQ = 0;
+	const int HIGHEST_FREQ = m_sampleRate / 2;
 
-		m_framesFilledUp = 0;
-		m_inProgress = false;
-		m_active = false;
+	//apply FFT window
+	for( int i = 0; i < FFT_BUFFER_SIZE; i++ )
+	{
+		m_buffer[i] = m_buffer[i] * m_fftWindow[i];
+	}
+
+	fftwf_execute( m_fftPlan );
+	absspec( m_specBuf, m_absSpecBuf, FFT_BUFFER_SIZE+1 );
+
+	compressbands( m_absSpecBuf, m_bands, FFT_BUFFER_SIZE+1,
+				   MAX_BANDS,
+				   ( int )( LOWEST_FREQ * ( FFT_BUFFER_SIZE + 1 ) / ( float )( m_sampleRate / 2 ) ),
+				   ( int )( HIGHEST_FREQ * ( FFT_BUFFER_SIZE +  1) / ( float )( m_sampleRate / 2 ) ) );
+	m_energy = maximum( m_bands, MAX_BANDS ) / maximum( m_buffer, FFT_BUFFER_SIZE );
+
+	m_framesFilledUp = 0;
+	m_inProgress = false;
+	m_active = false;
+	return true;
+}
+
+
+
+
+void EqAnalyser::setAnalysisThread( EqAnalysisThread * thread )
+{
+	m_analysisThread = thread;
+}
+
+
+
+
+void EqAnalyser::requestAnalysis()
+{
+	if( m_analysisThread )
+	{
+		m_analysisThread->requestAnalysis();
 	}
 }
 
@@ -163,10 +227,8 @@ bool EqAnalyser::getInProgress()
 
 void EqAnalyser::clear()
 {
-	m_framesFilledUp = 0;
-	m_energy = 0;
-	memset( m_buffer, 0, sizeof( m_buffer ) );
-	memset( m_bands, 0, sizeof( m_bands ) );
+	// buffers are owned by the analysis thread, so just leave a note
+	m_clearRequested = true;
 }
 
 
@@ -290,6 +352,10 @@ float EqSpectrumView::bandToFreq( int index )
 
 void EqSpectrumView::periodicalUpdate()
 {
+	if( isVisible() )
+	{
+		m_analyser->requestAnalysis();
+	}
 	m_periodicalUpdate = true;
 	update();
 }
@@ -29,8 +29,11 @@
 #include "fft_helpers.h"
 #include "lmms_basics.h"
 #include "lmms_math.h"
+#include "LocklessRingBuffer.h"
 
 
+class EqAnalysisThread;
+
 const int MAX_BANDS = 2048;
 class EqAnalyser
 {
@@ -42,7 +45,14 @@ public:
 	bool getInProgress();
 	void clear();
 
-	void analyze( sampleFrame *buf, const fpp_t frames );
+	// audio thread: hand frames over to the analysis thread
+	void queueFrames( sampleFrame *buf, const fpp_t frames );
+	// analysis thread: returns true if a new spectrum has been calculated
+	bool analyzePendingFrames();
+
+	void setAnalysisThread( EqAnalysisThread * thread );
+	// GUI thread: wake up the analysis thread
+	void requestAnalysis();
 
 	float getEnergy() const;
 	int getSampleRate() const;
@@ -61,6 +71,10 @@ private:
 	bool m_active;
 	bool m_inProgress;
 	float m_fftWindow[FFT_BUFFER_SIZE];
+
+	LocklessRingBuffer<sampleFrame> m_inputBuffer;
+	volatile bool m_clearRequested;
+	EqAnalysisThread * m_analysisThread;
 };
 
 
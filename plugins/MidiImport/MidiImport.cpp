@@ -267,6 +267,7 @@ public:
 	{
 		if( !p || n.pos() > lastEnd + DefaultTicksPerTact )
 		{
+			flushNotes();
 			MidiTime pPos = MidiTime( n.pos().getTact(), 0 );
 			p = dynamic_cast<Pattern*>( it->createTCO( 0 ) );
 			p->movePosition( pPos );
@@ -274,9 +275,24 @@ public:
 		hasNotes = true;
 		lastEnd = n.pos() + n.length();
 		n.setPos( n.pos( p->startPosition() ) );
-		p->addNote( n, false );
+		pendingNotes.push_back( n );
 	}
 
+
+	// notes are collected and added to their pattern at once, which is
+	// a lot faster than adding them one by one for large files
+	void flushNotes()
+	{
+		if( p )
+		{
+			p->addNotes( pendingNotes, false );
+		}
+		pendingNotes.clear();
+	}
+
+private:
+	QVector<Note> pendingNotes;
+
 };
 
 
@@ -534,6 +550,7 @@ bool MidiImport::readSMF( TrackContainer* tc )
 	
 	for( int c=0; c < 256; ++c )
 	{
+		chs[c].flushNotes();
 		if( !chs[c].hasNotes && chs[c].it )
 		{
 			printf(" Should remove empty track\n");
@@ -47,17 +47,70 @@ Plugin::Descriptor PLUGIN_EXPORT spectrumanalyzer_plugin_descriptor =
 
 
 
+SpectrumAnalysisThread::SpectrumAnalysisThread( SpectrumAnalyzer * sa ) :
+	m_sa( sa ),
+	m_quit( false )
+{
+}
+
+
+
+
+void SpectrumAnalysisThread::requestAnalysis()
+{
+	// do not let requests pile up while the thread is busy
+	if( m_requests.available() == 0 )
+	{
+		m_requests.release();
+	}
+}
+
+
+
+
+void SpectrumAnalysisThread::stop()
+{
+	m_quit = true;
+	m_requests.release();
+	wait();
+}
+
+
+
+
+void SpectrumAnalysisThread::run()
+{
+	while( true )
+	{
+		m_requests.acquire();
+		if( m_quit )
+		{
+			break;
+		}
+		m_sa->analyzePendingFrames();
+	}
+}
+
+
+
+
 SpectrumAnalyzer::SpectrumAnalyzer( Model * _parent,
 			const Descriptor::SubPluginFeatures::Key * _key ) :
 	Effect( &spectrumanalyzer_plugin_descriptor, _parent, _key ),
 	m_saControls( this ),
+	m_active( false ),
+	m_inputBuffer( FFT_BUFFER_SIZE * 4 ),
+	m_analysisThread( this ),
 	m_framesFilledUp( 0 ),
 	m_energy( 0 )
 {
 	memset( m_buffer, 0, sizeof( m_buffer ) );
+	memset( m_bands, 0, sizeof( m_bands ) );
 
 	m_specBuf = (fftwf_complex *) fftwf_malloc( ( FFT_BUFFER_SIZE + 1 ) * sizeof( fftwf_complex ) );
 	m_fftPlan = fftwf_plan_dft_r2c_1d( FFT_BUFFER_SIZE*2, m_buffer, m_specBuf, FFTW_MEASURE );
+
+	m_analysisThread.start( QThread::LowPriority );
 }
 
 
@@ -65,6 +118,8 @@ SpectrumAnalyzer::SpectrumAnalyzer( Model * _parent,
 
 SpectrumAnalyzer::~SpectrumAnalyzer()
 {
+	m_analysisThread.stop();
+
 	fftwf_destroy_plan( m_fftPlan );
 	fftwf_free( m_specBuf );
 }
@@ -79,60 +134,98 @@ bool SpectrumAnalyzer::processAudioBuffer( sampleFrame* _buf, const fpp_t _frame
 		return false;
 	}
 
-	if( !m_saControls.isViewVisible() )
+	// nobody looks at the spectrum, so don't spend any time on it
+	if( !m_active )
 	{
 		return true;
 	}
 
+	// only queue up the frames here - the actual analysis is done by
+	// m_analysisThread whenever the view asks for an update
 	fpp_t f = 0;
 	if( _frames > FFT_BUFFER_SIZE )
 	{
-		m_framesFilledUp = 0;
 		f = _frames - FFT_BUFFER_SIZE;
 	}
+	m_inputBuffer.write( _buf + f, _frames - f );
+
+	checkGate( 1 );
+
+	return isRunning();
+}
+
+
 
-	const int cm = m_saControls.m_channelMode.value();
 
-	switch( cm )
+void SpectrumAnalyzer::analyzePendingFrames()
+{
+	sampleFrame frames[FFT_BUFFER_SIZE];
+	bool haveSpectrum = false;
+
+	int count;
+	while( ( count = m_inputBuffer.read( frames,
+				FFT_BUFFER_SIZE - m_framesFilledUp ) ) > 0 )
 	{
-		case MergeChannels:
-			for( ; f < _frames; ++f )
-			{
-				m_buffer[m_framesFilledUp] =
-					( _buf[f][0] + _buf[f][1] ) * 0.5;
-				++m_framesFilledUp;
-			}
-			break;
-		case LeftChannel:
-			for( ; f < _frames; ++f )
-			{
-				m_buffer[m_framesFilledUp] = _buf[f][0];
-				++m_framesFilledUp;
-			}
-			break;
-		case RightChannel:
-			for( ; f < _frames; ++f )
-			{
-				m_buffer[m_framesFilledUp] = _buf[f][1];
-				++m_framesFilledUp;
-			}
-			break;
+		const int cm = m_saControls.m_channelMode.value();
+
+		switch( cm )
+		{
+			case MergeChannels:
+				for( int f = 0; f < count; ++f )
+				{
+					m_buffer[m_framesFilledUp] =
+						( frames[f][0] + frames[f][1] ) * 0.5;
+					++m_framesFilledUp;
+				}
+				break;
+			case LeftChannel:
+				for( int f = 0; f < count; ++f )
+				{
+					m_buffer[m_framesFilledUp] = frames[f][0];
+					++m_framesFilledUp;
+				}
+				break;
+			case RightChannel:
+				for( int f = 0; f < count; ++f )
+				{
+					m_buffer[m_framesFilledUp] = frames[f][1];
+					++m_framesFilledUp;
+				}
+				break;
+		}
+
+		if( m_framesFilledUp < FFT_BUFFER_SIZE )
+		{
+			continue;
+		}
+
+		// only the most recent window is going to be displayed, so
+		// don't transform older ones
+		if( m_inputBuffer.available() >= FFT_BUFFER_SIZE )
+		{
+			m_framesFilledUp = 0;
+			continue;
+		}
+
+		fftwf_execute( m_fftPlan );
+		absspec( m_specBuf, m_absSpecBuf, FFT_BUFFER_SIZE+1 );
+		haveSpectrum = true;
+		break;
 	}
 
-	if( m_framesFilledUp < FFT_BUFFER_SIZE )
+	if( !haveSpectrum )
 	{
-		return isRunning();
+		return;
 	}
 
-
 //	hanming( m_buffer, FFT_BUFFER_SIZE, HAMMING );
 
 	const sample_rate_t sr = Engine::mixer()->processingSampleRate();
 	const int LOWEST_FREQ = 0;
 	const int HIGHEST_FREQ = sr / 2;
 
-	fftwf_execute( m_fftPlan );
-	absspec( m_specBuf, m_absSpecBuf, FFT_BUFFER_SIZE+1 );
+	QMutexLocker lock( &m_bandsMutex );
+
 	if( m_saControls.m_linearSpec.value() )
 	{
 		compressbands( m_absSpecBuf, m_bands, FFT_BUFFER_SIZE+1,
@@ -147,12 +240,7 @@ bool SpectrumAnalyzer::processAudioBuffer( sampleFrame* _buf, const fpp_t _frame
 		m_energy = signalpower( m_buffer, FFT_BUFFER_SIZE ) / maximum( m_buffer, FFT_BUFFER_SIZE );
 	}
 
-
 	m_framesFilledUp = 0;
-
-	checkGate( 1 );
-
-	return isRunning();
 }
 
 
@@ -26,14 +26,44 @@
 #ifndef _SPECTRUM_ANALYZER_H
 #define _SPECTRUM_ANALYZER_H
 
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+
 #include "Effect.h"
 #include "fft_helpers.h"
+#include "LocklessRingBuffer.h"
 #include "SpectrumAnalyzerControls.h"
 
 
 const int MAX_BANDS = 249;
 
 
+class SpectrumAnalyzer;
+
+// low priority thread doing all FFT work so the audio thread only has to
+// queue up frames
+class SpectrumAnalysisThread : public QThread
+{
+public:
+	SpectrumAnalysisThread( SpectrumAnalyzer * sa );
+
+	// wake up the thread - called from the GUI at display rate
+	void requestAnalysis();
+	void stop();
+
+protected:
+	virtual void run();
+
+private:
+	SpectrumAnalyzer * m_sa;
+	QSemaphore m_requests;
+	volatile bool m_quit;
+
+} ;
+
+
+
 class SpectrumAnalyzer : public Effect
 {
 public:
@@ -56,9 +86,30 @@ public:
 	}
 
 
+	void requestAnalysis()
+	{
+		m_analysisThread.requestAnalysis();
+	}
+
+	// frames are only queued for analysis while the view is shown
+	void setActive( bool _active )
+	{
+		m_active = _active;
+	}
+
+
 private:
+	// called from analysis thread
+	void analyzePendingFrames();
+
 	SpectrumAnalyzerControls m_saControls;
 
+	volatile bool m_active;
+	LocklessRingBuffer<sampleFrame> m_inputBuffer;
+	SpectrumAnalysisThread m_analysisThread;
+	// protects m_bands and m_energy against concurrent painting
+	QMutex m_bandsMutex;
+
 	fftwf_plan m_fftPlan;
 
 	fftwf_complex * m_specBuf;
@@ -69,6 +120,7 @@ private:
 	float m_bands[MAX_BANDS];
 	float m_energy;
 
+	friend class SpectrumAnalysisThread;
 	friend class SpectrumAnalyzerControls;
 	friend class SpectrumView;
 
@@ -70,11 +70,25 @@ public:
 	{
 	}
 
+	virtual void hideEvent( QHideEvent* event )
+	{
+		m_sa->setActive( false );
+		QWidget::hideEvent( event );
+	}
+
 	virtual void paintEvent( QPaintEvent* event )
 	{
+		// only analyse if the view is visible
+		m_sa->setActive( isVisible() );
+
+		// have the analysis thread prepare the next frame while we're
+		// painting the current one
+		m_sa->requestAnalysis();
+
 		QPainter p( this );
 		QImage i = m_sa->m_saControls.m_linearSpec.value() ?
 					m_backgroundPlain : m_background;
+		QMutexLocker lock( &m_sa->m_bandsMutex );
 		const float e = m_sa->m_energy;
 		if( e <= 0 )
 		{
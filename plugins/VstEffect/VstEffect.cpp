@@ -26,6 +26,7 @@
 
 #include "VstEffect.h"
 
+#include "BufferManager.h"
 #include "GuiApplication.h"
 #include "Song.h"
 #include "TextFloat.h"
@@ -59,8 +60,12 @@ VstEffect::VstEffect( Model * _parent,
 	Effect( &vsteffect_plugin_descriptor, _parent, _key ),
 	m_pluginMutex(),
 	m_key( *_key ),
-	m_vstControls( this )
+	m_vstControls( this ),
+	m_delayedDry( MM_ALLOC( sampleFrame, Engine::mixer()->framesPerPeriod() ) ),
+	m_sleeping( true )
 {
+	BufferManager::clear( m_delayedDry, Engine::mixer()->framesPerPeriod() );
+
 	if( !m_key.attributes["file"].isEmpty() )
 	{
 		openPlugin( m_key.attributes["file"] );
@@ -74,6 +79,15 @@ VstEffect::VstEffect( Model * _parent,
 
 VstEffect::~VstEffect()
 {
+	MM_FREE( m_delayedDry );
+}
+
+
+
+
+f_cnt_t VstEffect::latency() const
+{
+	return m_plugin ? m_plugin->latency() : 0;
 }
 
 
@@ -83,12 +97,14 @@ bool VstEffect::processAudioBuffer( sampleFrame * _buf, const fpp_t _frames )
 {
 	if( !isEnabled() || !isRunning () )
 	{
+		m_sleeping = true;
 		return false;
 	}
 
 	if( m_plugin )
 	{
 		const float d = dryLevel();
+		const bool delayed = m_plugin->latency() > 0;
 #ifdef __GNUC__
 		sampleFrame buf[_frames];
 #else
@@ -97,16 +113,46 @@ bool VstEffect::processAudioBuffer( sampleFrame * _buf, const fpp_t _frames )
 		memcpy( buf, _buf, sizeof( sampleFrame ) * _frames );
 		if (m_pluginMutex.tryLock(Engine::getSong()->isExporting() ? -1 : 0))
 		{
+			if( m_sleeping )
+			{
+				// whatever the plugin got before we stopped
+				// running is stale by now
+				m_plugin->discardPendingOutput();
+				BufferManager::clear( m_delayedDry, _frames );
+			}
+			m_sleeping = false;
 			m_plugin->process( buf, buf );
 			m_pluginMutex.unlock();
 		}
+		else if( delayed )
+		{
+			// pass through the dry signal with the same latency
+			memcpy( buf, m_delayedDry, sizeof( sampleFrame ) * _frames );
+		}
 
 		double out_sum = 0.0;
 		const float w = wetLevel();
-		for( fpp_t f = 0; f < _frames; ++f )
+		if( delayed )
+		{
+			// the wet signal is one period late, so delay the dry one
+			// as well, otherwise mixing them comb-filters
+			for( fpp_t f = 0; f < _frames; ++f )
+			{
+				const sample_t l = m_delayedDry[f][0];
+				const sample_t r = m_delayedDry[f][1];
+				m_delayedDry[f][0] = _buf[f][0];
+				m_delayedDry[f][1] = _buf[f][1];
+				_buf[f][0] = w*buf[f][0] + d*l;
+				_buf[f][1] = w*buf[f][1] + d*r;
+			}
+		}
+		else
 		{
-			_buf[f][0] = w*buf[f][0] + d*_buf[f][0];
-			_buf[f][1] = w*buf[f][1] + d*_buf[f][1];
+			for( fpp_t f = 0; f < _frames; ++f )
+			{
+				_buf[f][0] = w*buf[f][0] + d*_buf[f][0];
+				_buf[f][1] = w*buf[f][1] + d*_buf[f][1];
+			}
 		}
 		for( fpp_t f = 0; f < _frames; ++f )
 		{
@@ -44,6 +44,8 @@ public:
 	virtual bool processAudioBuffer( sampleFrame * _buf,
 							const fpp_t _frames );
 
+	virtual f_cnt_t latency() const;
+
 	virtual EffectControls * controls()
 	{
 		return &m_vstControls;
@@ -65,6 +67,11 @@ private:
 
 	VstEffectControls m_vstControls;
 
+	// the dry signal of the previous period, mixed with the wet signal
+	// when the plugin is pipelined and its output is one period late
+	sampleFrame * m_delayedDry;
+	bool m_sleeping;
+
 
 	friend class VstEffectControls;
 	friend class VstEffectControlDialog;
@@ -90,13 +90,8 @@ void VstEffectControls::loadSettings( const QDomElement & _this )
 				knobFModel[ i ]->setInitValue(LocaleHelper::toFloat(s_dumpValues.at(2)));
 			}
 
-#if QT_VERSION < 0x050000
-			connect( knobFModel[i], SIGNAL( dataChanged( Model * ) ),
-				this, SLOT( setParameter( Model * ) ), Qt::DirectConnection );
-#else
-			connect( knobFModel[i], &FloatModel::dataChanged, this,
-				[this, i]() { setParameter( knobFModel[i] ); }, Qt::DirectConnection);
-#endif
+			knobFModel[i]->addValueListener(
+				[this, i]() { setParameter( knobFModel[i] ); } );
 		}
 
 	}
@@ -388,17 +383,15 @@ manageVSTEffectView::manageVSTEffectView( VstEffect * _eff, VstEffectControls *
 			sprintf( paramStr, "%d", i);
 			m_vi->knobFModel[ i ] = new FloatModel( LocaleHelper::toFloat(s_dumpValues.at(2)),
 					0.0f, 1.0f, 0.01f, _eff, tr( paramStr ) );
+
+			// follows automation in the rendering thread as long as the
+			// model exists
+			VstEffectControls * controls = m_vi;
+			FloatModel * model = m_vi->knobFModel[i];
+			model->addValueListener( [controls, model]() { controls->setParameter( model ); } );
 		}
 
-		FloatModel * model = m_vi->knobFModel[i];
-#if QT_VERSION < 0x050000
-		connect( model, SIGNAL( dataChanged( Model * ) ), this,
-			SLOT( setParameter( Model * ) ), Qt::DirectConnection );
-#else
-		connect( model, &FloatModel::dataChanged, this,
-			[this, model]() { setParameter( model ); }, Qt::DirectConnection);
-#endif
-		vstKnobs[ i ] ->setModel( model );
+		vstKnobs[ i ] ->setModel( m_vi->knobFModel[i] );
 	}
 
 	int i = 0;
@@ -491,18 +484,6 @@ void manageVSTEffectView::displayAutomatedOnly( void )
 
 
 
-void manageVSTEffectView::setParameter( Model * action )
-{
-	int knobUNID = action->displayName().toInt();
-
-	if ( m_effect->m_plugin != NULL ) {
-		m_effect->m_plugin->setParam( knobUNID, m_vi2->knobFModel[knobUNID]->value() );
-	}
-}
-
-
-
-
 manageVSTEffectView::~manageVSTEffectView()
 {
 	if( m_vi2->knobFModel != NULL )
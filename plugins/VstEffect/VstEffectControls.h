@@ -110,7 +110,6 @@ public:
 protected slots:
 	void syncPlugin( void );
 	void displayAutomatedOnly( void );
-	void setParameter( Model * action );
 	void closeWindow();
 
 private:
@@ -97,6 +97,11 @@ audioFileProcessor::audioFileProcessor( InstrumentTrack * _instrument_track ) :
 				this, SLOT( loopPointChanged() ) );
 	connect( &m_stutterModel, SIGNAL( dataChanged() ),
 	    		this, SLOT( stutterModelChanged() ) );
+	// files loaded in the background arrive later
+	connect( &m_sampleBuffer, SIGNAL( sampleUpdated() ),
+				this, SLOT( pointChanged() ) );
+	m_sampleBuffer.setCompact( ConfigManager::inst()->value( "mixer",
+						"compactsamples" ).toInt() );
 	    		
 //interpolation modes
 	m_interpolationModel.addItem( tr( "None" ) );
@@ -286,7 +291,8 @@ void audioFileProcessor::loadSettings( const QDomElement & _this )
 
 void audioFileProcessor::loadFile( const QString & _file )
 {
-	setAudioFile( _file );
+	// don't block the GUI while decoding dropped or browsed files
+	setAudioFile( _file, true, true );
 }
 
 
@@ -321,7 +327,7 @@ PluginView * audioFileProcessor::instantiateView( QWidget * _parent )
 
 
 void audioFileProcessor::setAudioFile( const QString & _audio_file,
-													bool _rename )
+													bool _rename, bool _async )
 {
 	// is current channel-name equal to previous-filename??
 	if( _rename &&
@@ -334,7 +340,14 @@ void audioFileProcessor::setAudioFile( const QString & _audio_file,
 	}
 	// else we don't touch the track-name, because the user named it self
 
-	m_sampleBuffer.setAudioFile( _audio_file );
+	if( _async )
+	{
+		m_sampleBuffer.loadAudioFileAsync( _audio_file );
+	}
+	else
+	{
+		m_sampleBuffer.setAudioFile( _audio_file );
+	}
 	loopPointChanged();
 }
 
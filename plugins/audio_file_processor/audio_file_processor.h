@@ -68,7 +68,8 @@ public:
 
 
 public slots:
-	void setAudioFile( const QString & _audio_file, bool _rename = true );
+	void setAudioFile( const QString & _audio_file, bool _rename = true,
+							bool _async = false );
 
 
 private slots:
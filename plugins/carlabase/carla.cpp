@@ -29,6 +29,7 @@
 #include "gui_templates.h"
 #include "InstrumentPlayHandle.h"
 #include "InstrumentTrack.h"
+#include "MemoryHelper.h"
 #include "Mixer.h"
 
 #include <QApplication>
@@ -38,6 +39,7 @@
 #include <QTimerEvent>
 #include <QVBoxLayout>
 
+#include <algorithm>
 #include <cstring>
 
 #include "embed.cpp"
@@ -134,8 +136,12 @@ CarlaInstrument::CarlaInstrument(InstrumentTrack* const instrumentTrack, const D
       kIsPatchbay(isPatchbay),
       fHandle(NULL),
       fDescriptor(isPatchbay ? carla_get_native_patchbay_plugin() : carla_get_native_rack_plugin()),
-      fMidiEventCount(0)
+      fMidiQueue(kMaxMidiEvents)
 {
+    const uint bufsize = Engine::mixer()->framesPerPeriod();
+    for (int c = 0; c < DEFAULT_CHANNELS; ++c)
+        fAudioBuffers[c] = (float*)MemoryHelper::alignedMalloc(sizeof(float)*bufsize);
+
     fHost.handle      = this;
     fHost.uiName      = NULL;
     fHost.uiParentId  = 0;
@@ -201,16 +207,27 @@ CarlaInstrument::~CarlaInstrument()
         fHost.uiName = NULL;
     }
 
-    if (fHandle == NULL)
-        return;
+    // discard events which never reached play()
+    for (LocklessList<NativeMidiEvent>::Element* e = fMidiQueue.popList(); e != NULL;)
+    {
+        LocklessList<NativeMidiEvent>::Element* const next = e->next;
+        fMidiQueue.free(e);
+        e = next;
+    }
 
-    if (fDescriptor->deactivate != NULL)
-        fDescriptor->deactivate(fHandle);
+    if (fHandle != NULL)
+    {
+        if (fDescriptor->deactivate != NULL)
+            fDescriptor->deactivate(fHandle);
+
+        if (fDescriptor->cleanup != NULL)
+            fDescriptor->cleanup(fHandle);
 
-    if (fDescriptor->cleanup != NULL)
-        fDescriptor->cleanup(fHandle);
+        fHandle = NULL;
+    }
 
-    fHandle = NULL;
+    for (int c = 0; c < DEFAULT_CHANNELS; ++c)
+        MemoryHelper::alignedFree(fAudioBuffers[c]);
 }
 
 // -------------------------------------------------------------------
@@ -307,14 +324,18 @@ void CarlaInstrument::loadSettings(const QDomElement& elem)
     fDescriptor->set_state(fHandle, carlaDoc.toString(0).toUtf8().constData());
 }
 
+static bool midiEventLessThan(const NativeMidiEvent& a, const NativeMidiEvent& b)
+{
+    return a.time < b.time;
+}
+
 void CarlaInstrument::play(sampleFrame* workingBuffer)
 {
     const uint bufsize = Engine::mixer()->framesPerPeriod();
 
-    std::memset(workingBuffer, 0, sizeof(sample_t)*bufsize*DEFAULT_CHANNELS);
-
     if (fHandle == NULL)
     {
+        std::memset(workingBuffer, 0, sizeof(sample_t)*bufsize*DEFAULT_CHANNELS);
         instrumentTrack()->processAudioBuffer(workingBuffer, bufsize, NULL);
         return;
     }
@@ -333,17 +354,26 @@ void CarlaInstrument::play(sampleFrame* workingBuffer)
     fTimeInfo.bbt.ticksPerBeat   = ticksPerBeat;
     fTimeInfo.bbt.beatsPerMinute = s->getTempo();
 
-    float buf1[bufsize];
-    float buf2[bufsize];
-    float* rBuf[] = { buf1, buf2 };
+    // take all queued events, the list has the newest one first
+    uint32_t midiEventCount = 0;
+    for (LocklessList<NativeMidiEvent>::Element* e = fMidiQueue.popList(); e != NULL;)
+    {
+        if (midiEventCount < kMaxMidiEvents)
+            fMidiEvents[midiEventCount++] = e->value;
+
+        LocklessList<NativeMidiEvent>::Element* const next = e->next;
+        fMidiQueue.free(e);
+        e = next;
+    }
+    std::reverse(fMidiEvents, fMidiEvents + midiEventCount);
+    std::stable_sort(fMidiEvents, fMidiEvents + midiEventCount, midiEventLessThan);
+
+    float* const buf1 = fAudioBuffers[0];
+    float* const buf2 = fAudioBuffers[1];
     std::memset(buf1, 0, sizeof(float)*bufsize);
     std::memset(buf2, 0, sizeof(float)*bufsize);
 
-    {
-        const QMutexLocker ml(&fMutex);
-        fDescriptor->process(fHandle, rBuf, rBuf, bufsize, fMidiEvents, fMidiEventCount);
-        fMidiEventCount = 0;
-    }
+    fDescriptor->process(fHandle, fAudioBuffers, fAudioBuffers, bufsize, fMidiEvents, midiEventCount);
 
     for (uint i=0; i < bufsize; ++i)
     {
@@ -356,12 +386,7 @@ void CarlaInstrument::play(sampleFrame* workingBuffer)
 
 bool CarlaInstrument::handleMidiEvent(const MidiEvent& event, const MidiTime&, f_cnt_t offset)
 {
-    const QMutexLocker ml(&fMutex);
-
-    if (fMidiEventCount >= kMaxMidiEvents)
-        return false;
-
-    NativeMidiEvent& nEvent(fMidiEvents[fMidiEventCount++]);
+    NativeMidiEvent nEvent;
     std::memset(&nEvent, 0, sizeof(NativeMidiEvent));
 
     nEvent.port    = 0;
@@ -426,11 +451,13 @@ bool CarlaInstrument::handleMidiEvent(const MidiEvent& event, const MidiTime&, f
 
     default:
         // unhandled
-        --fMidiEventCount;
         break;
     }
 
-    return true;
+    if (nEvent.size == 0)
+        return true;
+
+    return fMidiQueue.push(nEvent);
 }
 
 PluginView* CarlaInstrument::instantiateView(QWidget* parent)
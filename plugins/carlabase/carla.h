@@ -25,8 +25,6 @@
 #ifndef CARLA_H
 #define CARLA_H
 
-#include <QtCore/QMutex>
-
 #define REAL_BUILD // FIXME this shouldn't be needed
 #if CARLA_VERSION_HEX >= 0x010911
     #include "CarlaNativePlugin.h"
@@ -43,6 +41,7 @@
 
 #include "Instrument.h"
 #include "InstrumentView.h"
+#include "LocklessList.h"
 
 class QPushButton;
 
@@ -87,12 +86,13 @@ private:
     NativeHostDescriptor fHost;
     const NativePluginDescriptor* fDescriptor;
 
-    uint32_t        fMidiEventCount;
+    // events are queued by any thread and only taken out by play()
+    LocklessList<NativeMidiEvent> fMidiQueue;
     NativeMidiEvent fMidiEvents[kMaxMidiEvents];
     NativeTimeInfo  fTimeInfo;
 
-    // this is only needed because note-offs are being sent during play
-    QMutex fMutex;
+    // planar, aligned and allocated once, Carla processes them in-place
+    float* fAudioBuffers[DEFAULT_CHANNELS];
 
     friend class CarlaInstrumentView;
 };
@@ -38,6 +38,7 @@
 #include "InstrumentPlayHandle.h"
 #include "InstrumentTrack.h"
 #include "Knob.h"
+#include "lmms_math.h"
 #include "NotePlayHandle.h"
 #include "Oscillator.h"
 #include "PixmapButton.h"
@@ -173,9 +174,9 @@ void lb302FilterIIR2::envRecalc()
 	lb302Filter::envRecalc();
 
 	w = vcf_e0 + vcf_c0;          // e0 is adjusted for Hz and doesn't need ENVINC
-	k = exp(-w/vcf_rescoeff);     // Does this mean c0 is inheritantly?
+	k = fastExpf(-w/vcf_rescoeff); // Does this mean c0 is inheritantly?
 
-	vcf_a = 2.0*cos(2.0*w) * k;
+	vcf_a = 2.0*fastCosf(2.0f*w) * k;
 	vcf_b = -k*k;
 	vcf_c = 1.0 - vcf_a - vcf_b;
 }
@@ -259,12 +260,12 @@ float lb302Filter3Pole::process(const float& samp)
 	float ax1  = lastin;
 	float ay11 = ay1;
 	float ay31 = ay2;
-	lastin  = (samp) - tanh(kres*aout);
+	lastin  = (samp) - fastTanhf(kres*aout);
 	ay1     = kp1h * (lastin+ax1) - kp*ay1;
 	ay2     = kp1h * (ay1 + ay11) - kp*ay2;
 	aout    = kp1h * (ay2 + ay31) - kp*aout;
 
-	return tanh(aout*value)*LB_24_VOL_ADJUST/(1.0+fs->dist);
+	return fastTanhf(aout*value)*LB_24_VOL_ADJUST/(1.0+fs->dist);
 }
 
 
@@ -291,23 +292,13 @@ lb302Synth::lb302Synth( InstrumentTrack * _instrumentTrack ) :
 	connect( Engine::mixer(), SIGNAL( sampleRateChanged( ) ),
 	         this, SLOT ( filterChanged( ) ) );
 
-	connect( &vcf_cut_knob, SIGNAL( dataChanged( ) ),
-	         this, SLOT ( filterChanged( ) ) );
-
-	connect( &vcf_res_knob, SIGNAL( dataChanged( ) ),
-	         this, SLOT ( filterChanged( ) ) );
-
-	connect( &vcf_mod_knob, SIGNAL( dataChanged( ) ),
-	         this, SLOT ( filterChanged( ) ) );
-
-	connect( &vcf_dec_knob, SIGNAL( dataChanged( ) ),
-	         this, SLOT ( filterChanged( ) ) );
-
-	connect( &db24Toggle, SIGNAL( dataChanged( ) ),
-	         this, SLOT ( db24Toggled( ) ) );
-
-	connect( &dist_knob, SIGNAL( dataChanged( ) ),
-	         this, SLOT ( filterChanged( )));
+	// the filter has to follow automation immediately, not at display rate
+	vcf_cut_knob.addValueListener( [this]() { filterChanged(); } );
+	vcf_res_knob.addValueListener( [this]() { filterChanged(); } );
+	vcf_mod_knob.addValueListener( [this]() { filterChanged(); } );
+	vcf_dec_knob.addValueListener( [this]() { filterChanged(); } );
+	db24Toggle.addValueListener( [this]() { db24Toggled(); } );
+	dist_knob.addValueListener( [this]() { filterChanged(); } );
 
 
 	// SYNTH
@@ -465,10 +456,164 @@ inline float GET_INC(float freq) {
 	return freq/Engine::mixer()->processingSampleRate();  // TODO: Use actual sampling rate.
 }
 
-int lb302Synth::process(sampleFrame *outbuf, const int size)
+template<lb302Synth::vco_shape_t SHAPE>
+void lb302Synth::renderVcoShape(float *buf, const int size)
 {
-	const float sampleRatio = 44100.f / Engine::mixer()->processingSampleRate();
+	// locals, the compiler can't keep members in registers across the
+	// stores to buf
+	const float inc = vco_inc;
+	float c = vco_c;
+	float k = vco_k;
 	float w;
+
+	for( int i = 0; i < size; i++ )
+	{
+		// update vco
+		c += inc;
+		
+		if(c > 0.5)
+			c -= 1.0;
+
+		// SHAPE is a constant, the compiler drops all other cases
+		// add vco_shape_param the changes the shape of each curve.
+		// merge sawtooths with triangle and square with round square?
+		switch (SHAPE) {
+			case SAWTOOTH: // p0: curviness of line
+				k = c;  // Is this sawtooth backwards?
+				break;
+
+			case TRIANGLE:  // p0: duty rev.saw<->triangle<->saw p1: curviness
+				k = (c*2.0)+0.5;
+				if (k>0.5)
+					k = 1.0- k;
+				break;
+
+			case SQUARE: // p0: slope of top
+				k = (c<0)?0.5:-0.5;
+				break;
+
+			case ROUND_SQUARE: // p0: width of round
+				k = (c<0)?(sqrtf(1-(c*c*4))-0.5):-0.5;
+				break;
+
+			case MOOG: // Maybe the fall should be exponential/sinsoidal instead of quadric.
+				// [-0.5, 0]: Rise, [0,0.25]: Slope down, [0.25,0.5]: Low
+				k = (c*2.0)+0.5;
+				if (k>1.0) {
+					k = -0.5 ;
+				}
+				else if (k>0.5) {
+					w = 2.0*(k-0.5)-1.0;
+					k = 0.5 - sqrtf(1.0-(w*w));
+				}
+				k *= 2.0;  // MOOG wave gets filtered away
+				break;
+
+			case SINE:
+				// [-0.5, 0.5]  : [-pi, pi]
+				k = 0.5f * Oscillator::sinSample( c );
+				break;
+
+			case EXPONENTIAL:
+				k = 0.5 * Oscillator::expSample( c );
+				break;
+
+			case WHITE_NOISE:
+				k = 0.5 * Oscillator::noiseSample( c );
+				break;
+
+			case BL_SAWTOOTH:
+				k = BandLimitedWave::oscillate( c + 0.5f, BandLimitedWave::pdToLen( inc ), BandLimitedWave::BLSaw ) * 0.5f;
+				break;
+
+			case BL_SQUARE:
+				k = BandLimitedWave::oscillate( c + 0.5f, BandLimitedWave::pdToLen( inc ), BandLimitedWave::BLSquare ) * 0.5f;
+				break;
+
+			case BL_TRIANGLE:
+				k = BandLimitedWave::oscillate( c + 0.5f, BandLimitedWave::pdToLen( inc ), BandLimitedWave::BLTriangle ) * 0.5f;
+				break;
+
+			case BL_MOOG:
+				k = BandLimitedWave::oscillate( c + 0.5f, BandLimitedWave::pdToLen( inc ), BandLimitedWave::BLMoog );
+				break;
+		}
+
+		buf[i] = k;
+	}
+
+	vco_c = c;
+	vco_k = k;
+}
+
+
+
+
+/* Renders the raw oscillator for a period, updating the slide at the same
+ * positions process() updates the filter. The wave shape is looked up once
+ * and every shape has its own loop.
+ */
+void lb302Synth::renderVco(float *buf, const int size)
+{
+	const float sampleRatio = 44100.f / Engine::mixer()->processingSampleRate();
+
+	switch(int(rint(wave_shape.value()))) {
+		case 0: vco_shape = SAWTOOTH; break;
+		case 1: vco_shape = TRIANGLE; break;
+		case 2: vco_shape = SQUARE; break;
+		case 3: vco_shape = ROUND_SQUARE; break;
+		case 4: vco_shape = MOOG; break;
+		case 5: vco_shape = SINE; break;
+		case 6: vco_shape = EXPONENTIAL; break;
+		case 7: vco_shape = WHITE_NOISE; break;
+		case 8: vco_shape = BL_SAWTOOTH; break;
+		case 9: vco_shape = BL_SQUARE; break;
+		case 10: vco_shape = BL_TRIANGLE; break;
+		case 11: vco_shape = BL_MOOG; break;
+		default:  vco_shape = SAWTOOTH; break;
+	}
+
+
+	int envpos = vcf_envpos;
+	for( int i = 0; i < size; )
+	{
+		if(envpos >= ENVINC) {
+			envpos = 0;
+
+			if (vco_slide) {
+					vco_inc = vco_slidebase - vco_slide;
+					// Calculate coeff from dec_knob on knob change.
+					vco_slide -= vco_slide * ( 0.1f - slide_dec_knob.value() * 0.0999f ) * sampleRatio; // TODO: Adjust for ENVINC
+
+			}
+		}
+
+		// vco_inc is constant until the next update
+		const int frames = qMin( size - i, ENVINC - envpos );
+		switch (vco_shape) {
+			case SAWTOOTH: renderVcoShape<SAWTOOTH>( buf + i, frames ); break;
+			case TRIANGLE: renderVcoShape<TRIANGLE>( buf + i, frames ); break;
+			case SQUARE: renderVcoShape<SQUARE>( buf + i, frames ); break;
+			case ROUND_SQUARE: renderVcoShape<ROUND_SQUARE>( buf + i, frames ); break;
+			case MOOG: renderVcoShape<MOOG>( buf + i, frames ); break;
+			case SINE: renderVcoShape<SINE>( buf + i, frames ); break;
+			case EXPONENTIAL: renderVcoShape<EXPONENTIAL>( buf + i, frames ); break;
+			case WHITE_NOISE: renderVcoShape<WHITE_NOISE>( buf + i, frames ); break;
+			case BL_SAWTOOTH: renderVcoShape<BL_SAWTOOTH>( buf + i, frames ); break;
+			case BL_SQUARE: renderVcoShape<BL_SQUARE>( buf + i, frames ); break;
+			case BL_TRIANGLE: renderVcoShape<BL_TRIANGLE>( buf + i, frames ); break;
+			case BL_MOOG: renderVcoShape<BL_MOOG>( buf + i, frames ); break;
+		}
+		i += frames;
+		envpos += frames;
+	}
+}
+
+
+
+
+int lb302Synth::process(sampleFrame *outbuf, const int size)
+{
 	float samp;
 
 	// Hold on to the current VCF, and use it throughout this period
@@ -499,6 +644,11 @@ int lb302Synth::process(sampleFrame *outbuf, const int size)
 	// TODO: NORMAL RELEASE
 	// vca_mode = 1;
 
+	// the oscillator doesn't depend on the filter and envelope, so it is
+	// rendered for the whole period first
+	float vco[size];
+	renderVco( vco, size );
+
 	for( int i=0; i<size; i++ ) 
 	{
 		// start decay if we're past release
@@ -512,13 +662,6 @@ int lb302Synth::process(sampleFrame *outbuf, const int size)
 			filter->envRecalc();
 
 			vcf_envpos = 0;
-
-			if (vco_slide) {
-					vco_inc = vco_slidebase - vco_slide;
-					// Calculate coeff from dec_knob on knob change.
-					vco_slide -= vco_slide * ( 0.1f - slide_dec_knob.value() * 0.0999f ) * sampleRatio; // TODO: Adjust for ENVINC
-
-			}
 		}
 
 
@@ -527,91 +670,7 @@ int lb302Synth::process(sampleFrame *outbuf, const int size)
 
 		//int  decay_frames = 128;
 
-		// update vco
-		vco_c += vco_inc;
-		
-		if(vco_c > 0.5)
-			vco_c -= 1.0;
-
-		switch(int(rint(wave_shape.value()))) {
-			case 0: vco_shape = SAWTOOTH; break;
-			case 1: vco_shape = TRIANGLE; break;
-			case 2: vco_shape = SQUARE; break;
-			case 3: vco_shape = ROUND_SQUARE; break;
-			case 4: vco_shape = MOOG; break;
-			case 5: vco_shape = SINE; break;
-			case 6: vco_shape = EXPONENTIAL; break;
-			case 7: vco_shape = WHITE_NOISE; break;
-			case 8: vco_shape = BL_SAWTOOTH; break;
-			case 9: vco_shape = BL_SQUARE; break;
-			case 10: vco_shape = BL_TRIANGLE; break;
-			case 11: vco_shape = BL_MOOG; break;
-			default:  vco_shape = SAWTOOTH; break;
-		}
-
-		// add vco_shape_param the changes the shape of each curve.
-		// merge sawtooths with triangle and square with round square?
-		switch (vco_shape) {
-			case SAWTOOTH: // p0: curviness of line
-				vco_k = vco_c;  // Is this sawtooth backwards?
-				break;
-
-			case TRIANGLE:  // p0: duty rev.saw<->triangle<->saw p1: curviness
-				vco_k = (vco_c*2.0)+0.5;
-				if (vco_k>0.5)
-					vco_k = 1.0- vco_k;
-				break;
-
-			case SQUARE: // p0: slope of top
-				vco_k = (vco_c<0)?0.5:-0.5;
-				break;
-
-			case ROUND_SQUARE: // p0: width of round
-				vco_k = (vco_c<0)?(sqrtf(1-(vco_c*vco_c*4))-0.5):-0.5;
-				break;
-
-			case MOOG: // Maybe the fall should be exponential/sinsoidal instead of quadric.
-				// [-0.5, 0]: Rise, [0,0.25]: Slope down, [0.25,0.5]: Low
-				vco_k = (vco_c*2.0)+0.5;
-				if (vco_k>1.0) {
-					vco_k = -0.5 ;
-				}
-				else if (vco_k>0.5) {
-					w = 2.0*(vco_k-0.5)-1.0;
-					vco_k = 0.5 - sqrtf(1.0-(w*w));
-				}
-				vco_k *= 2.0;  // MOOG wave gets filtered away
-				break;
-
-			case SINE:
-				// [-0.5, 0.5]  : [-pi, pi]
-				vco_k = 0.5f * Oscillator::sinSample( vco_c );
-				break;
-
-			case EXPONENTIAL:
-				vco_k = 0.5 * Oscillator::expSample( vco_c );
-				break;
-
-			case WHITE_NOISE:
-				vco_k = 0.5 * Oscillator::noiseSample( vco_c );
-				break;
-
-			case BL_SAWTOOTH:
-				vco_k = BandLimitedWave::oscillate( vco_c + 0.5f, BandLimitedWave::pdToLen( vco_inc ), BandLimitedWave::BLSaw ) * 0.5f;
-				break;
-
-			case BL_SQUARE:
-				vco_k = BandLimitedWave::oscillate( vco_c + 0.5f, BandLimitedWave::pdToLen( vco_inc ), BandLimitedWave::BLSquare ) * 0.5f;
-				break;
-
-			case BL_TRIANGLE:
-				vco_k = BandLimitedWave::oscillate( vco_c + 0.5f, BandLimitedWave::pdToLen( vco_inc ), BandLimitedWave::BLTriangle ) * 0.5f;
-				break;
-
-			case BL_MOOG:
-				vco_k = BandLimitedWave::oscillate( vco_c + 0.5f, BandLimitedWave::pdToLen( vco_inc ), BandLimitedWave::BLMoog );
-				break;
-		}
+		vco_k = vco[i];
 
 		//vca_a = 0.5;
 		// Write out samples.
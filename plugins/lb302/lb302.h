@@ -239,6 +239,10 @@ private:
 
 	void recalcFilter();
 
+	void renderVco(float *buf, const int size);
+	template<vco_shape_t SHAPE>
+	void renderVcoShape(float *buf, const int size);
+
 	int process(sampleFrame *outbuf, const int size);
 
 	friend class lb302SynthView;
@@ -107,38 +107,92 @@ MonstroSynth::~MonstroSynth()
 }
 
 
+// adds the modulation by one envelope or LFO to a block
+static inline void addModulation( float * _buf, const float * _mod,
+						float _amount, fpp_t _frames )
+{
+	if( _amount != 0.0f )
+	{
+		for( fpp_t f = 0; f < _frames; ++f )
+		{
+			_buf[f] += _mod[f] * _amount;
+		}
+	}
+}
+
+
+
+
+// multiplies a block by the volume modulation of one envelope or LFO
+static inline void mulModulation( float * _buf, const float * _mod,
+				float _amount, bool _envelope, fpp_t _frames )
+{
+	// positive envelope amounts scale the range of the envelope to
+	// [1 - amount, 1] instead of [0, amount]
+	const float base = _envelope && _amount > 0.0f ? 1.0f - _amount : 1.0f;
+	if( _amount != 0.0f )
+	{
+		for( fpp_t f = 0; f < _frames; ++f )
+		{
+			_buf[f] *= base + _amount * _mod[f];
+		}
+	}
+}
+
+
+
+
 void MonstroSynth::renderOutput( fpp_t _frames, sampleFrame * _buf  )
 {
-	float modtmp; // temp variable for freq modulation
-// macros for modulating with env/lfos
+// macros for modulating with env/lfos, the modulation of every parameter
+// is rendered into a block before the loop over the frames, routes with an
+// amount of zero are left out
+#define rendermod( mod ) \
+		float mod##_buf[ _frames ]; \
+		if( mod##_mod ) \
+		{ \
+			for( f_cnt_t f = 0; f < _frames; ++f ) \
+			{ \
+				mod##_buf[f] = 0.0f; \
+			} \
+			addModulation( mod##_buf, env[0], mod##_e1, _frames ); \
+			addModulation( mod##_buf, env[1], mod##_e2, _frames ); \
+			addModulation( mod##_buf, lfo[0], mod##_l1, _frames ); \
+			addModulation( mod##_buf, lfo[1], mod##_l2, _frames ); \
+		}
+
+#define renderfreqmod( mod ) \
+		rendermod( mod ) \
+		if( mod##_mod ) \
+		{ \
+			fastExp2f( mod##_buf, mod##_buf, _frames ); \
+		}
+
+#define rendervolmod( mod ) \
+		float mod##_buf[ _frames ]; \
+		if( mod##_mod ) \
+		{ \
+			for( f_cnt_t f = 0; f < _frames; ++f ) \
+			{ \
+				mod##_buf[f] = 1.0f; \
+			} \
+			mulModulation( mod##_buf, env[0], mod##_e1, true, _frames ); \
+			mulModulation( mod##_buf, env[1], mod##_e2, true, _frames ); \
+			mulModulation( mod##_buf, lfo[0], mod##_l1, false, _frames ); \
+			mulModulation( mod##_buf, lfo[1], mod##_l2, false, _frames ); \
+		}
+
 #define modulatefreq( car, mod ) \
-		modtmp = 0.0f; \
-		if( mod##_e1 != 0.0f ) modtmp += env[0][f] * mod##_e1; \
-		if( mod##_e2 != 0.0f ) modtmp += env[1][f] * mod##_e2; \
-		if( mod##_l1 != 0.0f ) modtmp += lfo[0][f] * mod##_l1; \
-		if( mod##_l2 != 0.0f ) modtmp += lfo[1][f] * mod##_l2; \
-		car = qBound( MIN_FREQ, car * powf( 2.0f, modtmp ), MAX_FREQ );
+		car = qBound( MIN_FREQ, car * mod##_buf[f], MAX_FREQ );
 
 #define modulateabs( car, mod ) \
-		if( mod##_e1 != 0.0f ) car += env[0][f] * mod##_e1; \
-		if( mod##_e2 != 0.0f ) car += env[1][f] * mod##_e2; \
-		if( mod##_l1 != 0.0f ) car += lfo[0][f] * mod##_l1; \
-		if( mod##_l2 != 0.0f ) car += lfo[1][f] * mod##_l2;
+		car += mod##_buf[f];
 
 #define modulatephs( car, mod ) \
-		if( mod##_e1 != 0.0f ) car += env[0][f] * mod##_e1; \
-		if( mod##_e2 != 0.0f ) car += env[1][f] * mod##_e2; \
-		if( mod##_l1 != 0.0f ) car += lfo[0][f] * mod##_l1; \
-		if( mod##_l2 != 0.0f ) car += lfo[1][f] * mod##_l2;
+		car += mod##_buf[f];
 
 #define modulatevol( car, mod ) \
-		if( mod##_e1 > 0.0f ) car *= ( 1.0f - mod##_e1 + mod##_e1 * env[0][f] ); \
-		if( mod##_e1 < 0.0f ) car *= ( 1.0f + mod##_e1 * env[0][f] );	\
-		if( mod##_e2 > 0.0f ) car *= ( 1.0f - mod##_e2 + mod##_e2 * env[1][f] );	\
-		if( mod##_e2 < 0.0f ) car *= ( 1.0f + mod##_e2 * env[1][f] );	\
-		if( mod##_l1 != 0.0f ) car *= ( 1.0f + mod##_l1 * lfo[0][f] ); \
-		if( mod##_l2 != 0.0f ) car *= ( 1.0f + mod##_l2 * lfo[1][f] ); \
-		car = qBound( -MODCLIP, car, MODCLIP );
+		car = qBound( -MODCLIP, car * mod##_buf[f], MODCLIP );
 
 
 
@@ -346,6 +400,19 @@ void MonstroSynth::renderOutput( fpp_t _frames, sampleFrame * _buf  )
 	// render modulators: envelopes, lfos
 	updateModulators( &env[0][0], &env[1][0], &lfo[0][0], &lfo[1][0], _frames );
 
+	// render the modulation of all parameters
+	renderfreqmod( o1f )
+	rendermod( o1pw )
+	rendermod( o1p )
+	rendervolmod( o1v )
+	renderfreqmod( o2f )
+	rendermod( o2p )
+	rendervolmod( o2v )
+	renderfreqmod( o3f )
+	rendermod( o3p )
+	rendervolmod( o3v )
+	rendermod( o3s )
+
 	// begin for loop
 	for( f_cnt_t f = 0; f < _frames; ++f )
 	{
@@ -956,52 +1023,52 @@ MonstroInstrument::MonstroInstrument( InstrumentTrack * _instrument_track ) :
 
 // updateVolumes
 
-	connect( &m_osc1Vol, SIGNAL( dataChanged() ), this, SLOT( updateVolume1() ) );
-	connect( &m_osc1Pan, SIGNAL( dataChanged() ), this, SLOT( updateVolume1() ) );
-	connect( &m_osc2Vol, SIGNAL( dataChanged() ), this, SLOT( updateVolume2() ) );
-	connect( &m_osc2Pan, SIGNAL( dataChanged() ), this, SLOT( updateVolume2() ) );
-	connect( &m_osc3Vol, SIGNAL( dataChanged() ), this, SLOT( updateVolume3() ) );
-	connect( &m_osc3Pan, SIGNAL( dataChanged() ), this, SLOT( updateVolume3() ) );
+	m_osc1Vol.addValueListener( [this]() { updateVolume1(); } );
+	m_osc1Pan.addValueListener( [this]() { updateVolume1(); } );
+	m_osc2Vol.addValueListener( [this]() { updateVolume2(); } );
+	m_osc2Pan.addValueListener( [this]() { updateVolume2(); } );
+	m_osc3Vol.addValueListener( [this]() { updateVolume3(); } );
+	m_osc3Pan.addValueListener( [this]() { updateVolume3(); } );
 
 // updateFreq
 
-	connect( &m_osc1Crs, SIGNAL( dataChanged() ), this, SLOT( updateFreq1() ) );
-	connect( &m_osc2Crs, SIGNAL( dataChanged() ), this, SLOT( updateFreq2() ) );
-	connect( &m_osc3Crs, SIGNAL( dataChanged() ), this, SLOT( updateFreq3() ) );
+	m_osc1Crs.addValueListener( [this]() { updateFreq1(); } );
+	m_osc2Crs.addValueListener( [this]() { updateFreq2(); } );
+	m_osc3Crs.addValueListener( [this]() { updateFreq3(); } );
 
-	connect( &m_osc1Ftl, SIGNAL( dataChanged() ), this, SLOT( updateFreq1() ) );
-	connect( &m_osc2Ftl, SIGNAL( dataChanged() ), this, SLOT( updateFreq2() ) );
+	m_osc1Ftl.addValueListener( [this]() { updateFreq1(); } );
+	m_osc2Ftl.addValueListener( [this]() { updateFreq2(); } );
 
-	connect( &m_osc1Ftr, SIGNAL( dataChanged() ), this, SLOT( updateFreq1() ) );
-	connect( &m_osc2Ftr, SIGNAL( dataChanged() ), this, SLOT( updateFreq2() ) );
+	m_osc1Ftr.addValueListener( [this]() { updateFreq1(); } );
+	m_osc2Ftr.addValueListener( [this]() { updateFreq2(); } );
 
 // updatePO
-	connect( &m_osc1Spo, SIGNAL( dataChanged() ), this, SLOT( updatePO1() ) );
-	connect( &m_osc2Spo, SIGNAL( dataChanged() ), this, SLOT( updatePO2() ) );
-	connect( &m_osc3Spo, SIGNAL( dataChanged() ), this, SLOT( updatePO3() ) );
+	m_osc1Spo.addValueListener( [this]() { updatePO1(); } );
+	m_osc2Spo.addValueListener( [this]() { updatePO2(); } );
+	m_osc3Spo.addValueListener( [this]() { updatePO3(); } );
 
 // updateEnvelope1
 
-	connect( &m_env1Pre, SIGNAL( dataChanged() ), this, SLOT( updateEnvelope1() ) );
-	connect( &m_env1Att, SIGNAL( dataChanged() ), this, SLOT( updateEnvelope1() ) );
-	connect( &m_env1Hold, SIGNAL( dataChanged() ), this, SLOT( updateEnvelope1() ) );
-	connect( &m_env1Dec, SIGNAL( dataChanged() ), this, SLOT( updateEnvelope1() ) );
-	connect( &m_env1Rel, SIGNAL( dataChanged() ), this, SLOT( updateEnvelope1() ) );
-	connect( &m_env1Slope, SIGNAL( dataChanged() ), this, SLOT( updateSlope1() ) );
+	m_env1Pre.addValueListener( [this]() { updateEnvelope1(); } );
+	m_env1Att.addValueListener( [this]() { updateEnvelope1(); } );
+	m_env1Hold.addValueListener( [this]() { updateEnvelope1(); } );
+	m_env1Dec.addValueListener( [this]() { updateEnvelope1(); } );
+	m_env1Rel.addValueListener( [this]() { updateEnvelope1(); } );
+	m_env1Slope.addValueListener( [this]() { updateSlope1(); } );
 
 // updateEnvelope2
 
-	connect( &m_env2Pre, SIGNAL( dataChanged() ), this, SLOT( updateEnvelope2() ) );
-	connect( &m_env2Att, SIGNAL( dataChanged() ), this, SLOT( updateEnvelope2() ) );
-	connect( &m_env2Hold, SIGNAL( dataChanged() ), this, SLOT( updateEnvelope2() ) );
-	connect( &m_env2Dec, SIGNAL( dataChanged() ), this, SLOT( updateEnvelope2() ) );
-	connect( &m_env2Rel, SIGNAL( dataChanged() ), this, SLOT( updateEnvelope2() ) );
-	connect( &m_env2Slope, SIGNAL( dataChanged() ), this, SLOT( updateSlope2() ) );
+	m_env2Pre.addValueListener( [this]() { updateEnvelope2(); } );
+	m_env2Att.addValueListener( [this]() { updateEnvelope2(); } );
+	m_env2Hold.addValueListener( [this]() { updateEnvelope2(); } );
+	m_env2Dec.addValueListener( [this]() { updateEnvelope2(); } );
+	m_env2Rel.addValueListener( [this]() { updateEnvelope2(); } );
+	m_env2Slope.addValueListener( [this]() { updateSlope2(); } );
 
 // updateLFOAtts
 
-	connect( &m_lfo1Att, SIGNAL( dataChanged() ), this, SLOT( updateLFOAtts() ) );
-	connect( &m_lfo2Att, SIGNAL( dataChanged() ), this, SLOT( updateLFOAtts() ) );
+	m_lfo1Att.addValueListener( [this]() { updateLFOAtts(); } );
+	m_lfo2Att.addValueListener( [this]() { updateLFOAtts(); } );
 
 // updateSampleRate
 
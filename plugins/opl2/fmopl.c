@@ -213,22 +213,9 @@ static INT32 RATE_0[16]= {
 /* lock level of common table */
 static int num_lock = 0;
 
-/* work table */
-static void *cur_chip = NULL;	/* current chip point */
-/* current chip state */
-/* static OPLSAMPLE  *bufL,*bufR; */
-static OPL_CH *S_CH;
-static OPL_CH *E_CH;
-OPL_SLOT *SLOT7_1,*SLOT7_2,*SLOT8_1,*SLOT8_2;
-
-static INT32 outd[1];
-static INT32 ams;
-static INT32 vib;
-INT32  *ams_table;
-INT32  *vib_table;
-static INT32 amsIncr;
-static INT32 vibIncr;
-INT32 feedback2;		/* connect for SLOT 2 */
+/* the state used while updating a chip lives in FM_OPL, so different
+   chips can be updated at the same time. Only creating and destroying
+   chips, which lock the common tables above, has to be serialized. */
 
 /* log output level */
 #define LOG_ERR  3      /* ERROR       */
@@ -341,9 +328,9 @@ INLINE void OPL_KEYOFF(OPL_SLOT *SLOT) {
 /* ---------- calcrate Envelope Generator & Phase Generator ---------- */
 /* return : envelope output */
 #ifdef __clang__
-UINT32 OPL_CALC_SLOT( OPL_SLOT *SLOT ) {
+UINT32 OPL_CALC_SLOT( OPL_SLOT *SLOT, INT32 ams ) {
 #else
-INLINE UINT32 OPL_CALC_SLOT( OPL_SLOT *SLOT ) {
+INLINE UINT32 OPL_CALC_SLOT( OPL_SLOT *SLOT, INT32 ams ) {
 #endif
 	/* calcrate envelope generator */
 	if( (SLOT->evc+=SLOT->evs) >= SLOT->eve ) {
@@ -380,9 +367,9 @@ INLINE UINT32 OPL_CALC_SLOT( OPL_SLOT *SLOT ) {
 }
 
 /* set algorythm connection */
-static void set_algorythm( OPL_CH *CH) {
-	INT32 *carrier = &outd[0];
-	CH->connect1 = CH->CON ? carrier : &feedback2;
+static void set_algorythm( FM_OPL *OPL, OPL_CH *CH) {
+	INT32 *carrier = &OPL->outd[0];
+	CH->connect1 = CH->CON ? carrier : &OPL->feedback2;
 	CH->connect2 = carrier;
 }
 
@@ -497,17 +484,19 @@ INLINE void set_sl_rr(FM_OPL *OPL,int slot,int v) {
 #define OP_OUT(slot,env,con)   slot->wavetable[((slot->Cnt+con)/(0x1000000/SIN_ENT))&(SIN_ENT-1)][env]
 /* ---------- calcrate one of channel ---------- */
 #ifdef __clang__
-void OPL_CALC_CH( OPL_CH *CH ) {
+void OPL_CALC_CH( FM_OPL *OPL, OPL_CH *CH ) {
 #else
-INLINE void OPL_CALC_CH( OPL_CH *CH ) {
+INLINE void OPL_CALC_CH( FM_OPL *OPL, OPL_CH *CH ) {
 #endif
 	UINT32 env_out;
 	OPL_SLOT *SLOT;
+	INT32 ams = OPL->ams;
+	INT32 vib = OPL->vib;
 
-	feedback2 = 0;
+	OPL->feedback2 = 0;
 	/* SLOT 1 */
 	SLOT = &CH->SLOT[SLOT1];
-	env_out=OPL_CALC_SLOT(SLOT);
+	env_out=OPL_CALC_SLOT(SLOT,ams);
 	if( env_out < EG_ENT-1 ) {
 		/* PG */
 		if (SLOT->vib) {
@@ -529,7 +518,7 @@ INLINE void OPL_CALC_CH( OPL_CH *CH ) {
 	}
 	/* SLOT 2 */
 	SLOT = &CH->SLOT[SLOT2];
-	env_out=OPL_CALC_SLOT(SLOT);
+	env_out=OPL_CALC_SLOT(SLOT,ams);
 	if ( env_out < EG_ENT-1 ) {
 		/* PG */
 		if (SLOT->vib) {
@@ -538,29 +527,40 @@ INLINE void OPL_CALC_CH( OPL_CH *CH ) {
 			SLOT->Cnt += SLOT->Incr;
 		}
 		/* connectoion */
-		outd[0] += OP_OUT(SLOT,env_out, feedback2);
+		OPL->outd[0] += OP_OUT(SLOT,env_out, OPL->feedback2);
 	}
 }
 
 /* ---------- calcrate rythm block ---------- */
 #define WHITE_NOISE_db 6.0
 #ifdef __clang__
-void OPL_CALC_RH( OPL_CH *CH ) {
+void OPL_CALC_RH( FM_OPL *OPL, OPL_CH *CH ) {
 #else
-INLINE void OPL_CALC_RH( OPL_CH *CH ) {
+INLINE void OPL_CALC_RH( FM_OPL *OPL, OPL_CH *CH ) {
 #endif
 	UINT32 env_tam,env_sd,env_top,env_hh;
-	int whitenoise = (rand()&1)*(WHITE_NOISE_db/EG_STEP);
+	int whitenoise;
 	INT32 tone8;
+	INT32 ams = OPL->ams;
+	INT32 vib = OPL->vib;
+	OPL_SLOT *SLOT7_1 = &CH[7].SLOT[SLOT1];
+	OPL_SLOT *SLOT7_2 = &CH[7].SLOT[SLOT2];
+	OPL_SLOT *SLOT8_1 = &CH[8].SLOT[SLOT1];
+	OPL_SLOT *SLOT8_2 = &CH[8].SLOT[SLOT2];
 
 	OPL_SLOT *SLOT;
 	int env_out;
 
+	/* white noise from a generator of our own, rand() is shared by all
+	   threads */
+	OPL->noise = OPL->noise * 1103515245 + 12345;
+	whitenoise = ((OPL->noise>>16)&1)*(WHITE_NOISE_db/EG_STEP);
+
 	/* BD : same as FM serial mode and output level is large */
-	feedback2 = 0;
+	OPL->feedback2 = 0;
 	/* SLOT 1 */
 	SLOT = &CH[6].SLOT[SLOT1];
-	env_out=OPL_CALC_SLOT(SLOT);
+	env_out=OPL_CALC_SLOT(SLOT,ams);
 	if ( env_out < EG_ENT-1 ) {
 		/* PG */
 		if (SLOT->vib) {
@@ -572,18 +572,18 @@ INLINE void OPL_CALC_RH( OPL_CH *CH ) {
 		if(CH[6].FB) {
 			int feedback1 = (CH[6].op1_out[0]+CH[6].op1_out[1])>>CH[6].FB;
 			CH[6].op1_out[1] = CH[6].op1_out[0];
-			feedback2 = CH[6].op1_out[0] = OP_OUT(SLOT,env_out,feedback1);
+			OPL->feedback2 = CH[6].op1_out[0] = OP_OUT(SLOT,env_out,feedback1);
 		} else {
-			feedback2 = OP_OUT(SLOT,env_out,0);
+			OPL->feedback2 = OP_OUT(SLOT,env_out,0);
 		}
 	} else {
-		feedback2 = 0;
+		OPL->feedback2 = 0;
 		CH[6].op1_out[1] = CH[6].op1_out[0];
 		CH[6].op1_out[0] = 0;
 	}
 	/* SLOT 2 */
 	SLOT = &CH[6].SLOT[SLOT2];
-	env_out=OPL_CALC_SLOT(SLOT);
+	env_out=OPL_CALC_SLOT(SLOT,ams);
 	if( env_out < EG_ENT-1 ) {
 		/* PG */
 		if (SLOT->vib) {
@@ -592,17 +592,17 @@ INLINE void OPL_CALC_RH( OPL_CH *CH ) {
 			SLOT->Cnt += SLOT->Incr;
 		}
 		/* connectoion */
-		outd[0] += OP_OUT(SLOT,env_out, feedback2)*2;
+		OPL->outd[0] += OP_OUT(SLOT,env_out, OPL->feedback2)*2;
 	}
 
 	/* SD  (17) = mul14[fnum7] + white noise
 	   TAM (15) = mul15[fnum8]
 	   TOP (18) = fnum6(mul18[fnum8]+whitenoise)
 	   HH  (14) = fnum7(mul18[fnum8]+whitenoise) + white noise */
-	env_sd =OPL_CALC_SLOT(SLOT7_2) + whitenoise;
-	env_tam=OPL_CALC_SLOT(SLOT8_1);
-	env_top=OPL_CALC_SLOT(SLOT8_2);
-	env_hh =OPL_CALC_SLOT(SLOT7_1) + whitenoise;
+	env_sd =OPL_CALC_SLOT(SLOT7_2,ams) + whitenoise;
+	env_tam=OPL_CALC_SLOT(SLOT8_1,ams);
+	env_top=OPL_CALC_SLOT(SLOT8_2,ams);
+	env_hh =OPL_CALC_SLOT(SLOT7_1,ams) + whitenoise;
 
 	/* PG */
 	if(SLOT7_1->vib) {
@@ -631,19 +631,19 @@ INLINE void OPL_CALC_RH( OPL_CH *CH ) {
 
 	/* SD */
 	if( env_sd < EG_ENT-1 ) {
-		outd[0] += OP_OUT(SLOT7_1,env_sd, 0)*8;
+		OPL->outd[0] += OP_OUT(SLOT7_1,env_sd, 0)*8;
 	}
 	/* TAM */
 	if( env_tam < EG_ENT-1 ) {
-		outd[0] += OP_OUT(SLOT8_1,env_tam, 0)*2;
+		OPL->outd[0] += OP_OUT(SLOT8_1,env_tam, 0)*2;
 	}
 	/* TOP-CY */
 	if( env_top < EG_ENT-1 ) {
-		outd[0] += OP_OUT(SLOT7_2,env_top,tone8)*2;
+		OPL->outd[0] += OP_OUT(SLOT7_2,env_top,tone8)*2;
 	}
 	/* HH */
 	if( env_hh  < EG_ENT-1 ) {
-		outd[0] += OP_OUT(SLOT7_2,env_hh,tone8)*2;
+		OPL->outd[0] += OP_OUT(SLOT7_2,env_hh,tone8)*2;
 	}
 }
 
@@ -1064,7 +1064,7 @@ static void OPLWriteReg(FM_OPL *OPL, int r, int v) {
 		int feedback = (v>>1)&7;
 		CH->FB   = feedback ? (8+1) - feedback : 0;
 		CH->CON = v&1;
-		set_algorythm(CH);
+		set_algorythm(OPL,CH);
 		//}
 		return;
 	case 0xe0: /* wave type */
@@ -1088,7 +1088,6 @@ static int OPL_LockTable(void) {
 		return 0;
 	}
 	/* first time */
-	cur_chip = NULL;
 	/* allocate total level table (128kb space) */
 	if ( !OPLOpenTable() ) {
 		num_lock--;
@@ -1105,7 +1104,6 @@ static void OPL_UnLockTable(void) {
 		return;
 	}
 	/* last time */
-	cur_chip = NULL;
 	OPLCloseTable();
 }
 
@@ -1124,37 +1122,30 @@ void YM3812UpdateOne(FM_OPL *OPL, INT16 *buffer, int length) {
 	UINT8 rythm = OPL->rythm&0x20;
 	OPL_CH *CH,*R_CH;
 
-	if ( (void *)OPL != cur_chip ) {
-		cur_chip = (void *)OPL;
-		/* channel pointers */
-		S_CH = OPL->P_CH;
-		E_CH = &S_CH[9];
-		/* rythm slot */
-		SLOT7_1 = &S_CH[7].SLOT[SLOT1];
-		SLOT7_2 = &S_CH[7].SLOT[SLOT2];
-		SLOT8_1 = &S_CH[8].SLOT[SLOT1];
-		SLOT8_2 = &S_CH[8].SLOT[SLOT2];
-		/* LFO state */
-		amsIncr = OPL->amsIncr;
-		vibIncr = OPL->vibIncr;
-		ams_table = OPL->ams_table;
-		vib_table = OPL->vib_table;
-	}
+	/* channel pointers */
+	OPL_CH *S_CH = OPL->P_CH;
+	OPL_CH *E_CH = &S_CH[9];
+	/* LFO state */
+	INT32 amsIncr = OPL->amsIncr;
+	INT32 vibIncr = OPL->vibIncr;
+	INT32 *ams_table = OPL->ams_table;
+	INT32 *vib_table = OPL->vib_table;
+
 	R_CH = rythm ? &S_CH[6] : E_CH;
     for ( i=0; i < length ; i++ ) {
 		/*            channel A         channel B         channel C      */
 		/* LFO */
-		ams = ams_table[(amsCnt+=amsIncr)>>AMS_SHIFT];
-		vib = vib_table[(vibCnt+=vibIncr)>>VIB_SHIFT];
-		outd[0] = 0;
+		OPL->ams = ams_table[(amsCnt+=amsIncr)>>AMS_SHIFT];
+		OPL->vib = vib_table[(vibCnt+=vibIncr)>>VIB_SHIFT];
+		OPL->outd[0] = 0;
 		/* FM part */
 		for(CH=S_CH ; CH < R_CH ; CH++)
-			OPL_CALC_CH(CH);
+			OPL_CALC_CH(OPL,CH);
 		/* Rythn part */
 		if(rythm)
-			OPL_CALC_RH(S_CH);
+			OPL_CALC_RH(OPL,S_CH);
 		/* limit check */
-		data = Limit( outd[0] , OPL_MAXOUT, OPL_MINOUT );
+		data = Limit( OPL->outd[0] , OPL_MAXOUT, OPL_MINOUT );
 		/* store to sound buffer */
 		buf[i] = data >> OPL_OUTSB;
 	}
@@ -1189,43 +1180,36 @@ void Y8950UpdateOne(FM_OPL *OPL, INT16 *buffer, int length) {
 	/* setup DELTA-T unit */
 	YM_DELTAT_DECODE_PRESET(DELTAT);
 
-	if ( (void *)OPL != cur_chip ) {
-		cur_chip = (void *)OPL;
-		/* channel pointers */
-		S_CH = OPL->P_CH;
-		E_CH = &S_CH[9];
-		/* rythm slot */
-		SLOT7_1 = &S_CH[7].SLOT[SLOT1];
-		SLOT7_2 = &S_CH[7].SLOT[SLOT2];
-		SLOT8_1 = &S_CH[8].SLOT[SLOT1];
-		SLOT8_2 = &S_CH[8].SLOT[SLOT2];
-		/* LFO state */
-		amsIncr = OPL->amsIncr;
-		vibIncr = OPL->vibIncr;
-		ams_table = OPL->ams_table;
-		vib_table = OPL->vib_table;
-	}
+	/* channel pointers */
+	OPL_CH *S_CH = OPL->P_CH;
+	OPL_CH *E_CH = &S_CH[9];
+	/* LFO state */
+	INT32 amsIncr = OPL->amsIncr;
+	INT32 vibIncr = OPL->vibIncr;
+	INT32 *ams_table = OPL->ams_table;
+	INT32 *vib_table = OPL->vib_table;
+
 	R_CH = rythm ? &S_CH[6] : E_CH;
     for ( i=0; i < length ; i++ ) {
 		/*            channel A         channel B         channel C      */
 		/* LFO */
-		ams = ams_table[(amsCnt+=amsIncr)>>AMS_SHIFT];
-		vib = vib_table[(vibCnt+=vibIncr)>>VIB_SHIFT];
-		outd[0] = 0;
+		OPL->ams = ams_table[(amsCnt+=amsIncr)>>AMS_SHIFT];
+		OPL->vib = vib_table[(vibCnt+=vibIncr)>>VIB_SHIFT];
+		OPL->outd[0] = 0;
 		/* deltaT ADPCM */
 		if( DELTAT->portstate ) {
 			YM_DELTAT_ADPCM_CALC(DELTAT);
 		}
 		/* FM part */
 		for ( CH=S_CH ; CH < R_CH ; CH++ ) {
-			OPL_CALC_CH(CH);
+			OPL_CALC_CH(OPL,CH);
 		}
 		/* Rythn part */
 		if ( rythm ) {
-			OPL_CALC_RH(S_CH);
+			OPL_CALC_RH(OPL,S_CH);
 		}
 		/* limit check */
-		data = Limit( outd[0] , OPL_MAXOUT, OPL_MINOUT );
+		data = Limit( OPL->outd[0] , OPL_MAXOUT, OPL_MINOUT );
 		/* store to sound buffer */
 		buf[i] = data >> OPL_OUTSB;
 	}
@@ -1272,7 +1256,7 @@ void OPLResetChip(FM_OPL *OPL) {
 		YM_DELTAT *DELTAT = OPL->deltat;
 
 		DELTAT->freqbase = OPL->freqbase;
-		DELTAT->output_pointer = outd;
+		DELTAT->output_pointer = OPL->outd;
 		DELTAT->portshift = 5;
 		DELTAT->output_range = DELTAT_MIXING_LEVEL<<TL_BITS;
 		YM_DELTAT_ADPCM_Reset(DELTAT,0);
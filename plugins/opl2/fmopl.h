@@ -138,6 +138,12 @@ typedef struct fm_opl_f {
 	INT32 vibIncr;
 	/* wave selector enable flag */
 	UINT8 wavesel;
+	/* update state */
+	INT32 outd[1];		/* output of the current sample      */
+	INT32 feedback2;	/* connect for SLOT 2                */
+	INT32 ams;			/* current ams level                 */
+	INT32 vib;			/* current vibrato step              */
+	UINT32 noise;		/* white noise generator state       */
 	/* external event callback handler */
 	OPL_TIMERHANDLER  TimerHandler;		/* TIMER handler   */
 	int TimerParam;						/* TIMER parameter */
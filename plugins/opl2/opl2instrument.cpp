@@ -84,9 +84,7 @@ Plugin * PLUGIN_EXPORT lmms_plugin_main( Model *, void * _data )
 
 }
 
-// I'd much rather do without a mutex, but it looks like
-// the emulator code isn't really ready for threads
-QMutex opl2instrument::emulatorMutex;
+QMutex opl2instrument::emulatorTablesMutex;
 
 // Weird ordering of voice parameters
 const unsigned int adlib_opadd[OPL2_VOICES] = {0x00, 0x01, 0x02, 0x08, 0x09, 0x0A, 0x10, 0x11, 0x12};
@@ -135,13 +133,7 @@ opl2instrument::opl2instrument( InstrumentTrack * _instrument_track ) :
 	trem_depth_mdl(false, this, tr( "Tremolo Depth" )   )
 {
 
-	// Create an emulator - samplerate, 16 bit, mono
-	emulatorMutex.lock();
-	theEmulator = new CTemuopl(Engine::mixer()->processingSampleRate(), true, false);
-	theEmulator->init();
-	// Enable waveform selection
-	theEmulator->write(0x01,0x20);
-	emulatorMutex.unlock();
+	createEmulator();
 
 	//Initialize voice values
 	// voiceNote[0] = 0;
@@ -170,8 +162,9 @@ opl2instrument::opl2instrument( InstrumentTrack * _instrument_track ) :
 		 this, SLOT( reloadEmulator() ) );
 	// Connect knobs
 	// This one's for testing...
-	connect( &m_patchModel, SIGNAL( dataChanged() ), this, SLOT( loadGMPatch() ) );
-#define MOD_CON( model ) connect( &model, SIGNAL( dataChanged() ), this, SLOT( updatePatch() ) );
+	// the emulator has to follow automation right in the rendering thread
+	m_patchModel.addValueListener( [this]() { loadGMPatch(); } );
+#define MOD_CON( model ) model.addValueListener( [this]() { updatePatch(); } );
 	MOD_CON( op1_a_mdl );
 	MOD_CON( op1_d_mdl );
 	MOD_CON( op1_s_mdl );
@@ -217,28 +210,50 @@ opl2instrument::opl2instrument( InstrumentTrack * _instrument_track ) :
 }
 
 opl2instrument::~opl2instrument() {
-	delete theEmulator;
 	Engine::mixer()->removePlayHandlesOfTypes( instrumentTrack(),
 				PlayHandle::TypeNotePlayHandle
 				| PlayHandle::TypeInstrumentPlayHandle );
+	destroyEmulator();
 	delete [] renderbuffer;
 }
 
-// Samplerate changes when choosing oversampling, so this is more or less mandatory
-void opl2instrument::reloadEmulator() {
-	delete theEmulator;
-	emulatorMutex.lock();
+// Create an emulator - samplerate, 16 bit, mono
+void opl2instrument::createEmulator() {
+	emulatorTablesMutex.lock();
 	theEmulator = new CTemuopl(Engine::mixer()->processingSampleRate(), true, false);
+	emulatorTablesMutex.unlock();
 	theEmulator->init();
+	// Enable waveform selection
 	theEmulator->write(0x01,0x20);
-	emulatorMutex.unlock();
+}
+
+void opl2instrument::destroyEmulator() {
+	emulatorTablesMutex.lock();
+	delete theEmulator;
+	emulatorTablesMutex.unlock();
+}
+
+// Samplerate changes when choosing oversampling, so this is more or less mandatory
+void opl2instrument::reloadEmulator() {
+	emulatorMutex.lock();
+	destroyEmulator();
+	createEmulator();
+	// writes queued for the old emulator don't match the voices anymore
+	registerWrites.clear();
 	for(int i=0; i<OPL2_VOICES; ++i) {
 		voiceNote[i] = OPL2_VOICE_FREE;
 		voiceLRU[i] = i;
 	}
+	emulatorMutex.unlock();
 	updatePatch();
 }
 
+// This shall only be called with emulatorMutex held
+void opl2instrument::writeRegister(int reg, int val) {
+	registerWrites.push_back(reg);
+	registerWrites.push_back(val);
+}
+
 // This shall only be called from code protected by the holy Mutex!
 void opl2instrument::setVoiceVelocity(int voice, int vel) {
 	int vel_adjusted;
@@ -249,14 +264,14 @@ void opl2instrument::setVoiceVelocity(int voice, int vel) {
 	} else {
 		vel_adjusted = 63 - op1_lvl_mdl.value();
 	}
-	theEmulator->write(0x40+adlib_opadd[voice],
+	writeRegister(0x40+adlib_opadd[voice],
 			   ( (int)op1_scale_mdl.value() & 0x03 << 6) +
 			   ( vel_adjusted & 0x3f ) );
 
 
 	vel_adjusted = 63 - ( op2_lvl_mdl.value() * vel/127.0 );
 	// vel_adjusted = 63 - op2_lvl_mdl.value();
-	theEmulator->write(0x43+adlib_opadd[voice],
+	writeRegister(0x43+adlib_opadd[voice],
 			   ( (int)op2_scale_mdl.value() & 0x03 << 6) +
 			   ( vel_adjusted & 0x3f ) );
 }
@@ -306,8 +321,8 @@ bool opl2instrument::handleMidiEvent( const MidiEvent& event, const MidiTime& ti
 		if( voice != OPL2_NO_VOICE ) {
 			// Turn voice on, NB! the frequencies are straight by voice number,
 			// not by the adlib_opadd table!
-			theEmulator->write(0xA0+voice, fnums[key] & 0xff);
-			theEmulator->write(0xB0+voice, 32 + ((fnums[key] & 0x1f00) >> 8) );
+			writeRegister(0xA0+voice, fnums[key] & 0xff);
+			writeRegister(0xB0+voice, 32 + ((fnums[key] & 0x1f00) >> 8) );
 			setVoiceVelocity(voice, vel);
 			voiceNote[voice] = key;
 			velocities[key] = vel;
@@ -317,8 +332,8 @@ bool opl2instrument::handleMidiEvent( const MidiEvent& event, const MidiTime& ti
                 key = event.key() +12;
                 for(voice=0; voice<OPL2_VOICES; ++voice) {
                         if( voiceNote[voice] == key ) {
-                                theEmulator->write(0xA0+voice, fnums[key] & 0xff);
-                                theEmulator->write(0xB0+voice, (fnums[key] & 0x1f00) >> 8 );
+                                writeRegister(0xA0+voice, fnums[key] & 0xff);
+                                writeRegister(0xB0+voice, (fnums[key] & 0x1f00) >> 8 );
                                 voiceNote[voice] |= OPL2_VOICE_FREE;
 				pushVoice(voice);
                         }
@@ -351,8 +366,8 @@ bool opl2instrument::handleMidiEvent( const MidiEvent& event, const MidiTime& ti
 		for( int v=0; v<OPL2_VOICES; ++v ) {
 			int vn = (voiceNote[v] & ~OPL2_VOICE_FREE); // remove the flag bit
 			int playing = (voiceNote[v] & OPL2_VOICE_FREE) == 0; // just the flag bit
-			theEmulator->write(0xA0+v, fnums[vn] & 0xff);
-			theEmulator->write(0xB0+v, (playing ? 32 : 0) + ((fnums[vn] & 0x1f00) >> 8) );
+			writeRegister(0xA0+v, fnums[vn] & 0xff);
+			writeRegister(0xB0+v, (playing ? 32 : 0) + ((fnums[vn] & 0x1f00) >> 8) );
                 }
                 break;
 	case MidiControlChange:
@@ -399,7 +414,12 @@ PluginView * opl2instrument::instantiateView( QWidget * _parent )
 void opl2instrument::play( sampleFrame * _working_buffer )
 {
 	emulatorMutex.lock();
+	for( int i = 0; i < registerWrites.size(); i += 2 ) {
+		theEmulator->write(registerWrites[i], registerWrites[i+1]);
+	}
+	registerWrites.clear();
 	theEmulator->update(renderbuffer, frameCount);
+	emulatorMutex.unlock();
 
 	for( fpp_t frame = 0; frame < frameCount; ++frame )
         {
@@ -409,7 +429,6 @@ void opl2instrument::play( sampleFrame * _working_buffer )
                         _working_buffer[frame][ch] = s;
                 }
 	}
-	emulatorMutex.unlock();
 
 	// Throw the data to the track...
 	instrumentTrack()->processAudioBuffer( _working_buffer, frameCount, NULL );
@@ -490,17 +509,17 @@ void opl2instrument::loadSettings( const QDomElement & _this )
 void opl2instrument::loadPatch(const unsigned char inst[14]) {
 	emulatorMutex.lock();
 	for(int v=0; v<OPL2_VOICES; ++v) {
-		theEmulator->write(0x20+adlib_opadd[v],inst[0]); // op1 AM/VIB/EG/KSR/Multiplier
-		theEmulator->write(0x23+adlib_opadd[v],inst[1]); // op2
+		writeRegister(0x20+adlib_opadd[v],inst[0]); // op1 AM/VIB/EG/KSR/Multiplier
+		writeRegister(0x23+adlib_opadd[v],inst[1]); // op2
 		// theEmulator->write(0x40+adlib_opadd[v],inst[2]); // op1 KSL/Output Level - these are handled by noteon/aftertouch code
 		// theEmulator->write(0x43+adlib_opadd[v],inst[3]); // op2
-		theEmulator->write(0x60+adlib_opadd[v],inst[4]); // op1 A/D
-		theEmulator->write(0x63+adlib_opadd[v],inst[5]); // op2
-		theEmulator->write(0x80+adlib_opadd[v],inst[6]); // op1 S/R
-		theEmulator->write(0x83+adlib_opadd[v],inst[7]); // op2
-		theEmulator->write(0xe0+adlib_opadd[v],inst[8]); // op1 waveform
-		theEmulator->write(0xe3+adlib_opadd[v],inst[9]); // op2
-		theEmulator->write(0xc0+v,inst[10]);             // feedback/algorithm
+		writeRegister(0x60+adlib_opadd[v],inst[4]); // op1 A/D
+		writeRegister(0x63+adlib_opadd[v],inst[5]); // op2
+		writeRegister(0x80+adlib_opadd[v],inst[6]); // op1 S/R
+		writeRegister(0x83+adlib_opadd[v],inst[7]); // op2
+		writeRegister(0xe0+adlib_opadd[v],inst[8]); // op1 waveform
+		writeRegister(0xe3+adlib_opadd[v],inst[9]); // op2
+		writeRegister(0xc0+v,inst[10]);             // feedback/algorithm
 	}
 	emulatorMutex.unlock();
 }
@@ -564,8 +583,9 @@ void opl2instrument::updatePatch() {
 	inst[12] = 0;
 	inst[13] = 0;
 
+	emulatorMutex.lock();
 	// Not part of the per-voice patch info
-	theEmulator->write(0xBD, (trem_depth_mdl.value() ? 128 : 0 ) +
+	writeRegister(0xBD, (trem_depth_mdl.value() ? 128 : 0 ) +
 			   (vib_depth_mdl.value() ? 64 : 0 ));
 
 	// have to do this, as the level knobs might've changed
@@ -574,6 +594,7 @@ void opl2instrument::updatePatch() {
 			setVoiceVelocity(voice, velocities[voiceNote[voice]] );
 		}
 	}
+	emulatorMutex.unlock();
 #ifdef false
 		printf("UPD: %02x %02x %02x %02x %02x -- %02x %02x %02x %02x %02x %02x\n",
 		       inst[0], inst[1], inst[2], inst[3], inst[4],
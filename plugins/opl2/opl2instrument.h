@@ -25,6 +25,9 @@
 #ifndef _OPL2_H
 #define _OPL2_H
 
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
 #include "Instrument.h"
 #include "InstrumentView.h"
 #include "opl.h"
@@ -133,9 +136,21 @@ private:
 	int pushVoice(int v);
 
 	int Hz2fnum(float Hz);
-	static QMutex emulatorMutex;
 	void setVoiceVelocity(int voice, int vel);
 
+	// Emulator instances only share read-only tables, which are set up
+	// by the first and freed by the last instance created
+	static QMutex emulatorTablesMutex;
+	void createEmulator();
+	void destroyEmulator();
+
+	// Guards voice state and the queued register writes
+	QMutex emulatorMutex;
+	// Register, value pairs written to the emulator at the start of the
+	// next period, so only the rendering thread touches the emulator
+	QVector<int> registerWrites;
+	void writeRegister(int reg, int val);
+
 	// Pitch bend range comes through RPNs.
 	int RPNcoarse, RPNfine;
 };
@@ -91,16 +91,12 @@ organicInstrument::organicInstrument( InstrumentTrack * _instrument_track ) :
 		m_osc[i]->m_numOscillators = m_numOscillators;
 
 		// Connect events 
-		connect( &m_osc[i]->m_oscModel, SIGNAL( dataChanged() ),
-				m_osc[i], SLOT ( oscButtonChanged() ) );
-		connect( &m_osc[i]->m_harmModel, SIGNAL( dataChanged() ),
-				m_osc[i], SLOT( updateDetuning() ) );
-		connect( &m_osc[i]->m_volModel, SIGNAL( dataChanged() ),
-				m_osc[i], SLOT( updateVolume() ) );
-		connect( &m_osc[i]->m_panModel, SIGNAL( dataChanged() ),
-				m_osc[i], SLOT( updateVolume() ) );
-		connect( &m_osc[i]->m_detuneModel, SIGNAL( dataChanged() ),
-				m_osc[i], SLOT( updateDetuning() ) );
+		OscillatorObject * osc = m_osc[i];
+		osc->m_oscModel.addValueListener( [osc]() { osc->oscButtonChanged(); } );
+		osc->m_harmModel.addValueListener( [osc]() { osc->updateDetuning(); } );
+		osc->m_volModel.addValueListener( [osc]() { osc->updateVolume(); } );
+		osc->m_panModel.addValueListener( [osc]() { osc->updateVolume(); } );
+		osc->m_detuneModel.addValueListener( [osc]() { osc->updateDetuning(); } );
 
 		m_osc[i]->updateVolume();
 
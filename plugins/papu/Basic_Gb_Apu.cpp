@@ -63,6 +63,7 @@ long Basic_Gb_Apu::read_samples( sample_t* out, long count )
 
 void Basic_Gb_Apu::reset()
 {
+	time = 0;
 	apu.reset();
 }
 
@@ -248,7 +248,16 @@ void papuInstrument::playNote( NotePlayHandle * _n,
 
 	if ( tfp == 0 )
 	{
-		Basic_Gb_Apu *papu = new Basic_Gb_Apu();
+		Basic_Gb_Apu *papu = m_voices.acquire();
+		if( papu != NULL )
+		{
+			papu->reset();
+		}
+		else
+		{
+			papu = new Basic_Gb_Apu();
+		}
+		// also clears the buffer of a reused chip
 		papu->set_sample_rate( samplerate );
 
 		// Master sound circuitry power control
@@ -417,7 +426,7 @@ void papuInstrument::playNote( NotePlayHandle * _n,
 
 void papuInstrument::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<Basic_Gb_Apu *>( _n->m_pluginData );
+	m_voices.release( static_cast<Basic_Gb_Apu *>( _n->m_pluginData ) );
 }
 
 
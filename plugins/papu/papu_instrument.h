@@ -31,7 +31,9 @@
 #include "InstrumentView.h"
 #include "Knob.h"
 #include "Graph.h"
+#include "VoicePool.h"
 
+class Basic_Gb_Apu;
 class papuInstrumentView;
 class NotePlayHandle;
 class PixmapButton;
@@ -102,6 +104,8 @@ private:
 
 	graphModel  m_graphModel;
 
+	VoicePool<Basic_Gb_Apu> m_voices;
+
 	friend class papuInstrumentView;
 } ;
 
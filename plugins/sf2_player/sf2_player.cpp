@@ -23,6 +23,8 @@
  *
  */
 
+#include <algorithm>
+
 #include <QDebug>
 #include <QLayout>
 #include <QLabel>
@@ -69,11 +71,7 @@ Plugin::Descriptor PLUGIN_EXPORT sf2player_plugin_descriptor =
 struct SF2PluginData
 {
 	int midiNote;
-	int lastPanning;
 	float lastVelocity;
-	fluid_voice_t * fluidVoice;
-	bool isNew;
-	f_cnt_t offset;
 	bool noteOffSent;
 } ;
 
@@ -106,8 +104,15 @@ sf2Instrument::sf2Instrument( InstrumentTrack * _instrument_track ) :
 	m_chorusNum( FLUID_CHORUS_DEFAULT_N, 0, 10.0, 1.0, this, tr( "Chorus Lines" ) ),
 	m_chorusLevel( FLUID_CHORUS_DEFAULT_LEVEL, 0, 10.0, 0.01, this, tr( "Chorus Level" ) ),
 	m_chorusSpeed( FLUID_CHORUS_DEFAULT_SPEED, 0.29, 5.0, 0.01, this, tr( "Chorus Speed" ) ),
-	m_chorusDepth( FLUID_CHORUS_DEFAULT_DEPTH, 0, 46.0, 0.05, this, tr( "Chorus Depth" ) )
+	m_chorusDepth( FLUID_CHORUS_DEFAULT_DEPTH, 0, 46.0, 0.05, this, tr( "Chorus Depth" ) ),
+	m_noteEvents( 1024 ),
+	m_anyMissedNoteOffs( 0 ),
+	m_patchChanged( 0 ),
+	m_resampleBuffer( NULL ),
+	m_resampleBufferSize( 0 )
 {
+	m_pendingEvents.reserve( 1024 );
+
 	for( int i = 0; i < 128; ++i )
 	{
 		m_notesRunning[i] = 0;
@@ -199,7 +204,15 @@ sf2Instrument::~sf2Instrument()
 	{
 		src_delete( m_srcState );
 	}
+	delete[] m_resampleBuffer;
 
+	// discard events of notes which never reached play()
+	for( LocklessList<SF2NoteEvent>::Element * e = m_noteEvents.popList(); e; )
+	{
+		LocklessList<SF2NoteEvent>::Element * next = e->next;
+		m_noteEvents.free( e );
+		e = next;
+	}
 }
 
 
@@ -400,11 +413,9 @@ void sf2Instrument::openFile( const QString & _sf2File, bool updateTrackName )
 
 void sf2Instrument::updatePatch()
 {
-	if( m_bankNum.value() >= 0 && m_patchNum.value() >= 0 )
-	{
-		fluid_synth_program_select( m_synth, m_channel, m_fontId,
-				m_bankNum.value(), m_patchNum.value() );
-	}
+	// don't touch the synth while it is rendering, play() does the actual
+	// program change at the start of the next period
+	m_patchChanged.fetchAndStoreOrdered( 1 );
 }
 
 
@@ -555,6 +566,16 @@ void sf2Instrument::updateSampleRate()
 		{
 			qCritical( "error while creating libsamplerate data structure in Sf2Instrument::updateSampleRate()" );
 		}
+
+		// internal rate is lower than processing rate, so a period
+		// always fits
+		const f_cnt_t frames = Engine::mixer()->framesPerPeriod();
+		if( m_resampleBufferSize < frames )
+		{
+			delete[] m_resampleBuffer;
+			m_resampleBuffer = new sampleFrame[frames];
+			m_resampleBufferSize = frames;
+		}
 		m_synthMutex.unlock();
 	}
 	updateReverb();
@@ -596,219 +617,268 @@ void sf2Instrument::playNote( NotePlayHandle * _n, sampleFrame * )
 
 		SF2PluginData * pluginData = new SF2PluginData;
 		pluginData->midiNote = midiNote;
-		pluginData->lastPanning = 0;
 		pluginData->lastVelocity = _n->midiVelocity( baseVelocity );
-		pluginData->fluidVoice = NULL;
-		pluginData->isNew = true;
-		pluginData->offset = _n->offset();
 		pluginData->noteOffSent = false;
 
 		_n->m_pluginData = pluginData;
 
-		// insert the nph to the playing notes vector
-		m_playingNotesMutex.lock();
-		m_playingNotes.append( _n );
-		m_playingNotesMutex.unlock();
+		queueNoteEvent( SF2NoteEvent::NoteOn, pluginData, _n->offset() );
+
+		// released during the same period, so we need a note off as well
+		if( _n->isReleased() && ! pluginData->noteOffSent )
+		{
+			queueNoteEvent( SF2NoteEvent::NoteOff, pluginData,
+						_n->framesBeforeRelease() );
+		}
 	}
 	else if( _n->isReleased() && ! _n->instrumentTrack()->isSustainPedalPressed() ) // note is released during this period
 	{
 		SF2PluginData * pluginData = static_cast<SF2PluginData *>( _n->m_pluginData );
-		pluginData->offset = _n->framesBeforeRelease();
-		pluginData->isNew = false;
-
-		m_playingNotesMutex.lock();
-		m_playingNotes.append( _n );
-		m_playingNotesMutex.unlock();
+		if( ! pluginData->noteOffSent )
+		{
+			queueNoteEvent( SF2NoteEvent::NoteOff, pluginData,
+						_n->framesBeforeRelease() );
+		}
 	}
 }
 
 
-void sf2Instrument::noteOn( SF2PluginData * n )
+
+
+void sf2Instrument::queueNoteEvent( SF2NoteEvent::Types type,
+					SF2PluginData * n, f_cnt_t offset )
 {
-	m_synthMutex.lock();
+	SF2NoteEvent event;
+	event.type = type;
+	event.midiNote = n->midiNote;
+	event.velocity = static_cast<int>( n->lastVelocity );
+	event.offset = offset;
+	if( m_noteEvents.push( event ) )
+	{
+		if( type == SF2NoteEvent::NoteOff )
+		{
+			n->noteOffSent = true;
+		}
+		return;
+	}
 
-	// get list of current voice IDs so we can easily spot the new
-	// voice after the fluid_synth_noteon() call
-	const int poly = fluid_synth_get_polyphony( m_synth );
-	fluid_voice_t * voices[poly];
-	unsigned int id[poly];
-	fluid_synth_get_voicelist( m_synth, voices, poly, -1 );
-	for( int i = 0; i < poly; ++i )
+	// the queue is full
+	if( type == SF2NoteEvent::NoteOn )
 	{
-		id[i] = 0;
+		// the note never sounds, so there's nothing to release either
+		n->noteOffSent = true;
 	}
-	for( int i = 0; i < poly && voices[i]; ++i )
+	else
 	{
-		id[i] = fluid_voice_get_id( voices[i] );
+		// never leave a note hanging, release it a period late
+		m_missedNoteOffs[n->midiNote].fetchAndAddOrdered( 1 );
+		m_anyMissedNoteOffs.fetchAndStoreOrdered( 1 );
+		n->noteOffSent = true;
 	}
+}
 
-	fluid_synth_noteon( m_synth, m_channel, n->midiNote, n->lastVelocity );
 
-	// get new voice and save it
-	fluid_synth_get_voicelist( m_synth, voices, poly, -1 );
-	for( int i = 0; i < poly && voices[i]; ++i )
-	{
-		const unsigned int newID = fluid_voice_get_id( voices[i] );
-		if( id[i] != newID || newID == 0 )
-		{
-			n->fluidVoice = voices[i];
-			break;
-		}
-	}
 
-	m_synthMutex.unlock();
 
-	m_notesRunningMutex.lock();
-	++m_notesRunning[ n->midiNote ];
-	m_notesRunningMutex.unlock();
+void sf2Instrument::noteOn( const SF2NoteEvent & event )
+{
+	fluid_synth_noteon( m_synth, m_channel, event.midiNote, event.velocity );
+	++m_notesRunning[event.midiNote];
 }
 
 
-void sf2Instrument::noteOff( SF2PluginData * n )
-{
-	n->noteOffSent = true;
-	m_notesRunningMutex.lock();
-	const int notes = --m_notesRunning[n->midiNote];
-	m_notesRunningMutex.unlock();
 
+
+void sf2Instrument::noteOff( const SF2NoteEvent & event )
+{
+	const int notes = --m_notesRunning[event.midiNote];
 	if( notes <= 0 )
 	{
-		m_synthMutex.lock();
-		fluid_synth_noteoff( m_synth, m_channel, n->midiNote );
-		m_synthMutex.unlock();
+		fluid_synth_noteoff( m_synth, m_channel, event.midiNote );
 	}
+}
+
+
 
+
+static bool noteEventLessThan( const SF2NoteEvent & a, const SF2NoteEvent & b )
+{
+	return a.offset < b.offset;
 }
 
 
+
+
 void sf2Instrument::play( sampleFrame * _working_buffer )
 {
 	const fpp_t frames = Engine::mixer()->framesPerPeriod();
 
+	// take the missed note offs before the queued events - the note ons
+	// they belong to were queued before they got missed, so they are in
+	// this period's events for sure
+	int missedNoteOffs[128];
+	const bool anyMissedNoteOffs =
+			m_anyMissedNoteOffs.fetchAndStoreOrdered( 0 ) != 0;
+	if( anyMissedNoteOffs )
+	{
+		for( int key = 0; key < 128; ++key )
+		{
+			missedNoteOffs[key] =
+				m_missedNoteOffs[key].fetchAndStoreOrdered( 0 );
+		}
+	}
+
+	// collect events queued since last period - popList() returns them
+	// in reverse order, so insert at the front to restore it
+	m_pendingEvents.clear();
+	for( LocklessList<SF2NoteEvent>::Element * e = m_noteEvents.popList(); e; )
+	{
+		m_pendingEvents.push_back( e->value );
+		LocklessList<SF2NoteEvent>::Element * next = e->next;
+		m_noteEvents.free( e );
+		e = next;
+	}
+	std::reverse( m_pendingEvents.begin(), m_pendingEvents.end() );
+	std::stable_sort( m_pendingEvents.begin(), m_pendingEvents.end(),
+							noteEventLessThan );
+
+	// everything below runs with the synth locked once for the whole
+	// period - it is only contended while the synth gets re-created
+	m_synthMutex.lock();
+
+	if( m_patchChanged.fetchAndStoreOrdered( 0 ) &&
+			m_bankNum.value() >= 0 && m_patchNum.value() >= 0 )
+	{
+		fluid_synth_program_select( m_synth, m_channel, m_fontId,
+				m_bankNum.value(), m_patchNum.value() );
+	}
+
 	// set midi pitch for this period
 	const int currentMidiPitch = instrumentTrack()->midiPitch();
 	if( m_lastMidiPitch != currentMidiPitch )
 	{
 		m_lastMidiPitch = currentMidiPitch;
-		m_synthMutex.lock();
 		fluid_synth_pitch_bend( m_synth, m_channel, m_lastMidiPitch );
-		m_synthMutex.unlock();
-
 	}
 
 	const int currentMidiPitchRange = instrumentTrack()->midiPitchRange();
 	if( m_lastMidiPitchRange != currentMidiPitchRange )
 	{
 		m_lastMidiPitchRange = currentMidiPitchRange;
-		m_synthMutex.lock();
 		fluid_synth_pitch_wheel_sens( m_synth, m_channel, m_lastMidiPitchRange );
-		m_synthMutex.unlock();
-	}
-	// if we have no new noteons/noteoffs, just render a period and call it a day
-	if( m_playingNotes.isEmpty() )
-	{
-		renderFrames( frames, _working_buffer );
-		instrumentTrack()->processAudioBuffer( _working_buffer, frames, NULL );
-		return;
 	}
 
-	// processing loop
-	// go through noteplayhandles in processing order
+	// processing loop: render up to the next event, apply it, repeat
 	f_cnt_t currentFrame = 0;
-
-	while( ! m_playingNotes.isEmpty() )
+	for( std::vector<SF2NoteEvent>::const_iterator it = m_pendingEvents.begin();
+					it != m_pendingEvents.end(); ++it )
 	{
-		// find the note with lowest offset
-		NotePlayHandle * currentNote = m_playingNotes[0];
-		for( int i = 1; i < m_playingNotes.size(); ++i )
+		const f_cnt_t offset = qBound<f_cnt_t>( 0, it->offset, frames );
+		if( offset > currentFrame )
 		{
-			SF2PluginData * currentData = static_cast<SF2PluginData *>( currentNote->m_pluginData );
-			SF2PluginData * iData = static_cast<SF2PluginData *>( m_playingNotes[i]->m_pluginData );
-			if( currentData->offset > iData->offset )
-			{
-				currentNote = m_playingNotes[i];
-			}
+			renderFrames( currentFrame, offset, _working_buffer );
+			currentFrame = offset;
 		}
 
-		// process the current note:
-		// first see if we're synced in frame count
-		SF2PluginData * currentData = static_cast<SF2PluginData *>( currentNote->m_pluginData );
-		if( currentData->offset > currentFrame )
+		if( it->type == SF2NoteEvent::NoteOn )
 		{
-			renderFrames( currentData->offset - currentFrame, _working_buffer + currentFrame );
-			currentFrame = currentData->offset;
+			noteOn( *it );
 		}
-		if( currentData->isNew )
+		else
 		{
-			noteOn( currentData );
-			if( currentNote->isReleased() ) // if the note is released during the same period, we have to process it again for noteoff
-			{
-				currentData->isNew = false;
-				currentData->offset = currentNote->framesBeforeRelease();
-			}
-			else // otherwise remove the handle
-			{
-				m_playingNotesMutex.lock();
-				m_playingNotes.remove( m_playingNotes.indexOf( currentNote ) );
-				m_playingNotesMutex.unlock();
-			}
+			noteOff( *it );
 		}
-		else
+	}
+
+	// release missed note offs after all queued events, so they can't
+	// come before the note ons they belong to
+	if( anyMissedNoteOffs )
+	{
+		SF2NoteEvent missed;
+		missed.type = SF2NoteEvent::NoteOff;
+		missed.velocity = 0;
+		missed.offset = currentFrame;
+		for( int key = 0; key < 128; ++key )
 		{
-			noteOff( currentData );
-			m_playingNotesMutex.lock();
-			m_playingNotes.remove( m_playingNotes.indexOf( currentNote ) );
-			m_playingNotesMutex.unlock();
+			missed.midiNote = key;
+			for( int n = missedNoteOffs[key]; n > 0; --n )
+			{
+				noteOff( missed );
+			}
 		}
 	}
 
 	if( currentFrame < frames )
 	{
-		renderFrames( frames - currentFrame, _working_buffer + currentFrame );
+		renderFrames( currentFrame, frames, _working_buffer );
+	}
+	if( isResampling() )
+	{
+		resampleFrames( frames, _working_buffer );
 	}
+
+	m_synthMutex.unlock();
+
 	instrumentTrack()->processAudioBuffer( _working_buffer, frames, NULL );
 }
 
 
-void sf2Instrument::renderFrames( f_cnt_t frames, sampleFrame * buf )
+
+
+bool sf2Instrument::isResampling() const
 {
-	m_synthMutex.lock();
-	if( m_internalSampleRate < Engine::mixer()->processingSampleRate() &&
-							m_srcState != NULL )
+	return m_internalSampleRate < Engine::mixer()->processingSampleRate() &&
+			m_srcState != NULL &&
+			m_resampleBufferSize >= Engine::mixer()->framesPerPeriod();
+}
+
+
+
+
+void sf2Instrument::renderFrames( f_cnt_t from, f_cnt_t to, sampleFrame * buf )
+{
+	if( isResampling() )
 	{
-		const fpp_t f = frames * m_internalSampleRate / Engine::mixer()->processingSampleRate();
-#ifdef __GNUC__
-		sampleFrame tmp[f];
-#else
-		sampleFrame * tmp = new sampleFrame[f];
-#endif
-		fluid_synth_write_float( m_synth, f, tmp, 0, 2, tmp, 1, 2 );
-
-		SRC_DATA src_data;
-		src_data.data_in = (float *)tmp;
-		src_data.data_out = (float *)buf;
-		src_data.input_frames = f;
-		src_data.output_frames = frames;
-		src_data.src_ratio = (double) frames / f;
-		src_data.end_of_input = 0;
-		int error = src_process( m_srcState, &src_data );
-#ifndef __GNUC__
-		delete[] tmp;
-#endif
-		if( error )
-		{
-			qCritical( "sf2Instrument: error while resampling: %s", src_strerror( error ) );
-		}
-		if( src_data.output_frames_gen > frames )
-		{
-			qCritical( "sf2Instrument: not enough frames: %ld / %d", src_data.output_frames_gen, frames );
-		}
+		// render at internal rate into the resample buffer - computing
+		// the positions from the absolute frame numbers makes the
+		// segments of a period add up exactly
+		const sample_rate_t sr = Engine::mixer()->processingSampleRate();
+		const f_cnt_t start = from * m_internalSampleRate / sr;
+		const f_cnt_t end = to * m_internalSampleRate / sr;
+		fluid_synth_write_float( m_synth, end - start,
+					m_resampleBuffer + start, 0, 2,
+					m_resampleBuffer + start, 1, 2 );
 	}
 	else
 	{
-		fluid_synth_write_float( m_synth, frames, buf, 0, 2, buf, 1, 2 );
+		fluid_synth_write_float( m_synth, to - from,
+					buf + from, 0, 2, buf + from, 1, 2 );
+	}
+}
+
+
+
+
+void sf2Instrument::resampleFrames( fpp_t frames, sampleFrame * buf )
+{
+	const fpp_t f = frames * m_internalSampleRate / Engine::mixer()->processingSampleRate();
+
+	SRC_DATA src_data;
+	src_data.data_in = (float *) m_resampleBuffer;
+	src_data.data_out = (float *) buf;
+	src_data.input_frames = f;
+	src_data.output_frames = frames;
+	src_data.src_ratio = (double) frames / f;
+	src_data.end_of_input = 0;
+	int error = src_process( m_srcState, &src_data );
+	if( error )
+	{
+		qCritical( "sf2Instrument: error while resampling: %s", src_strerror( error ) );
+	}
+	if( src_data.output_frames_gen > frames )
+	{
+		qCritical( "sf2Instrument: not enough frames: %ld / %d", src_data.output_frames_gen, frames );
 	}
-	m_synthMutex.unlock();
 }
 
 
@@ -820,13 +890,7 @@ void sf2Instrument::deleteNotePluginData( NotePlayHandle * _n )
 	if( ! pluginData->noteOffSent ) // if we for some reason haven't noteoffed the note before it gets deleted,
 									// do it here
 	{
-		noteOff( pluginData );
-		m_playingNotesMutex.lock();
-		if( m_playingNotes.indexOf( _n ) >= 0 )
-		{
-			m_playingNotes.remove( m_playingNotes.indexOf( _n ) );
-		}
-		m_playingNotesMutex.unlock();
+		queueNoteEvent( SF2NoteEvent::NoteOff, pluginData, 0 );
 	}
 	delete pluginData;
 }
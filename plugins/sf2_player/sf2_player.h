@@ -29,7 +29,9 @@
 
 #include <QMutex>
 #include <samplerate.h>
+#include <vector>
 
+#include "AtomicInt.h"
 #include "Instrument.h"
 #include "PixmapButton.h"
 #include "InstrumentView.h"
@@ -37,6 +39,7 @@
 #include "LcdSpinBox.h"
 #include "LedCheckbox.h"
 #include "fluidsynthshims.h"
+#include "LocklessList.h"
 #include "MemoryManager.h"
 
 class sf2InstrumentView;
@@ -48,6 +51,22 @@ class QLabel;
 
 struct SF2PluginData;
 
+// note on/off queued by the note play handles and applied to the synth by
+// play() at the right frame
+struct SF2NoteEvent
+{
+	enum Types
+	{
+		NoteOn,
+		NoteOff
+	} ;
+
+	Types type;
+	int midiNote;
+	int velocity;
+	f_cnt_t offset;
+} ;
+
 class sf2Instrument : public Instrument
 {
 	Q_OBJECT
@@ -121,10 +140,8 @@ private:
 	int m_fontId;
 	QString m_filename;
 
-	// Protect the array of active notes
-	QMutex m_notesRunningMutex;
-
-	// Protect synth when we are re-creating it.
+	// Protect synth when we are re-creating it. play() only takes it once
+	// per period.
 	QMutex m_synthMutex;
 	QMutex m_loadMutex;
 
@@ -151,14 +168,35 @@ private:
 	FloatModel m_chorusSpeed;
 	FloatModel m_chorusDepth;
 
-	QVector<NotePlayHandle *> m_playingNotes;
-	QMutex m_playingNotesMutex;
+	// filled without locking by playNote()/deleteNotePluginData() which
+	// may run in any worker thread, drained at the start of play()
+	LocklessList<SF2NoteEvent> m_noteEvents;
+	// only touched by play()
+	std::vector<SF2NoteEvent> m_pendingEvents;
+
+	// note offs which didn't fit into m_noteEvents, per key - play()
+	// releases these keys in the next period, after the queued events
+	AtomicInt m_missedNoteOffs[128];
+	// set whenever m_missedNoteOffs is increased, so play() only looks at
+	// it when there is something to do
+	AtomicInt m_anyMissedNoteOffs;
+
+	// set when bank/patch changed, program change is done by play()
+	AtomicInt m_patchChanged;
+
+	// synth output at internal sample rate, resampled once per period
+	sampleFrame * m_resampleBuffer;
+	f_cnt_t m_resampleBufferSize;
 
 private:
 	void freeFont();
-	void noteOn( SF2PluginData * n );
-	void noteOff( SF2PluginData * n );
-	void renderFrames( f_cnt_t frames, sampleFrame * buf );
+	void queueNoteEvent( SF2NoteEvent::Types type, SF2PluginData * n,
+							f_cnt_t offset );
+	void noteOn( const SF2NoteEvent & event );
+	void noteOff( const SF2NoteEvent & event );
+	bool isResampling() const;
+	void renderFrames( f_cnt_t from, f_cnt_t to, sampleFrame * buf );
+	void resampleFrames( fpp_t frames, sampleFrame * buf );
 
 	friend class sf2InstrumentView;
 
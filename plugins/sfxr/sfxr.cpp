@@ -26,7 +26,9 @@
 #include <cstdlib>
 #include <time.h>
 
-#define rnd(n) (rand()%(n+1))
+#include "lmms_math.h"
+
+#define rnd(n) (fast_rand()%(n+1))
 
 #define PI 3.14159265f
 
@@ -311,7 +311,12 @@ void sidInstrument::playNote( NotePlayHandle * _n,
 
 	if ( tfp == 0 )
 	{
-		cSID *sid = new cSID();
+		cSID *sid = m_voices.acquire();
+		if( sid == NULL )
+		{
+			sid = new cSID();
+		}
+		// a reused chip is reset below like a new one
 		sid->set_sampling_parameters( clockrate, SAMPLE_FAST, samplerate );
 		sid->set_chip_model( MOS8580 );
 		sid->enable_filter( true );
@@ -445,7 +450,7 @@ void sidInstrument::playNote( NotePlayHandle * _n,
 
 void sidInstrument::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<cSID *>( _n->m_pluginData );
+	m_voices.release( static_cast<cSID *>( _n->m_pluginData ) );
 }
 
 
@@ -31,8 +31,10 @@
 #include "Instrument.h"
 #include "InstrumentView.h"
 #include "Knob.h"
+#include "VoicePool.h"
 
 
+class cSID;
 class sidInstrumentView;
 class NotePlayHandle;
 class automatableButtonGroup;
@@ -126,6 +128,8 @@ private:
 
 	IntModel m_chipModel;
 
+	VoicePool<cSID> m_voices;
+
 	friend class sidInstrumentView;
 
 } ;
@@ -34,8 +34,7 @@ stereoEnhancerControls::stereoEnhancerControls( stereoEnhancerEffect * _eff ) :
 		m_effect( _eff ),
 		m_widthModel(0.0f, 0.0f, 180.0f, 1.0f, this, tr( "Width" ) )
 {
-	connect( &m_widthModel, SIGNAL( dataChanged() ),
-			this, SLOT( changeWideCoeff() ) );
+	m_widthModel.addValueListener( [this]() { changeWideCoeff(); } );
 
 	changeWideCoeff();
 }
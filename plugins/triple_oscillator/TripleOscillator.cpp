@@ -96,30 +96,21 @@ OscillatorObject::OscillatorObject( Model * _parent, int _idx ) :
 	m_phaseOffsetLeft( 0.0f ),
 	m_phaseOffsetRight( 0.0f )
 {
-	// Connect knobs with Oscillators' inputs
-	connect( &m_volumeModel, SIGNAL( dataChanged() ),
-					this, SLOT( updateVolume() ) );
-	connect( &m_panModel, SIGNAL( dataChanged() ),
-					this, SLOT( updateVolume() ) );
+	// Connect knobs with Oscillators' inputs - the oscillators read these
+	// values while rendering, so they have to follow automation right in
+	// the rendering thread
+	m_volumeModel.addValueListener( [this]() { updateVolume(); } );
+	m_panModel.addValueListener( [this]() { updateVolume(); } );
 	updateVolume();
 
-	connect( &m_coarseModel, SIGNAL( dataChanged() ),
-				this, SLOT( updateDetuningLeft() ) );
-	connect( &m_coarseModel, SIGNAL( dataChanged() ),
-				this, SLOT( updateDetuningRight() ) );
-	connect( &m_fineLeftModel, SIGNAL( dataChanged() ),
-				this, SLOT( updateDetuningLeft() ) );
-	connect( &m_fineRightModel, SIGNAL( dataChanged() ),
-				this, SLOT( updateDetuningRight() ) );
+	m_coarseModel.addValueListener( [this]() { updateDetuningLeft(); updateDetuningRight(); } );
+	m_fineLeftModel.addValueListener( [this]() { updateDetuningLeft(); } );
+	m_fineRightModel.addValueListener( [this]() { updateDetuningRight(); } );
 	updateDetuningLeft();
 	updateDetuningRight();
 
-	connect( &m_phaseOffsetModel, SIGNAL( dataChanged() ),
-			this, SLOT( updatePhaseOffsetLeft() ) );
-	connect( &m_phaseOffsetModel, SIGNAL( dataChanged() ),
-			this, SLOT( updatePhaseOffsetRight() ) );
-	connect( &m_stereoPhaseDetuningModel, SIGNAL( dataChanged() ),
-			this, SLOT( updatePhaseOffsetLeft() ) );
+	m_phaseOffsetModel.addValueListener( [this]() { updatePhaseOffsetLeft(); updatePhaseOffsetRight(); } );
+	m_stereoPhaseDetuningModel.addValueListener( [this]() { updatePhaseOffsetLeft(); } );
 	updatePhaseOffsetLeft();
 	updatePhaseOffsetRight();
 
@@ -300,69 +291,27 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 {
 	if( _n->totalFramesPlayed() == 0 || _n->m_pluginData == NULL )
 	{
-		Oscillator * oscs_l[NUM_OF_OSCILLATORS];
-		Oscillator * oscs_r[NUM_OF_OSCILLATORS];
-
-		for( int i = NUM_OF_OSCILLATORS - 1; i >= 0; --i )
+		oscPtr * voice = m_voices.acquire();
+		if( voice != NULL )
 		{
-
-			// the last oscs needs no sub-oscs...
-			if( i == NUM_OF_OSCILLATORS - 1 )
-			{
-				oscs_l[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningLeft,
-						m_osc[i]->m_phaseOffsetLeft,
-						m_osc[i]->m_volumeLeft );
-				oscs_r[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningRight,
-						m_osc[i]->m_phaseOffsetRight,
-						m_osc[i]->m_volumeRight );
-			}
-			else
-			{
-				oscs_l[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningLeft,
-						m_osc[i]->m_phaseOffsetLeft,
-						m_osc[i]->m_volumeLeft,
-						oscs_l[i + 1] );
-				oscs_r[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningRight,
-						m_osc[i]->m_phaseOffsetRight,
-						m_osc[i]->m_volumeRight,
-						oscs_r[i + 1] );
-			}
-
-			oscs_l[i]->setUserWave( m_osc[i]->m_sampleBuffer );
-			oscs_r[i]->setUserWave( m_osc[i]->m_sampleBuffer );
-
+			voice->oscLeft->reset();
+			voice->oscRight->reset();
 		}
-
-		_n->m_pluginData = new oscPtr;
-		static_cast<oscPtr *>( _n->m_pluginData )->oscLeft = oscs_l[0];
-		static_cast< oscPtr *>( _n->m_pluginData )->oscRight =
-								oscs_r[0];
+		else
+		{
+			voice = createVoice();
+		}
+		_n->m_pluginData = voice;
 	}
 
-	Oscillator * osc_l = static_cast<oscPtr *>( _n->m_pluginData )->oscLeft;
-	Oscillator * osc_r = static_cast<oscPtr *>( _n->m_pluginData )->oscRight;
+	oscPtr * voice = static_cast<oscPtr *>( _n->m_pluginData );
+	voice->frequency = _n->frequency();
 
 	const fpp_t frames = _n->framesLeftForCurrentPeriod();
 	const f_cnt_t offset = _n->noteOffset();
 
-	osc_l->update( _working_buffer + offset, frames, 0 );
-	osc_r->update( _working_buffer + offset, frames, 1 );
+	voice->oscLeft->update( _working_buffer + offset, frames, 0 );
+	voice->oscRight->update( _working_buffer + offset, frames, 1 );
 
 	applyRelease( _working_buffer, _n );
 
@@ -374,11 +323,71 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 
 void TripleOscillator::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscLeft );
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscRight );
-	delete static_cast<oscPtr *>( _n->m_pluginData );
+	m_voices.release( static_cast<oscPtr *>( _n->m_pluginData ) );
+}
+
+
+
+
+TripleOscillator::oscPtr * TripleOscillator::createVoice()
+{
+	oscPtr * voice = new oscPtr;
+	voice->frequency = 0.0f;
+
+	Oscillator * oscs_l[NUM_OF_OSCILLATORS];
+	Oscillator * oscs_r[NUM_OF_OSCILLATORS];
+
+	for( int i = NUM_OF_OSCILLATORS - 1; i >= 0; --i )
+	{
+
+		// the last oscs needs no sub-oscs...
+		if( i == NUM_OF_OSCILLATORS - 1 )
+		{
+			oscs_l[i] = new Oscillator(
+					&m_osc[i]->m_waveShapeModel,
+					&m_osc[i]->m_modulationAlgoModel,
+					voice->frequency,
+					m_osc[i]->m_detuningLeft,
+					m_osc[i]->m_phaseOffsetLeft,
+					m_osc[i]->m_volumeLeft );
+			oscs_r[i] = new Oscillator(
+					&m_osc[i]->m_waveShapeModel,
+					&m_osc[i]->m_modulationAlgoModel,
+					voice->frequency,
+					m_osc[i]->m_detuningRight,
+					m_osc[i]->m_phaseOffsetRight,
+					m_osc[i]->m_volumeRight );
+		}
+		else
+		{
+			oscs_l[i] = new Oscillator(
+					&m_osc[i]->m_waveShapeModel,
+					&m_osc[i]->m_modulationAlgoModel,
+					voice->frequency,
+					m_osc[i]->m_detuningLeft,
+					m_osc[i]->m_phaseOffsetLeft,
+					m_osc[i]->m_volumeLeft,
+					oscs_l[i + 1] );
+			oscs_r[i] = new Oscillator(
+					&m_osc[i]->m_waveShapeModel,
+					&m_osc[i]->m_modulationAlgoModel,
+					voice->frequency,
+					m_osc[i]->m_detuningRight,
+					m_osc[i]->m_phaseOffsetRight,
+					m_osc[i]->m_volumeRight,
+					oscs_r[i + 1] );
+		}
+
+		// the sample buffers of the oscillator objects live as long as
+		// the instrument, so reused voices keep the right ones
+		oscs_l[i]->setUserWave( m_osc[i]->m_sampleBuffer );
+		oscs_r[i]->setUserWave( m_osc[i]->m_sampleBuffer );
+
+	}
+
+	voice->oscLeft = oscs_l[0];
+	voice->oscRight = oscs_r[0];
+	return voice;
 }
 
 
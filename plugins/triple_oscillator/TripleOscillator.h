@@ -30,6 +30,7 @@
 #include "InstrumentView.h"
 #include "Oscillator.h"
 #include "AutomatableModel.h"
+#include "VoicePool.h"
 
 
 class automatableButtonGroup;
@@ -125,10 +126,23 @@ private:
 	struct oscPtr
 	{
 		MM_OPERATORS
+		~oscPtr()
+		{
+			delete oscLeft;
+			delete oscRight;
+		}
+
 		Oscillator * oscLeft;
 		Oscillator * oscRight;
+		// the oscillators use this instead of the frequency of the
+		// note, so they can be reused for the next one
+		float frequency;
 	} ;
 
+	oscPtr * createVoice();
+
+	VoicePool<oscPtr> m_voices;
+
 
 	friend class TripleOscillatorView;
 
@@ -218,13 +218,8 @@ void vestigeInstrument::loadSettings( const QDomElement & _this )
 				knobFModel[ i ]->setInitValue(LocaleHelper::toFloat(s_dumpValues.at(2)));
 			}
 
-#if QT_VERSION < 0x050000
-			connect( knobFModel[i], SIGNAL( dataChanged( Model * ) ),
-				this, SLOT( setParameter( Model * ) ), Qt::DirectConnection );
-#else
-			connect( knobFModel[i], &FloatModel::dataChanged, this,
-				[this, i]() { setParameter( knobFModel[i] ); }, Qt::DirectConnection);
-#endif
+			knobFModel[i]->addValueListener(
+				[this, i]() { setParameter( knobFModel[i] ); } );
 		}
 	}
 	m_pluginMutex.unlock();
@@ -394,6 +389,14 @@ void vestigeInstrument::play( sampleFrame * _buf )
 
 
 
+f_cnt_t vestigeInstrument::latency() const
+{
+	return m_plugin != NULL ? m_plugin->latency() : 0;
+}
+
+
+
+
 bool vestigeInstrument::handleMidiEvent( const MidiEvent& event, const MidiTime& time, f_cnt_t offset )
 {
 	m_pluginMutex.lock();
@@ -1008,17 +1011,15 @@ manageVestigeInstrumentView::manageVestigeInstrumentView( Instrument * _instrume
 			sprintf( paramStr, "%d", i);
 			m_vi->knobFModel[ i ] = new FloatModel( LocaleHelper::toFloat(s_dumpValues.at(2)),
 				0.0f, 1.0f, 0.01f, castModel<vestigeInstrument>(), tr( paramStr ) );
+
+			// the instrument owns the model, so it also has to follow
+			// automation after this view is gone
+			vestigeInstrument * vi = m_vi;
+			FloatModel * model = m_vi->knobFModel[i];
+			model->addValueListener( [vi, model]() { vi->setParameter( model ); } );
 		}
 
-		FloatModel * model = m_vi->knobFModel[i];
-#if QT_VERSION < 0x050000
-		connect( model, SIGNAL( dataChanged( Model * ) ), this,
-			SLOT( setParameter( Model * ) ), Qt::DirectConnection );
-#else
-		connect( model, &FloatModel::dataChanged, this,
-			[this, model]() { setParameter( model ); }, Qt::DirectConnection);
-#endif
-		vstKnobs[i] ->setModel( model );
+		vstKnobs[i] ->setModel( m_vi->knobFModel[i] );
 	}
 
 	int i = 0;
@@ -1149,17 +1150,6 @@ manageVestigeInstrumentView::~manageVestigeInstrumentView()
 
 
 
-void manageVestigeInstrumentView::setParameter( Model * action )
-{
-	int knobUNID = action->displayName().toInt();
-
-	if ( m_vi->m_plugin != NULL ) {
-		m_vi->m_plugin->setParam( knobUNID, m_vi->knobFModel[knobUNID]->value() );
-	}
-}
-
-
-
 void manageVestigeInstrumentView::dragEnterEvent( QDragEnterEvent * _dee )
 {
 	if( _dee->mimeData()->hasFormat( StringPairDrag::mimeType() ) )
@@ -68,6 +68,8 @@ public:
 		return IsSingleStreamed | IsMidiBased;
 	}
 
+	virtual f_cnt_t latency() const;
+
 	virtual bool handleMidiEvent( const MidiEvent& event, const MidiTime& time, f_cnt_t offset = 0 );
 
 	virtual PluginView * instantiateView( QWidget * _parent );
@@ -109,7 +111,6 @@ public:
 protected slots:
 	void syncPlugin( void );
 	void displayAutomatedOnly( void );
-	void setParameter( Model * action );
 	void closeWindow();
 
 
@@ -64,9 +64,9 @@ public:
 		}
 	}
 	
-	float getStringSample( int _string )
+	void renderString( int _string, sample_t * _dst, fpp_t _frames )
 	{
-		return m_strings[_string]->nextSample();
+		m_strings[_string]->render( _dst, _frames );
 	}
 	
 private:
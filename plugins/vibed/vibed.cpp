@@ -311,18 +311,27 @@ void vibed::playNote( NotePlayHandle * _n, sampleFrame * _working_buffer )
 	{
 		_working_buffer[i][0] = 0.0f;
 		_working_buffer[i][1] = 0.0f;
-		int s = 0;
-		for( int string = 0; string < 9; ++string )
+	}
+
+	// render every string for the whole period and mix it in afterwards
+	sample_t stringBuffer[frames];
+	int s = 0;
+	for( int string = 0; string < 9; ++string )
+	{
+		if( ps->exists( string ) )
 		{
-			if( ps->exists( string ) )
+			ps->renderString( s, stringBuffer, frames );
+
+			// pan: 0 -> left, 1 -> right
+			const float pan = ( m_panKnobs[string]->value() + 1 ) / 2.0f;
+			const float volume = m_volumeKnobs[string]->value();
+			for( fpp_t f = 0; f < frames; ++f )
 			{
-				// pan: 0 -> left, 1 -> right
-				const float pan = ( m_panKnobs[string]->value() + 1 ) / 2.0f;
-				const sample_t sample = ps->getStringSample( s ) * m_volumeKnobs[string]->value() / 100.0f;
-				_working_buffer[i][0] += ( 1.0f - pan ) * sample;
-				_working_buffer[i][1] += pan * sample;
-				s++;
+				const sample_t sample = stringBuffer[f] * volume / 100.0f;
+				_working_buffer[offset + f][0] += ( 1.0f - pan ) * sample;
+				_working_buffer[offset + f][1] += pan * sample;
 			}
+			s++;
 		}
 	}
 
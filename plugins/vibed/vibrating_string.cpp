@@ -41,13 +41,12 @@ vibratingString::vibratingString(	float _pitch,
 					float _string_loss,
 					float _detune,
 					bool _state ) :
-	m_oversample( 2 * _oversample / (int)( _sample_rate /
-				Engine::mixer()->baseSampleRate() ) ),
+	m_oversample( qMax( 2 * _oversample / (int)( _sample_rate /
+				Engine::mixer()->baseSampleRate() ), 1 ) ),
 	m_randomize( _randomize ),
 	m_stringLoss( 1.0f - _string_loss ),
 	m_state( 0.1f )
 {
-	m_outsamp = new sample_t[m_oversample];
 	int string_length;
 	
 	string_length = static_cast<int>( m_oversample * _sample_rate /
@@ -70,19 +69,20 @@ vibratingString::vibratingString(	float _pitch,
 		}
 	}
 	
-	m_toBridge = vibratingString::initDelayLine( string_length, pick );
-	m_fromBridge = vibratingString::initDelayLine( string_length, pick );
+	vibratingString::initDelayLine( &m_toBridge, string_length );
+	vibratingString::initDelayLine( &m_fromBridge, string_length );
 
 	
-	vibratingString::setDelayLine( m_toBridge, pick, 
+	vibratingString::setDelayLine( &m_toBridge, pick, 
 						m_impulse, _len, 0.5f, 
 						_state );
-	vibratingString::setDelayLine( m_fromBridge, pick, 
+	vibratingString::setDelayLine( &m_fromBridge, pick, 
 						m_impulse, _len, 0.5f,
 						_state);
 	
-	m_choice = static_cast<int>( m_oversample * 
-				static_cast<float>( rand() ) / RAND_MAX ); 
+	// fastRandf() may return its range, which isn't a valid choice
+	m_choice = qMin( static_cast<int>( m_oversample *
+				fastRandf( 1.0f ) ), m_oversample - 1 );
 	
 	m_pickupLoc = static_cast<int>( _pickup * string_length );
 }
@@ -90,45 +90,77 @@ vibratingString::vibratingString(	float _pitch,
 
 
 
-vibratingString::delayLine * vibratingString::initDelayLine( int _len,
-								int _pick )
+void vibratingString::render( sample_t * _dst, fpp_t _frames )
 {
-	delayLine * dl = new vibratingString::delayLine[_len];
-	dl->length = _len;
-	if( _len > 0 )
+	// work on local copies, the compiler can't keep members in registers
+	// across the stores to the delay lines
+	sample_t * const fromBridge = m_fromBridge.data;
+	sample_t * const toBridge = m_toBridge.data;
+	const int length = m_fromBridge.length;
+	int fromPos = m_fromBridge.position;
+	int toPos = m_toBridge.position;
+	float state = m_state;
+
+	for( fpp_t frame = 0; frame < _frames; ++frame )
 	{
-		dl->data = new sample_t[_len];
-		float r;
-		float offset = 0.0f;
-		for( int i = 0; i < dl->length; i++ )
+		for( int i = 0; i < m_oversample; ++i )
 		{
-			r = static_cast<float>( rand() ) /
-					RAND_MAX;
-			offset =  ( m_randomize / 2.0f -
-					m_randomize ) * r;
-			dl->data[i] = offset;
+			if( i == m_choice )
+			{
+				// Output at pickup position
+				_dst[frame] = fromBridge[wrap( fromPos + m_pickupLoc,
+								length )] +
+					toBridge[wrap( toPos + m_pickupLoc,
+								length )];
+			}
+
+			// Sample traveling into "bridge"
+			const sample_t ym0 = toBridge[wrap( toPos + 1, length )];
+			// Sample to "nut"
+			const sample_t ypM = fromBridge[wrap( fromPos + length - 2,
+								length )];
+
+			// String state update
+
+			// Decrement position and then update, the bridge is a
+			// one pole lowpass
+			fromPos = fromPos > 0 ? fromPos - 1 : length - 1;
+			state = ( state + ym0 ) * 0.5f;
+			fromBridge[fromPos] = -state * m_stringLoss;
+			// Update and then increment position
+			toBridge[toPos] = -ypM * m_stringLoss;
+			toPos = toPos < length - 1 ? toPos + 1 : 0;
 		}
 	}
-	else
-	{
-		dl->data = NULL;
-	}
 
-	dl->pointer = dl->data;
-	dl->end = dl->data + _len - 1;
-
-	return( dl );
+	m_fromBridge.position = fromPos;
+	m_toBridge.position = toPos;
+	m_state = state;
 }
 
 
 
 
-void vibratingString::freeDelayLine( delayLine * _dl )
+void vibratingString::initDelayLine( delayLine * _dl, int _len )
 {
-	if( _dl )
+	_dl->length = _len;
+	_dl->position = 0;
+	if( _len > 0 )
+	{
+		_dl->data = new sample_t[_len];
+		float r;
+		float offset = 0.0f;
+		for( int i = 0; i < _dl->length; i++ )
+		{
+			r = fastRandf( 1.0f );
+			offset =  ( m_randomize / 2.0f -
+					m_randomize ) * r;
+			_dl->data[i] = offset;
+		}
+	}
+	else
 	{
-		delete[] _dl->data;
-		delete[] _dl;
+		_dl->data = NULL;
 	}
 }
 
@@ -28,6 +28,7 @@
 #include <stdlib.h>
 
 #include "lmms_basics.h"
+#include "lmms_math.h"
 
 class vibratingString
 {
@@ -47,52 +48,29 @@ public:
 	
 	inline ~vibratingString()
 	{
-		delete[] m_outsamp;
 		delete[] m_impulse;
-		vibratingString::freeDelayLine( m_fromBridge );
-		vibratingString::freeDelayLine( m_toBridge );
+		delete[] m_fromBridge.data;
+		delete[] m_toBridge.data;
 	}
 
-	inline sample_t nextSample()
-	{	
-		sample_t ym0;
-		sample_t ypM;
-		for( int i = 0; i < m_oversample; i++)
-		{
-			// Output at pickup position
-			m_outsamp[i] = fromBridgeAccess( m_fromBridge, 
-								m_pickupLoc );
-			m_outsamp[i] += toBridgeAccess( m_toBridge, 
-								m_pickupLoc );
-		
-			// Sample traveling into "bridge"
-			ym0 = toBridgeAccess( m_toBridge, 1 );
-			// Sample to "nut"
-			ypM = fromBridgeAccess( m_fromBridge,
-						m_fromBridge->length - 2 );
-
-			// String state update
-
-			// Decrement pointer and then update
-			fromBridgeUpdate( m_fromBridge, 
-						-bridgeReflection( ym0 ) );
-			// Update and then increment pointer
-			toBridgeUpdate( m_toBridge, -ypM );
-		}
-		return( m_outsamp[m_choice] );
-	}
+	/* render(dst, frames);
+	* Writes the next "frames" samples at the pickup position to "dst".
+	* Of the oversampled string states only the one at "m_choice" is
+	* heard, so the pickup is read for that one only. */
+	void render( sample_t * _dst, fpp_t _frames );
 
 private:
+	/* A circular buffer, "position" is the index of the x = 0 position
+	* of the string. */
 	struct delayLine
 	{
 		sample_t * data;
 		int length;
-		sample_t * pointer;
-		sample_t * end;
+		int position;
 	} ;
 
-	delayLine * m_fromBridge;
-	delayLine * m_toBridge;
+	delayLine m_fromBridge;
+	delayLine m_toBridge;
 	int m_pickupLoc;
 	int m_oversample;
 	float m_randomize;
@@ -101,11 +79,8 @@ private:
 	float * m_impulse;
 	int m_choice;
 	float m_state;
-	
-	sample_t * m_outsamp;
 
-	delayLine * initDelayLine( int _len, int _pick );
-	static void freeDelayLine( delayLine * _dl );
+	void initDelayLine( delayLine * _dl, int _len );
 	void resample( float *_src, f_cnt_t _src_frames, f_cnt_t _dst_frames );
 	
 	/* setDelayLine initializes the string with an impulse at the pick
@@ -125,8 +100,7 @@ private:
 		{
 			for( int i = 0; i < _pick; i++ )
 			{
-				r = static_cast<float>( rand() ) /
-						RAND_MAX;
+				r = fastRandf( 1.0f );
 				offset =  ( m_randomize / 2.0f -
 						m_randomize ) * r;
 				_dl->data[i] = _scale *
@@ -135,8 +109,7 @@ private:
 			}
 			for( int i = _pick; i < _dl->length; i++ )
 			{
-				r = static_cast<float>( rand() ) /
-						RAND_MAX;
+				r = fastRandf( 1.0f );
 				offset =  ( m_randomize / 2.0f -
 						m_randomize ) * r;
 				_dl->data[i] = _scale * 
@@ -149,8 +122,7 @@ private:
 			{
 				for( int i = _pick; i < _dl->length; i++ )
 				{
-					r = static_cast<float>( rand() ) /
-							RAND_MAX;
+					r = fastRandf( 1.0f );
 					offset =  ( m_randomize / 2.0f -
 							m_randomize ) * r;
 					_dl->data[i] = _scale *
@@ -162,8 +134,7 @@ private:
 			{
 				for( int i = 0; i < _len; i++ )
 				{
-					r = static_cast<float>( rand() ) /
-							RAND_MAX;
+					r = fastRandf( 1.0f );
 					offset =  ( m_randomize / 2.0f -
 							m_randomize ) * r;
 					_dl->data[i+_pick] = _scale *
@@ -174,97 +145,43 @@ private:
 		}
 	}
 
-	/* toBridgeUpdate(dl, insamp);
-	* Places "nut-reflected" sample from upper delay-line into
-	* current lower delay-line pointer position (which represents
-	* x = 0 position).  The pointer is then incremented (i.e. the
-	* wave travels one sample to the left), turning the previous
-	* position into an "effective" x = L position for the next
-	* iteration. */
-	inline void toBridgeUpdate( delayLine * _dl, sample_t _insamp )
-	{
-		register sample_t * ptr = _dl->pointer;
-		*ptr = _insamp * m_stringLoss;
-		++ptr;
-		if( ptr > _dl->end )
-		{
-			ptr = _dl->data;
-		}
-		_dl->pointer = ptr;
-	}
-
-	/* fromBridgeUpdate(dl, insamp);
-	* Decrements current upper delay-line pointer position (i.e.
-	* the wave travels one sample to the right), moving it to the
-	* "effective" x = 0 position for the next iteration.  The
-	* "bridge-reflected" sample from lower delay-line is then placed
-	* into this position. */
-	inline void fromBridgeUpdate( delayLine * _dl, 
-							sample_t _insamp )
-	{
-		register sample_t * ptr = _dl->pointer;
-		--ptr;
-		if( ptr < _dl->data )
-		{
-			ptr = _dl->end;
-		}
-		*ptr = _insamp * m_stringLoss;
-		_dl->pointer = ptr;
-	}
-
-	/* dlAccess(dl, position);
-	* Returns sample "position" samples into delay-line's past.
-	* Position "0" points to the most recently inserted sample. */
-	static inline sample_t dlAccess( delayLine * _dl, int _position )
+	/* wrap(position, length);
+	* Maps a position in [-length, 2 * length) into the buffer, which
+	* covers all positions the string accesses. */
+	static inline int wrap( int _position, int _length )
 	{
-		sample_t * outpos = _dl->pointer + _position;
-		while( outpos < _dl->data )
+		if( _position >= _length )
 		{
-			outpos += _dl->length;
+			return( _position - _length );
 		}
-		while( outpos > _dl->end )
+		if( _position < 0 )
 		{
-			outpos -= _dl->length;
+			return( _position + _length );
 		}
-		return( *outpos );
+		return( _position );
 	}
 
 	/*
 	*  Right-going delay line:
 	*  -->---->---->--- 
 	*  x=0
-	*  (pointer)
+	*  (position)
 	*  Left-going delay line:
 	*  --<----<----<--- 
 	*  x=0
-	*  (pointer)
-	*/
-
-	/* fromBridgeAccess(dl, position);
-	* Returns spatial sample at position "position", where position zero
-	* is equal to the current upper delay-line pointer position (x = 0).
-	* In a right-going delay-line, position increases to the right, and
-	* delay increases to the right => left = past and right = future. */
-	static inline sample_t fromBridgeAccess( delayLine * _dl, 
-								int _position )
-	{
-		return( dlAccess( _dl, _position ) );
-	}
-
-	/* toBridgeAccess(dl, position);
-	* Returns spatial sample at position "position", where position zero
-	* is equal to the current lower delay-line pointer position (x = 0).
-	* In a left-going delay-line, position increases to the right, and
-	* delay DEcreases to the right => left = future and right = past. */
-	static inline sample_t toBridgeAccess( delayLine * _dl, int _position )
-	{
-		return( dlAccess( _dl, _position ) );
-	}
-
-	inline sample_t bridgeReflection( sample_t _insamp )
-	{
-		return( m_state = ( m_state + _insamp ) * 0.5 );
-	}
+	*  (position)
+	*
+	* In the right-going (from bridge) delay-line, position increases to
+	* the right, and delay increases to the right => left = past and
+	* right = future. Every step the position is decremented (i.e. the
+	* wave travels one sample to the right) and the "bridge-reflected"
+	* sample is placed there.
+	*
+	* In the left-going (to bridge) delay-line, delay DEcreases to the
+	* right => left = future and right = past. Every step the
+	* "nut-reflected" sample is placed at the position, which is then
+	* incremented (i.e. the wave travels one sample to the left), turning
+	* the previous position into an "effective" x = L position. */
 
 } ;
 
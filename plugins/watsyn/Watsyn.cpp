@@ -275,30 +275,30 @@ WatsynInstrument::WatsynInstrument( InstrumentTrack * _instrument_track ) :
 
 		m_selectedGraph( 0, 0, 3, this, tr( "Selected graph" ) )
 {
-	connect( &a1_vol, SIGNAL( dataChanged() ), this, SLOT( updateVolumes() ) );
-	connect( &a2_vol, SIGNAL( dataChanged() ), this, SLOT( updateVolumes() ) );
-	connect( &b1_vol, SIGNAL( dataChanged() ), this, SLOT( updateVolumes() ) );
-	connect( &b2_vol, SIGNAL( dataChanged() ), this, SLOT( updateVolumes() ) );
-
-	connect( &a1_pan, SIGNAL( dataChanged() ), this, SLOT( updateVolumes() ) );
-	connect( &a2_pan, SIGNAL( dataChanged() ), this, SLOT( updateVolumes() ) );
-	connect( &b1_pan, SIGNAL( dataChanged() ), this, SLOT( updateVolumes() ) );
-	connect( &b2_pan, SIGNAL( dataChanged() ), this, SLOT( updateVolumes() ) );
-
-	connect( &a1_mult, SIGNAL( dataChanged() ), this, SLOT( updateFreqA1() ) );
-	connect( &a2_mult, SIGNAL( dataChanged() ), this, SLOT( updateFreqA2() ) );
-	connect( &b1_mult, SIGNAL( dataChanged() ), this, SLOT( updateFreqB1() ) );
-	connect( &b2_mult, SIGNAL( dataChanged() ), this, SLOT( updateFreqB2() ) );
-
-	connect( &a1_ltune, SIGNAL( dataChanged() ), this, SLOT( updateFreqA1() ) );
-	connect( &a2_ltune, SIGNAL( dataChanged() ), this, SLOT( updateFreqA2() ) );
-	connect( &b1_ltune, SIGNAL( dataChanged() ), this, SLOT( updateFreqB1() ) );
-	connect( &b2_ltune, SIGNAL( dataChanged() ), this, SLOT( updateFreqB2() ) );
-
-	connect( &a1_rtune, SIGNAL( dataChanged() ), this, SLOT( updateFreqA1() ) );
-	connect( &a2_rtune, SIGNAL( dataChanged() ), this, SLOT( updateFreqA2() ) );
-	connect( &b1_rtune, SIGNAL( dataChanged() ), this, SLOT( updateFreqB1() ) );
-	connect( &b2_rtune, SIGNAL( dataChanged() ), this, SLOT( updateFreqB2() ) );
+	a1_vol.addValueListener( [this]() { updateVolumes(); } );
+	a2_vol.addValueListener( [this]() { updateVolumes(); } );
+	b1_vol.addValueListener( [this]() { updateVolumes(); } );
+	b2_vol.addValueListener( [this]() { updateVolumes(); } );
+
+	a1_pan.addValueListener( [this]() { updateVolumes(); } );
+	a2_pan.addValueListener( [this]() { updateVolumes(); } );
+	b1_pan.addValueListener( [this]() { updateVolumes(); } );
+	b2_pan.addValueListener( [this]() { updateVolumes(); } );
+
+	a1_mult.addValueListener( [this]() { updateFreqA1(); } );
+	a2_mult.addValueListener( [this]() { updateFreqA2(); } );
+	b1_mult.addValueListener( [this]() { updateFreqB1(); } );
+	b2_mult.addValueListener( [this]() { updateFreqB2(); } );
+
+	a1_ltune.addValueListener( [this]() { updateFreqA1(); } );
+	a2_ltune.addValueListener( [this]() { updateFreqA2(); } );
+	b1_ltune.addValueListener( [this]() { updateFreqB1(); } );
+	b2_ltune.addValueListener( [this]() { updateFreqB2(); } );
+
+	a1_rtune.addValueListener( [this]() { updateFreqA1(); } );
+	a2_rtune.addValueListener( [this]() { updateFreqA2(); } );
+	b1_rtune.addValueListener( [this]() { updateFreqB1(); } );
+	b2_rtune.addValueListener( [this]() { updateFreqB2(); } );
 	
 	connect( &a1_graph, SIGNAL( samplesChanged( int, int ) ), this, SLOT( updateWaveA1() ) );
 	connect( &a2_graph, SIGNAL( samplesChanged( int, int ) ), this, SLOT( updateWaveA2() ) );
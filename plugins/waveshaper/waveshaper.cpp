@@ -96,6 +96,9 @@ bool waveShaperEffect::processAudioBuffer( sampleFrame * _buf,
 	const float *inputPtr = inputBuffer ? &( inputBuffer->values()[ 0 ] ) : &input;
 	const float *outputPtr = outputBufer ? &( outputBufer->values()[ 0 ] ) : &output;
 
+	// value buffers hold one value per frame at the engine rate
+	const int os = oversampling();
+
 	for( fpp_t f = 0; f < _frames; ++f )
 	{
 		float s[2] = { _buf[f][0], _buf[f][1] };
@@ -144,8 +147,11 @@ bool waveShaperEffect::processAudioBuffer( sampleFrame * _buf,
 		_buf[f][0] = d * _buf[f][0] + w * s[0];
 		_buf[f][1] = d * _buf[f][1] + w * s[1];
 
-		outputPtr += outputInc;
-		inputPtr += inputInc;
+		if( ( f + 1 ) % os == 0 )
+		{
+			outputPtr += outputInc;
+			inputPtr += inputInc;
+		}
 	}
 
 	checkGate( out_sum / _frames );
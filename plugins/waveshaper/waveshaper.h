@@ -41,6 +41,11 @@ public:
 	virtual bool processAudioBuffer( sampleFrame * _buf,
 							const fpp_t _frames );
 
+	virtual bool supportsOversampling() const
+	{
+		return true;
+	}
+
 	virtual EffectControls * controls()
 	{
 		return( &m_wsControls );
@@ -123,20 +123,13 @@ ZynAddSubFxInstrument::ZynAddSubFxInstrument(
 {
 	initPlugin();
 
-	connect( &m_portamentoModel, SIGNAL( dataChanged() ),
-			this, SLOT( updatePortamento() ), Qt::DirectConnection );
-	connect( &m_filterFreqModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateFilterFreq() ), Qt::DirectConnection );
-	connect( &m_filterQModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateFilterQ() ), Qt::DirectConnection );
-	connect( &m_bandwidthModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateBandwidth() ), Qt::DirectConnection );
-	connect( &m_fmGainModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateFmGain() ), Qt::DirectConnection );
-	connect( &m_resCenterFreqModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateResCenterFreq() ), Qt::DirectConnection );
-	connect( &m_resBandwidthModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateResBandwidth() ), Qt::DirectConnection );
+	m_portamentoModel.addValueListener( [this]() { updatePortamento(); } );
+	m_filterFreqModel.addValueListener( [this]() { updateFilterFreq(); } );
+	m_filterQModel.addValueListener( [this]() { updateFilterQ(); } );
+	m_bandwidthModel.addValueListener( [this]() { updateBandwidth(); } );
+	m_fmGainModel.addValueListener( [this]() { updateFmGain(); } );
+	m_resCenterFreqModel.addValueListener( [this]() { updateResCenterFreq(); } );
+	m_resBandwidthModel.addValueListener( [this]() { updateResBandwidth(); } );
 
 	// now we need a play-handle which cares for calling play()
 	InstrumentPlayHandle * iph = new InstrumentPlayHandle( this, _instrumentTrack );
@@ -145,8 +138,9 @@ ZynAddSubFxInstrument::ZynAddSubFxInstrument(
 	connect( Engine::mixer(), SIGNAL( sampleRateChanged() ),
 			this, SLOT( reloadPlugin() ) );
 
-	connect( instrumentTrack()->pitchRangeModel(), SIGNAL( dataChanged() ),
-			this, SLOT( updatePitchRange() ), Qt::DirectConnection );
+	// the track outlives us, so this listener is removed again
+	instrumentTrack()->pitchRangeModel()->addValueListener(
+			[this]() { updatePitchRange(); }, this );
 }
 
 
@@ -154,6 +148,8 @@ ZynAddSubFxInstrument::ZynAddSubFxInstrument(
 
 ZynAddSubFxInstrument::~ZynAddSubFxInstrument()
 {
+	instrumentTrack()->pitchRangeModel()->removeValueListeners( this );
+
 	Engine::mixer()->removePlayHandlesOfTypes( instrumentTrack(),
 				PlayHandle::TypeNotePlayHandle
 				| PlayHandle::TypeInstrumentPlayHandle );
@@ -85,6 +85,11 @@ public:
 		return IsSingleStreamed | IsMidiBased;
 	}
 
+	virtual f_cnt_t latency() const
+	{
+		return m_remotePlugin ? m_remotePlugin->latency() : 0;
+	}
+
 	virtual PluginView * instantiateView( QWidget * _parent );
 
 
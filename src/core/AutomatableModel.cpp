@@ -24,17 +24,24 @@
 
 #include "AutomatableModel.h"
 
+#include <QtCore/QThread>
+
 #include "lmms_math.h"
 
 #include "AutomationPattern.h"
 #include "ControllerConnection.h"
 #include "LocaleHelper.h"
+#include "LocklessList.h"
 #include "Mixer.h"
 #include "ProjectJournal.h"
 
 float AutomatableModel::s_copiedValue = 0;
 long AutomatableModel::s_periodCounter = 0;
 
+// IDs of models changed by other threads, waiting to be announced in the GUI
+// thread - IDs rather than pointers so models can vanish in the meantime
+static LocklessList<jo_id_t> s_pendingNotifications( 4096 );
+
 
 
 AutomatableModel::AutomatableModel( DataType type,
@@ -55,7 +62,8 @@ AutomatableModel::AutomatableModel( DataType type,
 	m_controllerConnection( NULL ),
 	m_valueBuffer( static_cast<int>( Engine::mixer()->framesPerPeriod() ) ),
 	m_lastUpdatedPeriod( -1 ),
-	m_hasSampleExactData( false )
+	m_hasSampleExactData( false ),
+	m_valueListenersMutex( QMutex::Recursive )
 
 {
 	m_value = fittedValue( val );
@@ -240,7 +248,7 @@ void AutomatableModel::setValue( const float value )
 			}
 		}
 		m_valueChanged = true;
-		emit dataChanged();
+		notifyValueChanged();
 	}
 	else
 	{
@@ -252,6 +260,88 @@ void AutomatableModel::setValue( const float value )
 
 
 
+void AutomatableModel::notifyValueChanged()
+{
+	m_valueListenersMutex.lock();
+	for( int i = 0; i < m_valueListeners.size(); ++i )
+	{
+		m_valueListeners.at( i ).listener();
+	}
+	m_valueListenersMutex.unlock();
+
+	if( QThread::currentThread() == thread() )
+	{
+		emit dataChanged();
+		return;
+	}
+
+	// any slot not connected directly would be queued anyway, so don't pay
+	// for emitting on every tick but let sendPendingNotifications() do it
+	// once at display rate
+	if( m_notificationPending.testAndSetOrdered( 0, 1 ) &&
+				!s_pendingNotifications.push( id() ) )
+	{
+		m_notificationPending.fetchAndStoreOrdered( 0 );
+		emit dataChanged();
+	}
+}
+
+
+
+
+void AutomatableModel::addValueListener( const ValueListener & listener,
+							const void * owner )
+{
+	ValueListenerEntry entry;
+	entry.listener = listener;
+	entry.owner = owner;
+
+	QMutexLocker lock( &m_valueListenersMutex );
+	m_valueListeners.push_back( entry );
+}
+
+
+
+
+void AutomatableModel::removeValueListeners( const void * owner )
+{
+	QMutexLocker lock( &m_valueListenersMutex );
+	for( int i = m_valueListeners.size() - 1; i >= 0; --i )
+	{
+		if( m_valueListeners.at( i ).owner == owner )
+		{
+			m_valueListeners.remove( i );
+		}
+	}
+}
+
+
+
+
+void AutomatableModel::sendPendingNotifications()
+{
+	typedef LocklessList<jo_id_t>::Element Element;
+
+	for( Element * e = s_pendingNotifications.popList(); e; )
+	{
+		AutomatableModel * m = dynamic_cast<AutomatableModel *>(
+			Engine::projectJournal()->journallingObject( e->value ) );
+		if( m )
+		{
+			// clear first so changes made while emitting get queued again
+			m->m_notificationPending.fetchAndStoreOrdered( 0 );
+			emit m->dataChanged();
+		}
+
+		Element * next = e->next;
+		s_pendingNotifications.free( e );
+		e = next;
+	}
+}
+
+
+
+
 template<class T> T AutomatableModel::logToLinearScale( T value ) const
 {
 	return castValue<T>( ::logToLinearScale( minValue<float>(), maxValue<float>(), static_cast<float>( value ) ) );
@@ -334,7 +424,7 @@ void AutomatableModel::setAutomatedValue( const float value )
 			}
 		}
 		m_valueChanged = true;
-		emit dataChanged();
+		notifyValueChanged();
 	}
 	--m_setValueDepth;
 }
@@ -478,7 +568,7 @@ void AutomatableModel::setControllerConnection( ControllerConnection* c )
 	if( c )
 	{
 		QObject::connect( m_controllerConnection, SIGNAL( valueChanged() ),
-				this, SIGNAL( dataChanged() ), Qt::DirectConnection );
+				this, SLOT( controllerValueChanged() ), Qt::DirectConnection );
 		QObject::connect( m_controllerConnection, SIGNAL( destroyed() ), this, SLOT( unlinkControllerConnection() ) );
 		m_valueChanged = true;
 		emit dataChanged();
@@ -395,10 +395,13 @@ float AutomationPattern::valueAt( timeMap::const_iterator v, int offset ) const
 		float m1 = (m_tangents[v.key()]) * numValues * m_tension;
 		float m2 = (m_tangents[(v+1).key()]) * numValues * m_tension;
 
-		return ( 2*pow(t,3) - 3*pow(t,2) + 1 ) * v.value()
-				+ ( pow(t,3) - 2*pow(t,2) + t) * m1
-				+ ( -2*pow(t,3) + 3*pow(t,2) ) * (v+1).value()
-				+ ( pow(t,3) - pow(t,2) ) * m2;
+		float t2 = t * t;
+		float t3 = t2 * t;
+
+		return ( 2*t3 - 3*t2 + 1 ) * v.value()
+				+ ( t3 - 2*t2 + t) * m1
+				+ ( -2*t3 + 3*t2 ) * (v+1).value()
+				+ ( t3 - t2 ) * m2;
 	}
 }
 
@@ -23,7 +23,9 @@
  */
 
 #include "Clipboard.h"
+#include "DataFile.h"
 #include "JournallingObject.h"
+#include "SharedSampleData.h"
 
 
 Clipboard::Map Clipboard::content;
@@ -31,9 +33,16 @@ Clipboard::Map Clipboard::content;
 
 void Clipboard::copy( JournallingObject * _obj )
 {
-	QDomDocument doc;
+	DataFile doc( DataFile::ClipboardData );
 	QDomElement parent = doc.createElement( "Clipboard" );
 	_obj->saveState( doc, parent );
+
+	// sample data is only referenced by what it replaces
+	Map::iterator it = content.find( _obj->nodeName() );
+	if( it != content.end() )
+	{
+		SharedSampleData::releaseRetained( it.value() );
+	}
 	content[_obj->nodeName()] = parent.firstChild().toElement();
 }
 
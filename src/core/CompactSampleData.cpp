@@ -0,0 +1,348 @@
+/*
+ * CompactSampleData.cpp - memory saving storage for sample data
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "CompactSampleData.h"
+
+#include <cmath>
+#include <cstring>
+
+
+// number of bits used for storing the width of a group of residuals
+static const int WidthBits = 5;
+
+
+namespace
+{
+
+class BitWriter
+{
+public:
+	BitWriter( QByteArray & _out ) :
+		m_out( _out ),
+		m_acc( 0 ),
+		m_bits( 0 )
+	{
+	}
+
+	void write( quint32 _value, int _width )
+	{
+		m_acc |= (quint64) _value << m_bits;
+		m_bits += _width;
+		while( m_bits >= 8 )
+		{
+			m_out.append( (char)( m_acc & 0xff ) );
+			m_acc >>= 8;
+			m_bits -= 8;
+		}
+	}
+
+	void flush()
+	{
+		if( m_bits > 0 )
+		{
+			m_out.append( (char)( m_acc & 0xff ) );
+		}
+		m_acc = 0;
+		m_bits = 0;
+	}
+
+private:
+	QByteArray & m_out;
+	quint64 m_acc;
+	int m_bits;
+
+} ;
+
+
+
+
+class BitReader
+{
+public:
+	BitReader( const char * _in ) :
+		m_in( reinterpret_cast<const unsigned char *>( _in ) ),
+		m_acc( 0 ),
+		m_bits( 0 )
+	{
+	}
+
+	inline quint32 read( int _width )
+	{
+		while( m_bits < _width )
+		{
+			m_acc |= (quint64) *m_in++ << m_bits;
+			m_bits += 8;
+		}
+		const quint32 value = m_acc & ( ( 1u << _width ) - 1 );
+		m_acc >>= _width;
+		m_bits -= _width;
+		return value;
+	}
+
+private:
+	const unsigned char * m_in;
+	quint64 m_acc;
+	int m_bits;
+
+} ;
+
+}
+
+
+
+
+CompactSampleData::CompactSampleData( const sampleFrame * _data,
+							f_cnt_t _frames ) :
+	m_frames( qMax<f_cnt_t>( _frames, 0 ) ),
+	m_channels( 1 ),
+	m_scale( 1.0f / 32768.0f ),
+	m_cache( NULL ),
+	m_cacheClock( 0 )
+{
+	// 16 bit samples are multiples of 1/32768 if they were converted by
+	// libsndfile and multiples of 1/32767 if they were converted by
+	// SampleDecoder::toStereo() - check whether the data fits one of
+	// these exactly so it comes out unchanged
+	bool sndfileScale = true;
+	bool decoderScale = true;
+	float peak = 0.0f;
+	for( f_cnt_t f = 0; f < m_frames; ++f )
+	{
+		if( _data[f][0] != _data[f][1] )
+		{
+			m_channels = DEFAULT_CHANNELS;
+		}
+		for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+		{
+			const float x = _data[f][ch];
+			peak = qMax( peak, fabsf( x ) );
+			if( sndfileScale )
+			{
+				// scaling by a power of two is exact
+				sndfileScale = x * 32768.0f == rintf( x * 32768.0f );
+			}
+			if( decoderScale )
+			{
+				decoderScale = lrintf( x * 32767.0f ) *
+						( 1.0f / 32767.0f ) == x;
+			}
+		}
+	}
+
+	if( sndfileScale && peak <= 1.0f )
+	{
+		m_scale = 1.0f / 32768.0f;
+	}
+	else if( decoderScale && peak <= 32768.0f / 32767.0f )
+	{
+		m_scale = 1.0f / 32767.0f;
+	}
+	else
+	{
+		// anything else is quantized relative to its peak
+		m_scale = qMax( peak, 1.0f ) / 32768.0f;
+	}
+
+	const int blocks = ( m_frames + BlockFrames - 1 ) / BlockFrames;
+	m_blockOffsets.resize( blocks );
+	for( int b = 0; b < blocks; ++b )
+	{
+		m_blockOffsets[b] = m_stream.size();
+		encodeBlock( _data + b * BlockFrames, blockFrames( b ) );
+	}
+	m_stream.squeeze();
+
+	for( int i = 0; i < CacheBlocks; ++i )
+	{
+		m_cachedBlocks[i] = -1;
+		m_cacheUse[i] = 0;
+	}
+}
+
+
+
+
+CompactSampleData::~CompactSampleData()
+{
+	MM_FREE( m_cache );
+}
+
+
+
+
+void CompactSampleData::read( f_cnt_t _from, f_cnt_t _frames,
+						sampleFrame * _dst ) const
+{
+	if( _from < 0 )
+	{
+		const f_cnt_t silent = qMin( _frames, -_from );
+		memset( _dst, 0, silent * sizeof( sampleFrame ) );
+		_dst += silent;
+		_from += silent;
+		_frames -= silent;
+	}
+	const f_cnt_t inside = qBound<f_cnt_t>( 0, m_frames - _from, _frames );
+	memset( _dst + inside, 0, ( _frames - inside ) * sizeof( sampleFrame ) );
+	_frames = inside;
+
+	while( _frames > 0 )
+	{
+		const int block = _from / BlockFrames;
+		const f_cnt_t offset = _from - block * BlockFrames;
+		const f_cnt_t n = qMin( _frames, blockFrames( block ) - offset );
+
+		if( m_cacheLock.tryLock() )
+		{
+			memcpy( _dst, cachedBlock( block ) + offset,
+						n * sizeof( sampleFrame ) );
+			m_cacheLock.unlock();
+		}
+		else
+		{
+			// don't wait for another thread using the cache
+			sampleFrame * tmp = MM_ALLOC( sampleFrame, BlockFrames );
+			decodeBlock( block, tmp );
+			memcpy( _dst, tmp + offset, n * sizeof( sampleFrame ) );
+			MM_FREE( tmp );
+		}
+
+		_dst += n;
+		_from += n;
+		_frames -= n;
+	}
+}
+
+
+
+
+void CompactSampleData::decodeBlock( int _block, sampleFrame * _dst ) const
+{
+	const f_cnt_t frames = blockFrames( _block );
+	BitReader in( m_stream.constData() + m_blockOffsets[_block] );
+
+	for( ch_cnt_t ch = 0; ch < m_channels; ++ch )
+	{
+		int prev1 = 0;
+		int prev2 = 0;
+		for( f_cnt_t g = 0; g < frames; g += GroupSize )
+		{
+			const int width = in.read( WidthBits );
+			const f_cnt_t end = qMin<f_cnt_t>( g + GroupSize, frames );
+			for( f_cnt_t f = g; f < end; ++f )
+			{
+				const quint32 z = in.read( width );
+				// undo zigzag coding
+				const int residual = ( z >> 1 ) ^ -(int)( z & 1 );
+				const int value = 2 * prev1 - prev2 + residual;
+				_dst[f][ch] = value * m_scale;
+				prev2 = prev1;
+				prev1 = value;
+			}
+		}
+	}
+
+	if( m_channels == 1 )
+	{
+		for( f_cnt_t f = 0; f < frames; ++f )
+		{
+			_dst[f][1] = _dst[f][0];
+		}
+	}
+}
+
+
+
+
+void CompactSampleData::encodeBlock( const sampleFrame * _data,
+							f_cnt_t _frames )
+{
+	BitWriter out( m_stream );
+	quint32 residuals[GroupSize];
+
+	for( ch_cnt_t ch = 0; ch < m_channels; ++ch )
+	{
+		int prev1 = 0;
+		int prev2 = 0;
+		for( f_cnt_t g = 0; g < _frames; g += GroupSize )
+		{
+			const f_cnt_t end = qMin<f_cnt_t>( g + GroupSize, _frames );
+			quint32 bits = 0;
+			for( f_cnt_t f = g; f < end; ++f )
+			{
+				const int value = qBound( -32768, static_cast<int>(
+					lrintf( _data[f][ch] / m_scale ) ), 32768 );
+				const int residual = value - ( 2 * prev1 - prev2 );
+				// zigzag coding maps small negative values to small
+				// positive ones
+				residuals[f - g] = ( (quint32) residual << 1 ) ^
+							( residual >> 31 );
+				bits |= residuals[f - g];
+				prev2 = prev1;
+				prev1 = value;
+			}
+
+			int width = 0;
+			while( bits >> width )
+			{
+				++width;
+			}
+			out.write( width, WidthBits );
+			for( f_cnt_t f = g; f < end; ++f )
+			{
+				out.write( residuals[f - g], width );
+			}
+		}
+	}
+
+	out.flush();
+}
+
+
+
+
+const sampleFrame * CompactSampleData::cachedBlock( int _block ) const
+{
+	if( m_cache == NULL )
+	{
+		m_cache = MM_ALLOC( sampleFrame, CacheBlocks * BlockFrames );
+	}
+
+	int slot = 0;
+	for( int i = 0; i < CacheBlocks; ++i )
+	{
+		if( m_cachedBlocks[i] == _block )
+		{
+			m_cacheUse[i] = ++m_cacheClock;
+			return m_cache + i * BlockFrames;
+		}
+		if( m_cacheUse[i] < m_cacheUse[slot] )
+		{
+			slot = i;
+		}
+	}
+
+	// replace the least recently used block
+	decodeBlock( _block, m_cache + slot * BlockFrames );
+	m_cachedBlocks[slot] = _block;
+	m_cacheUse[slot] = ++m_cacheClock;
+	return m_cache + slot * BlockFrames;
+}
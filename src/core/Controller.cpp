@@ -29,8 +29,10 @@
 #include <QVector>
 
 
+#include "AutomatableModel.h"
 #include "Song.h"
 #include "Mixer.h"
+#include "MixerWorkerThread.h"
 #include "ControllerConnection.h"
 #include "ControllerDialog.h"
 #include "LfoController.h"
@@ -40,6 +42,9 @@
 
 long Controller::s_periods = 0;
 QVector<Controller *> Controller::s_controllers;
+QMutex Controller::s_controllersMutex( QMutex::Recursive );
+bool Controller::s_evaluationOrderDirty = true;
+QVector<ControllerVector> Controller::s_evaluationOrder;
 
 
 
@@ -50,11 +55,18 @@ Controller::Controller( ControllerTypes _type, Model * _parent,
 	m_valueBuffer( Engine::mixer()->framesPerPeriod() ),
 	m_bufferLastUpdated( -1 ),
 	m_connectionCount( 0 ),
-	m_type( _type )
+	m_type( _type ),
+	m_scheduled( false )
 {
-	if( _type != DummyController && _type != MidiController )
+	if( _type != DummyController )
 	{
+		s_controllersMutex.lock();
 		s_controllers.append( this );
+		s_controllersMutex.unlock();
+	}
+
+	if( _type != DummyController && _type != MidiController )
+	{
 		// Determine which name to use
 		for ( uint i=s_controllers.size(); ; i++ )
 		{
@@ -87,11 +99,14 @@ Controller::Controller( ControllerTypes _type, Model * _parent,
 
 Controller::~Controller()
 {
+	s_controllersMutex.lock();
 	int idx = s_controllers.indexOf( this );
 	if( idx >= 0 )
 	{
 		s_controllers.remove( idx );
 	}
+	s_evaluationOrderDirty = true;
+	s_controllersMutex.unlock();
 
 	m_valueBuffer.clear();
 	// Remove connections by destroyed signal
@@ -114,7 +129,9 @@ float Controller::currentValue( int _offset )
 
 float Controller::value( int offset )
 {
-	if( m_bufferLastUpdated != s_periods )
+	// scheduled controllers are updated by evaluateControllers() only -
+	// updating them from whichever thread reads them first isn't safe
+	if( m_bufferLastUpdated != s_periods && !m_scheduled )
 	{
 		updateValueBuffer();
 	}
@@ -124,7 +141,7 @@ float Controller::value( int offset )
 
 ValueBuffer * Controller::valueBuffer()
 {
-	if( m_bufferLastUpdated != s_periods )
+	if( m_bufferLastUpdated != s_periods && !m_scheduled )
 	{
 		updateValueBuffer();
 	}
@@ -155,25 +172,38 @@ float Controller::runningTime()
 
 
 
+void Controller::doProcessing()
+{
+	if( m_bufferLastUpdated != s_periods )
+	{
+		updateValueBuffer();
+	}
+}
+
+
+
 void Controller::triggerFrameCounter()
 {
-	for( int i = 0; i < s_controllers.size(); ++i ) 
+	// This signal is for updating values for both stubborn knobs and for
+	// painting. Stubborn knobs need it every period. The connected models
+	// only queue the repaint, which the GUI thread does at display rate
+	// (see AutomatableModel::sendPendingNotifications()).
 	{
-		// This signal is for updating values for both stubborn knobs and for
-		// painting.  If we ever get all the widgets to use or at least check
-		// currentValue() then we can throttle the signal and only use it for
-		// GUI.
-		emit s_controllers.at(i)->valueChanged();
+		QMutexLocker lock( &s_controllersMutex );
+		for( int i = 0; i < s_controllers.size(); ++i )
+		{
+			emit s_controllers.at(i)->valueChanged();
+		}
 	}
 
 	s_periods ++;
-	//emit s_signaler.triggerValueChanged();
 }
 
 
 
 void Controller::resetFrameCounter()
 {
+	QMutexLocker lock( &s_controllersMutex );
 	for( int i = 0; i < s_controllers.size(); ++i ) 
 	{
 		s_controllers.at( i )->m_bufferLastUpdated = 0;
@@ -183,6 +213,99 @@ void Controller::resetFrameCounter()
 
 
 
+void Controller::evaluateControllers()
+{
+	QMutexLocker lock( &s_controllersMutex );
+
+	if( s_evaluationOrderDirty )
+	{
+		updateEvaluationOrder();
+	}
+
+	// controllers of one level don't depend on each other
+	for( int i = 0; i < s_evaluationOrder.size(); ++i )
+	{
+		const ControllerVector & level = s_evaluationOrder.at( i );
+		if( level.size() == 1 )
+		{
+			level.first()->doProcessing();
+		}
+		else
+		{
+			MixerWorkerThread::fillJobQueue<ControllerVector>( level );
+			MixerWorkerThread::startAndWaitForJobs();
+		}
+	}
+}
+
+
+
+// sort all connected controllers into levels where every controller only
+// depends on controllers of lower levels (i.e. one of its own models is
+// controlled by them)
+void Controller::updateEvaluationOrder()
+{
+	s_evaluationOrderDirty = false;
+	s_evaluationOrder.clear();
+
+	QHash<Controller *, int> levels;
+	for( int i = 0; i < s_controllers.size(); ++i )
+	{
+		s_controllers.at( i )->m_scheduled = false;
+	}
+
+	for( int i = 0; i < s_controllers.size(); ++i )
+	{
+		Controller * c = s_controllers.at( i );
+		if( c->connectionCount() > 0 )
+		{
+			const int level = evaluationLevel( c, levels );
+			if( level >= s_evaluationOrder.size() )
+			{
+				s_evaluationOrder.resize( level + 1 );
+			}
+			s_evaluationOrder[level].append( c );
+			c->m_scheduled = true;
+		}
+	}
+}
+
+
+
+int Controller::evaluationLevel( Controller * c,
+					QHash<Controller *, int> & levels )
+{
+	if( levels.contains( c ) )
+	{
+		// a negative level marks a controller we're just looking at,
+		// i.e. a loop - simply break it
+		return qMax( levels[c], 0 );
+	}
+	levels[c] = -1;
+
+	int level = 0;
+	const QList<AutomatableModel *> models =
+					c->findChildren<AutomatableModel *>();
+	for( int i = 0; i < models.size(); ++i )
+	{
+		ControllerConnection * cc = models.at( i )->controllerConnection();
+		if( cc == NULL )
+		{
+			continue;
+		}
+		Controller * dep = cc->getController();
+		if( dep && dep != c && s_controllers.contains( dep ) )
+		{
+			level = qMax( level, evaluationLevel( dep, levels ) + 1 );
+		}
+	}
+
+	levels[c] = level;
+	return level;
+}
+
+
+
 Controller * Controller::create( ControllerTypes _ct, Model * _parent )
 {
 	static Controller * dummy = NULL;
@@ -316,7 +439,9 @@ ControllerDialog * Controller::createDialog( QWidget * _parent )
 
 void Controller::addConnection( ControllerConnection * )
 {
+	QMutexLocker lock( &s_controllersMutex );
 	m_connectionCount++;
+	s_evaluationOrderDirty = true;
 }
 
 
@@ -324,8 +449,10 @@ void Controller::addConnection( ControllerConnection * )
 
 void Controller::removeConnection( ControllerConnection * )
 {
+	QMutexLocker lock( &s_controllersMutex );
 	m_connectionCount--;
 	Q_ASSERT( m_connectionCount >= 0 );
+	s_evaluationOrderDirty = true;
 }
 
 
@@ -30,6 +30,8 @@
 
 #include "Song.h"
 #include "ControllerConnection.h"
+#include "Engine.h"
+#include "Mixer.h"
 
 
 ControllerConnectionVector ControllerConnection::s_connections;
@@ -76,7 +78,10 @@ ControllerConnection::~ControllerConnection()
 	s_connections.remove( s_connections.indexOf( this ) );
 	if( m_ownsController )
 	{
+		// the mixer may be evaluating this controller right now
+		Engine::mixer()->requestChangeInModel();
 		delete m_controller;
+		Engine::mixer()->doneChangeInModel();
 	}
 }
 
@@ -94,8 +99,10 @@ void ControllerConnection::setController( Controller * _controller )
 {
 	if( m_ownsController && m_controller )
 	{
+		Engine::mixer()->requestChangeInModel();
 		delete m_controller;
 		m_controller = NULL;
+		Engine::mixer()->doneChangeInModel();
 	}
 
 	if( m_controller && m_controller->type() != Controller::DummyController )
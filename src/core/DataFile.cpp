@@ -300,6 +300,14 @@ bool DataFile::writeFile( const QString& filename )
 
 
 
+DataFile::Type DataFile::documentType( const QDomDocument& doc )
+{
+	return type( doc.documentElement().attribute( "type" ) );
+}
+
+
+
+
 DataFile::Type DataFile::type( const QString& typeName )
 {
 	for( int i = 0; i < TypeCount; ++i )
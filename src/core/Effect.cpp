@@ -25,10 +25,13 @@
 
 #include <QDomElement>
 
+#include <limits>
+
 #include "Effect.h"
 #include "EffectChain.h"
 #include "EffectControls.h"
 #include "EffectView.h"
+#include "Oversampler.h"
 
 #include "ConfigManager.h"
 
@@ -48,7 +51,9 @@ Effect::Effect( const Plugin::Descriptor * _desc,
 	m_wetDryModel( 1.0f, -1.0f, 1.0f, 0.01f, this, tr( "Wet/Dry mix" ) ),
 	m_gateModel( 0.0f, 0.0f, 1.0f, 0.01f, this, tr( "Gate" ) ),
 	m_autoQuitModel( 1.0f, 1.0f, 8000.0f, 100.0f, 1.0f, this, tr( "Decay" ) ),
-	m_autoQuitDisabled( false )
+	m_oversamplingModel( 0, 0, 3, this, tr( "Oversampling" ) ),
+	m_autoQuitDisabled( false ),
+	m_oversampler( NULL )
 {
 	m_srcState[0] = m_srcState[1] = NULL;
 	reinitSRC();
@@ -57,6 +62,9 @@ Effect::Effect( const Plugin::Descriptor * _desc,
 	{
 		m_autoQuitDisabled = true;
 	}
+
+	connect( &m_oversamplingModel, SIGNAL( dataChanged() ),
+				this, SLOT( updateOversampling() ) );
 }
 
 
@@ -71,6 +79,7 @@ Effect::~Effect()
 			src_delete( m_srcState[i] );
 		}
 	}
+	delete m_oversampler;
 }
 
 
@@ -82,6 +91,10 @@ void Effect::saveSettings( QDomDocument & _doc, QDomElement & _this )
 	m_wetDryModel.saveSettings( _doc, _this, "wet" );
 	m_autoQuitModel.saveSettings( _doc, _this, "autoquit" );
 	m_gateModel.saveSettings( _doc, _this, "gate" );
+	if( supportsOversampling() )
+	{
+		m_oversamplingModel.saveSettings( _doc, _this, "oversampling" );
+	}
 	controls()->saveState( _doc, _this );
 }
 
@@ -94,6 +107,10 @@ void Effect::loadSettings( const QDomElement & _this )
 	m_wetDryModel.loadSettings( _this, "wet" );
 	m_autoQuitModel.loadSettings( _this, "autoquit" );
 	m_gateModel.loadSettings( _this, "gate" );
+	if( supportsOversampling() )
+	{
+		m_oversamplingModel.loadSettings( _this, "oversampling" );
+	}
 
 	QDomNode node = _this.firstChild();
 	while( !node.isNull() )
@@ -136,6 +153,45 @@ Effect * Effect::instantiate( const QString& pluginName,
 
 
 
+int Effect::oversampling() const
+{
+	return m_oversampler ? m_oversampler->factor() : 1;
+}
+
+
+
+
+bool Effect::process( sampleFrame * _buf, const fpp_t _frames )
+{
+	if( m_oversampler == NULL || !isEnabled() )
+	{
+		return processAudioBuffer( _buf, _frames );
+	}
+
+	sampleFrame * buf = m_oversampler->up( _buf, _frames );
+	const bool running = processAudioBuffer( buf,
+					_frames * m_oversampler->factor() );
+	m_oversampler->down( _buf, _frames );
+
+	return running;
+}
+
+
+
+
+f_cnt_t Effect::processingLatency() const
+{
+	if( m_oversampler == NULL )
+	{
+		return latency();
+	}
+
+	return latency() / m_oversampler->factor() + m_oversampler->latency();
+}
+
+
+
+
 void Effect::checkGate( double _out_sum )
 {
 	if( m_autoQuitDisabled )
@@ -171,6 +227,32 @@ PluginView * Effect::instantiateView( QWidget * _parent )
 	
 
 
+void Effect::updateOversampling()
+{
+	const fpp_t frames = Engine::mixer()->framesPerPeriod();
+	int factor = supportsOversampling() ?
+				1 << m_oversamplingModel.value() : 1;
+	// the oversampled period still has to fit into fpp_t, which rules out
+	// high factors when rendering in very large blocks
+	while( factor > 1 &&
+		frames * factor > std::numeric_limits<fpp_t>::max() )
+	{
+		factor /= 2;
+	}
+
+	Oversampler * oversampler = factor > 1 ?
+		new Oversampler( factor, frames ) :
+		NULL;
+
+	Engine::mixer()->requestChangeInModel();
+	delete m_oversampler;
+	m_oversampler = oversampler;
+	Engine::mixer()->doneChangeInModel();
+}
+
+
+
+
 void Effect::reinitSRC()
 {
 	for( int i = 0; i < 2; ++i )
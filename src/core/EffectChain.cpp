@@ -29,6 +29,7 @@
 #include "EffectChain.h"
 #include "Effect.h"
 #include "DummyEffect.h"
+#include "MixerProfiler.h"
 #include "MixHelpers.h"
 #include "Song.h"
 
@@ -210,7 +211,8 @@ bool EffectChain::processAudioBuffer( sampleFrame * _buf, const fpp_t _frames, b
 	{
 		if( hasInputNoise || ( *it )->isRunning() )
 		{
-			moreEffects |= ( *it )->processAudioBuffer( _buf, _frames );
+			MixerProfiler::Probe probe( MixerProfiler::EffectProbe, *it );
+			moreEffects |= ( *it )->process( _buf, _frames );
 			MixHelpers::sanitize( _buf, _frames );
 		}
 	}
@@ -221,6 +223,29 @@ bool EffectChain::processAudioBuffer( sampleFrame * _buf, const fpp_t _frames, b
 
 
 
+f_cnt_t EffectChain::latency() const
+{
+	if( m_enabledModel.value() == false )
+	{
+		return 0;
+	}
+
+	f_cnt_t total = 0;
+	for( EffectList::ConstIterator it = m_effects.begin();
+						it != m_effects.end(); ++it )
+	{
+		if( ( *it )->isEnabled() )
+		{
+			total += ( *it )->processingLatency();
+		}
+	}
+
+	return total;
+}
+
+
+
+
 void EffectChain::startRunning()
 {
 	if( m_enabledModel.value() == false )
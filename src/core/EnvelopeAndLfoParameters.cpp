@@ -128,33 +128,20 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 
 	instances()->add( this );
 
-	connect( &m_predelayModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_attackModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_holdModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_decayModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_sustainModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_releaseModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_amountModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-
-	connect( &m_lfoPredelayModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_lfoAttackModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_lfoSpeedModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_lfoAmountModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_lfoWaveModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleVars() ) );
-	connect( &m_x100Model, SIGNAL( dataChanged() ),
-				this, SLOT( updateSampleVars() ) );
+	m_predelayModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_attackModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_holdModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_decayModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_sustainModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_releaseModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_amountModel.addValueListener( [this]() { updateSampleVars(); } );
+
+	m_lfoPredelayModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_lfoAttackModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_lfoSpeedModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_lfoAmountModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_lfoWaveModel.addValueListener( [this]() { updateSampleVars(); } );
+	m_x100Model.addValueListener( [this]() { updateSampleVars(); } );
 
 	connect( Engine::mixer(), SIGNAL( sampleRateChanged() ),
 				this, SLOT( updateSampleVars() ) );
@@ -24,9 +24,11 @@
 
 #include <QDomElement>
 
+#include "AudioPort.h"
 #include "BufferManager.h"
 #include "FxMixer.h"
 #include "Mixer.h"
+#include "MixerProfiler.h"
 #include "MixerWorkerThread.h"
 #include "MixHelpers.h"
 #include "Song.h"
@@ -38,7 +40,8 @@ FxRoute::FxRoute( FxChannel * from, FxChannel * to, float amount ) :
 	m_from( from ),
 	m_to( to ),
 	m_amount( amount, 0, 1, 0.001, NULL,
-			tr( "Amount to send from channel %1 to channel %2" ).arg( m_from->m_channelIndex ).arg( m_to->m_channelIndex ) )
+			tr( "Amount to send from channel %1 to channel %2" ).arg( m_from->m_channelIndex ).arg( m_to->m_channelIndex ) ),
+	m_compensation()
 {
 	//qDebug( "created: %d to %d", m_from->m_channelIndex, m_to->m_channelIndex );
 	// create send amount model
@@ -71,6 +74,7 @@ FxChannel::FxChannel( int idx, Model * _parent ) :
 	m_lock(),
 	m_channelIndex( idx ),
 	m_queued( false ),
+	m_cpuLoad( 0 ),
 	m_dependenciesMet( 0 )
 {
 	BufferManager::clear( m_buffer, Engine::mixer()->framesPerPeriod() );
@@ -120,21 +124,40 @@ void FxChannel::doProcessing()
 
 	if( m_muted == false )
 	{
+		// must not cover processed() - once the master channel is done
+		// the profiler collects the events of the current period
+		MixerProfiler::Probe probe( MixerProfiler::FxChannelProbe, this );
+
+		sampleFrame * delayBuf = NULL;
+
 		for( FxRoute * senderRoute : m_receives )
 		{
 			FxChannel * sender = senderRoute->sender();
 			FloatModel * sendModel = senderRoute->amount();
 			if( ! sendModel ) qFatal( "Error: no send model found from %d to %d", senderRoute->senderIndex(), m_channelIndex );
 
-			if( sender->m_hasInput || sender->m_stillRunning )
+			// mix it's output with this one's output
+			sampleFrame * ch_buf = sender->m_buffer;
+			bool active = sender->m_hasInput || sender->m_stillRunning;
+
+			// align the sender with inputs of higher latency
+			CompensationDelay * comp = senderRoute->compensation();
+			if( comp->delay() > 0 )
+			{
+				if( delayBuf == NULL )
+				{
+					delayBuf = BufferManager::acquire();
+				}
+				active = comp->process( ch_buf, delayBuf, fpp, active );
+				ch_buf = delayBuf;
+			}
+
+			if( active )
 			{
 				// figure out if we're getting sample-exact input
 				ValueBuffer * sendBuf = sendModel->valueBuffer();
 				ValueBuffer * volBuf = sender->m_volumeModel.valueBuffer();
 
-				// mix it's output with this one's output
-				sampleFrame * ch_buf = sender->m_buffer;
-
 				// use sample-exact mixing if sample-exact values are available
 				if( ! volBuf && ! sendBuf ) // neither volume nor send has sample-exact data...
 				{
@@ -159,6 +182,11 @@ void FxChannel::doProcessing()
 			}
 		}
 
+		if( delayBuf )
+		{
+			BufferManager::release( delayBuf );
+		}
+
 
 		const float v = m_volumeModel.value();
 
@@ -190,7 +218,9 @@ void FxChannel::doProcessing()
 FxMixer::FxMixer() :
 	Model( NULL ),
 	JournallingObject(),
-	m_fxChannels()
+	m_fxChannels(),
+	m_routingChanged( true ),
+	m_latency( 0 )
 {
 	// create master channel
 	createChannel();
@@ -220,6 +250,7 @@ int FxMixer::createChannel()
 	const int index = m_fxChannels.size();
 	// create new channel
 	m_fxChannels.push_back( new FxChannel( index, this ) );
+	m_routingChanged = true;
 
 	// reset channel state
 	clearChannel( index );
@@ -324,6 +355,7 @@ void FxMixer::deleteChannel( int index )
 	// actually delete the channel
 	m_fxChannels.remove(index);
 	delete ch;
+	m_routingChanged = true;
 
 	for( int i = index; i < m_fxChannels.size(); ++i )
 	{
@@ -390,6 +422,8 @@ void FxMixer::moveChannelLeft( int index )
 	// Update m_channelIndex of both channels
 	m_fxChannels[index]->m_channelIndex = index;
 	m_fxChannels[index - 1]->m_channelIndex = index -1;
+
+	m_routingChanged = true;
 }
 
 
@@ -441,6 +475,7 @@ FxRoute * FxMixer::createRoute( FxChannel * from, FxChannel * to, float amount )
 
 	// add us to fxmixer's list
 	Engine::fxMixer()->m_fxRoutes.append( route );
+	m_routingChanged = true;
 	Engine::mixer()->doneChangeInModel();
 
 	return route;
@@ -476,6 +511,7 @@ void FxMixer::deleteChannelSend( FxRoute * route )
 	// remove us from fxmixer's list
 	Engine::fxMixer()->m_fxRoutes.remove( Engine::fxMixer()->m_fxRoutes.indexOf( route ) );
 	delete route;
+	m_routingChanged = true;
 	Engine::mixer()->doneChangeInModel();
 }
 
@@ -559,6 +595,130 @@ void FxMixer::prepareMasterMix()
 {
 	BufferManager::clear( m_fxChannels[0]->m_buffer,
 					Engine::mixer()->framesPerPeriod() );
+
+	if( latencyChanged() )
+	{
+		updateLatencyCompensation();
+	}
+}
+
+
+
+
+// cheap check run every period - plugins may change their latency at any
+// time, e.g. when loading another VST
+bool FxMixer::latencyChanged() const
+{
+	if( m_routingChanged )
+	{
+		return true;
+	}
+
+	const QVector<AudioPort *> & ports = Engine::mixer()->audioPorts();
+	if( ports.size() != m_portLatencies.size() ||
+			m_fxChannels.size() != m_chainLatencies.size() )
+	{
+		return true;
+	}
+
+	for( int i = 0; i < ports.size(); ++i )
+	{
+		const PortLatency & p = m_portLatencies[i];
+		if( p.port != ports[i] ||
+			p.channel != ports[i]->nextFxChannel() ||
+			p.latency != ports[i]->latency() )
+		{
+			return true;
+		}
+	}
+
+	for( int i = 0; i < m_fxChannels.size(); ++i )
+	{
+		if( m_chainLatencies[i] != m_fxChannels[i]->m_fxChain.latency() )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+
+
+// delay every path into a channel so that all of them arrive with the
+// latency of the slowest one
+void FxMixer::updateLatencyCompensation()
+{
+	m_routingChanged = false;
+
+	const int channels = m_fxChannels.size();
+	m_chainLatencies.resize( channels );
+	m_inputLatencies.fill( 0, channels );
+	m_outputLatencies.fill( -1, channels );
+
+	for( int i = 0; i < channels; ++i )
+	{
+		m_chainLatencies[i] = m_fxChannels[i]->m_fxChain.latency();
+	}
+
+	const QVector<AudioPort *> & ports = Engine::mixer()->audioPorts();
+	m_portLatencies.resize( ports.size() );
+	for( int i = 0; i < ports.size(); ++i )
+	{
+		PortLatency & p = m_portLatencies[i];
+		p.port = ports[i];
+		p.channel = ports[i]->nextFxChannel();
+		p.latency = ports[i]->latency();
+		if( p.channel < channels )
+		{
+			m_inputLatencies[p.channel] =
+				qMax( m_inputLatencies[p.channel], p.latency );
+		}
+	}
+
+	for( int i = 0; i < channels; ++i )
+	{
+		channelOutputLatency( i );
+	}
+
+	for( const PortLatency & p : m_portLatencies )
+	{
+		p.port->compensation()->setDelay( p.channel < channels ?
+				m_inputLatencies[p.channel] - p.latency : 0 );
+	}
+
+	for( FxRoute * route : m_fxRoutes )
+	{
+		route->compensation()->setDelay(
+				m_inputLatencies[route->receiverIndex()] -
+				m_outputLatencies[route->senderIndex()] );
+	}
+
+	m_latency = m_outputLatencies[0];
+}
+
+
+
+
+f_cnt_t FxMixer::channelOutputLatency( int index )
+{
+	if( m_outputLatencies[index] >= 0 )
+	{
+		return m_outputLatencies[index];
+	}
+
+	// the routing graph has no loops, so this always terminates
+	f_cnt_t input = m_inputLatencies[index];
+	for( const FxRoute * route : m_fxChannels[index]->m_receives )
+	{
+		input = qMax( input, channelOutputLatency( route->senderIndex() ) );
+	}
+
+	m_inputLatencies[index] = input;
+	m_outputLatencies[index] = input + m_chainLatencies[index];
+
+	return m_outputLatencies[index];
 }
 
 
@@ -25,6 +25,7 @@
 
 #include "InstrumentPlayHandle.h"
 #include "InstrumentTrack.h"
+#include "PresetPreviewPlayHandle.h"
 
 InstrumentPlayHandle::InstrumentPlayHandle( Instrument * instrument, InstrumentTrack* instrumentTrack ) :
 		PlayHandle( TypeInstrumentPlayHandle ),
@@ -32,3 +33,12 @@ InstrumentPlayHandle::InstrumentPlayHandle( Instrument * instrument, InstrumentT
 {
 	setAudioPort( instrumentTrack->audioPort() );
 }
+
+
+
+
+bool InstrumentPlayHandle::requiresProcessing() const
+{
+	// instruments kept loaded for previewing presets later don't play
+	return !PresetPreviewPlayHandle::isIdle( m_instrument->instrumentTrack() );
+}
@@ -48,13 +48,10 @@ LfoController::LfoController( Model * _parent ) :
 	m_userDefSampleBuffer( new SampleBuffer )
 {
 	setSampleExact( true );
-	connect( &m_waveModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateSampleFunction() ) );
+	m_waveModel.addValueListener( [this]() { updateSampleFunction(); } );
 
-	connect( &m_speedModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateDuration() ) );
-	connect( &m_multiplierModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateDuration() ) );
+	m_speedModel.addValueListener( [this]() { updateDuration(); } );
+	m_multiplierModel.addValueListener( [this]() { updateDuration(); } );
 	connect( Engine::mixer(), SIGNAL( sampleRateChanged() ),
 			this, SLOT( updateDuration() ) );
 
@@ -29,6 +29,8 @@
 #include "lmmsconfig.h"
 
 #include "AudioPort.h"
+#include "AutomatableModel.h"
+#include "Controller.h"
 #include "FxMixer.h"
 #include "MixerWorkerThread.h"
 #include "Song.h"
@@ -66,10 +68,13 @@ typedef LocklessList<PlayHandle *>::Element LocklessListElement;
 
 static __thread bool s_renderingThread;
 
+// rate at which changes of models made while rendering are announced
+static const int MODEL_NOTIFICATION_RATE = 30;
 
 
 
-Mixer::Mixer( bool renderOnly ) :
+
+Mixer::Mixer( bool renderOnly, fpp_t renderFramesPerPeriod ) :
 	m_renderOnly( renderOnly ),
 	m_framesPerPeriod( DEFAULT_BUFFER_SIZE ),
 	m_inputBufferRead( 0 ),
@@ -129,6 +134,18 @@ Mixer::Mixer( bool renderOnly ) :
 			m_framesPerPeriod = DEFAULT_BUFFER_SIZE;
 		}
 	}
+	else if( renderFramesPerPeriod > 0 )
+	{
+		// without realtime output latency doesn't matter, so render in
+		// large blocks to pay all per-period costs (job barriers, controller
+		// updates etc.) less often - note onsets stay sample accurate as
+		// the song passes frame offsets to the play handles, but automation
+		// is applied per tick while instruments and effects render the
+		// whole period at once, so they only see the value of the last
+		// tick of each block
+		m_framesPerPeriod = qBound( MINIMUM_BUFFER_SIZE, renderFramesPerPeriod,
+						MAXIMUM_RENDER_BUFFER_SIZE );
+	}
 
 	// allocte the FIFO from the determined size
 	m_fifo = new fifo( fifoSize );
@@ -159,6 +176,10 @@ Mixer::Mixer( bool renderOnly ) :
 	m_poolDepth = 2;
 	m_readBuffer = 0;
 	m_writeBuffer = 1;
+
+	connect( &m_modelNotificationTimer, SIGNAL( timeout() ),
+				this, SLOT( sendModelNotifications() ) );
+	m_modelNotificationTimer.start( 1000 / MODEL_NOTIFICATION_RATE );
 }
 
 
@@ -423,6 +444,14 @@ const surroundSampleFrame * Mixer::renderNextBuffer()
 	FxMixer * fxMixer = Engine::fxMixer();
 	fxMixer->prepareMasterMix();
 
+	// apply MIDI input which arrived during the last period
+	m_midiClient->processQueuedInEvents( m_framesPerPeriod,
+							processingSampleRate() );
+
+	// update all connected controllers so everything processed below only
+	// has to read their value buffers
+	Controller::evaluateControllers();
+
 	// create play-handles for new notes, samples etc.
 	song->processNextBuffer();
 
@@ -473,6 +502,9 @@ const surroundSampleFrame * Mixer::renderNextBuffer()
 	// STAGE 3: do master mix in FX mixer
 	fxMixer->masterMix( m_writeBuf );
 
+	// send out all MIDI events generated during this period at once
+	m_midiClient->flushOutEvents();
+
 
 	emit nextAudioBuffer( m_readBuf );
 
@@ -778,6 +810,20 @@ void Mixer::removePlayHandlesOfTypes( Track * _track, const quint8 types )
 
 
 
+void Mixer::sendModelNotifications()
+{
+	AutomatableModel::sendPendingNotifications();
+
+	// follow the rendering as close as possible when exporting so that
+	// models still relying on queued slots get all the changes
+	const Song * song = Engine::getSong();
+	m_modelNotificationTimer.setInterval( song && song->isExporting() ?
+					0 : 1000 / MODEL_NOTIFICATION_RATE );
+}
+
+
+
+
 void Mixer::requestChangeInModel()
 {
 	if( s_renderingThread )
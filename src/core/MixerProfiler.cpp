@@ -24,11 +24,45 @@
 
 #include "MixerProfiler.h"
 
+#include "AudioPort.h"
+#include "Effect.h"
+#include "Engine.h"
+#include "FxMixer.h"
+#include "Mixer.h"
+
+
+// events exceeding this per thread and period are dropped
+static const int MAX_EVENTS_PER_THREAD = 8192;
+
+struct MixerProfiler::ThreadBuffer
+{
+	ThreadBuffer() :
+		count( 0 ),
+		named( false )
+	{
+	}
+
+	ProbeEvent events[MAX_EVENTS_PER_THREAD];
+	int count;
+	bool named;
+} ;
+
+
+volatile bool MixerProfiler::s_detailedProfiling = false;
+volatile bool MixerProfiler::s_tracing = false;
+QVector<MixerProfiler::ThreadBuffer *> MixerProfiler::s_threadBuffers;
+QMutex MixerProfiler::s_threadBuffersMutex;
+
+
 
 MixerProfiler::MixerProfiler() :
 	m_periodTimer(),
 	m_cpuLoad( 0 ),
-	m_outputFile()
+	m_outputFile(),
+	m_traceFile(),
+	m_traceEventsWritten( false ),
+	m_channelLoadEnabled( false ),
+	m_channelTimes()
 {
 }
 
@@ -36,6 +70,9 @@ MixerProfiler::MixerProfiler() :
 
 MixerProfiler::~MixerProfiler()
 {
+	closeTraceFile();
+	s_detailedProfiling = false;
+	s_tracing = false;
 }
 
 
@@ -50,6 +87,17 @@ void MixerProfiler::finishPeriod( sample_rate_t sampleRate, fpp_t framesPerPerio
 	{
 		m_outputFile.write( QString( "%1\n" ).arg( periodElapsed ).toLatin1() );
 	}
+
+	if( s_detailedProfiling )
+	{
+		const qint64 periodEnd = now();
+		collectEvents( periodEnd - periodElapsed, periodEnd,
+				framesPerPeriod * 1000.0f * 1000.0f / sampleRate );
+	}
+
+	// only switch at period boundaries so we never see half a period
+	s_tracing = m_traceFile.isOpen();
+	s_detailedProfiling = s_tracing || m_channelLoadEnabled;
 }
 
 
@@ -61,3 +109,228 @@ void MixerProfiler::setOutputFile( const QString& outputFile )
 	m_outputFile.open( QFile::WriteOnly | QFile::Truncate );
 }
 
+
+
+
+void MixerProfiler::setTraceFile( const QString& outputFile )
+{
+	Engine::mixer()->requestChangeInModel();
+
+	closeTraceFile();
+
+	if( !outputFile.isEmpty() )
+	{
+		m_traceFile.setFileName( outputFile );
+		if( m_traceFile.open( QFile::WriteOnly | QFile::Truncate ) )
+		{
+			m_traceFile.write( "[\n" );
+			m_traceEventsWritten = false;
+			writeTraceEvent( "periods", NULL, 0, 0, 0 );
+		}
+	}
+
+	Engine::mixer()->doneChangeInModel();
+}
+
+
+
+
+void MixerProfiler::closeTraceFile()
+{
+	if( m_traceFile.isOpen() )
+	{
+		m_traceFile.write( "\n]\n" );
+		m_traceFile.close();
+	}
+}
+
+
+
+
+void MixerProfiler::record( ProbeTypes type, const void * source,
+						qint64 start, qint64 end )
+{
+	// each thread gets its own buffer, so recording never needs to lock -
+	// the buffers are emptied by the mixer thread at the end of each
+	// period when all worker threads are idle. They're never freed as
+	// threads might keep a pointer to them for their whole life time.
+	static thread_local ThreadBuffer * buffer = NULL;
+	if( buffer == NULL )
+	{
+		buffer = new ThreadBuffer;
+		s_threadBuffersMutex.lock();
+		s_threadBuffers.push_back( buffer );
+		s_threadBuffersMutex.unlock();
+	}
+
+	if( buffer->count >= MAX_EVENTS_PER_THREAD )
+	{
+		return;
+	}
+
+	// the source is alive as long as its probe is - take everything
+	// needed from it right now. Effects and remote plugins are always
+	// nested in one of the other probes, so they don't add to the
+	// channel load.
+	ProbeEvent & e = buffer->events[buffer->count++];
+	e.type = type;
+	e.channel = -1;
+	e.start = start;
+	e.end = end;
+	switch( type )
+	{
+		case PlayHandleProbe:
+		case AudioPortProbe:
+		{
+			const AudioPort * port =
+				static_cast<const AudioPort *>( source );
+			e.channel = port->nextFxChannel();
+			if( s_tracing )
+			{
+				e.name = port->name();
+			}
+			break;
+		}
+		case FxChannelProbe:
+		{
+			const FxChannel * fxChannel =
+				static_cast<const FxChannel *>( source );
+			e.channel = fxChannel->m_channelIndex;
+			if( s_tracing )
+			{
+				e.name = fxChannel->m_name;
+			}
+			break;
+		}
+		case EffectProbe:
+			if( s_tracing )
+			{
+				e.name = static_cast<const Effect *>(
+						source )->displayName();
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+
+
+
+void MixerProfiler::collectEvents( qint64 periodStart, qint64 periodEnd,
+							float periodLength )
+{
+	const FxMixer * fxMixer = Engine::fxMixer();
+	const int channels = fxMixer->numChannels();
+	// names have only been copied if tracing was on for the whole period
+	const bool tracing = s_tracing && m_traceFile.isOpen();
+
+	if( m_channelLoadEnabled )
+	{
+		m_channelTimes.fill( 0, channels );
+	}
+
+	if( tracing )
+	{
+		writeTraceEvent( "period", "mixer", 0, periodStart, periodEnd );
+	}
+
+	QMutexLocker lock( &s_threadBuffersMutex );
+	for( int t = 0; t < s_threadBuffers.size(); ++t )
+	{
+		ThreadBuffer * buffer = s_threadBuffers[t];
+		if( tracing && !buffer->named && buffer->count > 0 )
+		{
+			writeTraceEvent( QString( "thread %1" ).arg( t + 1 ),
+							NULL, t + 1, 0, 0 );
+			buffer->named = true;
+		}
+
+		for( int i = 0; i < buffer->count; ++i )
+		{
+			const ProbeEvent & e = buffer->events[i];
+
+			if( m_channelLoadEnabled && e.channel >= 0 &&
+							e.channel < channels )
+			{
+				m_channelTimes[e.channel] += e.end - e.start;
+			}
+
+			if( tracing )
+			{
+				switch( e.type )
+				{
+					case PlayHandleProbe:
+						writeTraceEvent( e.name, "instrument",
+								t + 1, e.start, e.end );
+						break;
+					case AudioPortProbe:
+						writeTraceEvent( e.name, "track",
+								t + 1, e.start, e.end );
+						break;
+					case FxChannelProbe:
+						writeTraceEvent( e.name, "fxchannel",
+								t + 1, e.start, e.end );
+						break;
+					case EffectProbe:
+						writeTraceEvent( e.name, "effect",
+								t + 1, e.start, e.end );
+						break;
+					case RemotePluginProbe:
+						writeTraceEvent( "remote process", "remoteplugin",
+								t + 1, e.start, e.end );
+						break;
+					default:
+						break;
+				}
+			}
+		}
+
+		buffer->count = 0;
+	}
+
+	if( m_channelLoadEnabled )
+	{
+		for( int i = 0; i < channels; ++i )
+		{
+			FxChannel * ch = Engine::fxMixer()->effectChannel( i );
+			const float load = m_channelTimes[i] * 100.0f / periodLength;
+			ch->m_cpuLoad = qBound<int>( 0, load * 0.1f +
+						ch->m_cpuLoad * 0.9f, 100 );
+		}
+	}
+}
+
+
+
+
+// passing no category writes a thread name instead of a duration event
+void MixerProfiler::writeTraceEvent( const QString& name,
+		const char * category, int thread, qint64 start, qint64 end )
+{
+	QString escapedName = name;
+	escapedName.replace( '\\', "\\\\" ).replace( '"', "\\\"" ).
+							replace( '\n', ' ' );
+
+	QString event;
+	if( category )
+	{
+		event = QString( "{\"name\":\"%1\",\"cat\":\"%2\",\"ph\":\"X\","
+					"\"pid\":1,\"tid\":%3,\"ts\":%4,\"dur\":%5}" ).
+				arg( escapedName ).arg( category ).arg( thread ).
+				arg( start ).arg( end - start );
+	}
+	else
+	{
+		event = QString( "{\"name\":\"thread_name\",\"ph\":\"M\","
+				"\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"%2\"}}" ).
+					arg( thread ).arg( escapedName );
+	}
+
+	if( m_traceEventsWritten )
+	{
+		m_traceFile.write( ",\n" );
+	}
+	m_traceFile.write( event.toUtf8() );
+	m_traceEventsWritten = true;
+}
@@ -46,14 +46,12 @@ Note::Note( const MidiTime & length, const MidiTime & pos,
 	m_pos( pos ),
 	m_detuning( NULL )
 {
+	// the detuning is created when it is edited first, most notes never
+	// get any and shouldn't carry a model each
 	if( detuning )
 	{
 		m_detuning = sharedObject::ref( detuning );
 	}
-	else
-	{
-		createDetuning();
-	}
 }
 
 
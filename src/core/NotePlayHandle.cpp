@@ -31,6 +31,7 @@
 #include "Instrument.h"
 #include "Mixer.h"
 #include "Song.h"
+#include "TrackContainer.h"
 
 
 NotePlayHandle::BaseDetuning::BaseDetuning( DetuningHelper *detuning ) :
@@ -76,7 +77,8 @@ NotePlayHandle::NotePlayHandle( InstrumentTrack* instrumentTrack,
 	m_songGlobalParentOffset( 0 ),
 	m_midiChannel( midiEventChannel >= 0 ? midiEventChannel : instrumentTrack->midiPort()->realOutputChannel() ),
 	m_origin( origin ),
-	m_frequencyNeedsUpdate( false )
+	m_frequencyNeedsUpdate( false ),
+	m_randomSeed( 0 )
 {
 	lock();
 	if( hasParent() == false )
@@ -97,6 +99,7 @@ NotePlayHandle::NotePlayHandle( InstrumentTrack* instrumentTrack,
 	}
 
 	updateFrequency();
+	seedRandomGenerator();
 
 	setFrames( _frames );
 
@@ -234,6 +237,7 @@ void NotePlayHandle::play( sampleFrame * _working_buffer )
 	if( framesLeft() > 0 )
 	{
 		// play note!
+		RandomGenerator::Scope randomScope( m_randomGenerator );
 		m_instrumentTrack->playNote( this, _working_buffer );
 	}
 
@@ -300,6 +304,32 @@ void NotePlayHandle::play( sampleFrame * _working_buffer )
 
 
 
+void NotePlayHandle::seedRandomGenerator()
+{
+	// only use the identity and position of the note, so it gets the
+	// same noise on every run no matter which thread renders it
+	uint32_t seed;
+	if( hasParent() )
+	{
+		// sub-notes are created while their parent plays
+		seed = RandomGenerator::combine( m_parent->m_randomSeed,
+				m_parent->totalFramesPlayed() + offset() );
+	}
+	else
+	{
+		const TrackContainer * tc = m_instrumentTrack->trackContainer();
+		seed = RandomGenerator::combine( RandomGenerator::DefaultSeed,
+				tc->tracks().indexOf( m_instrumentTrack ) );
+		seed = RandomGenerator::combine( seed,
+				m_songGlobalParentOffset.getTicks() + pos().getTicks() );
+	}
+	m_randomSeed = RandomGenerator::combine( seed, key() );
+	m_randomGenerator.seed( m_randomSeed );
+}
+
+
+
+
 f_cnt_t NotePlayHandle::framesLeft() const
 {
 	if( instrumentTrack()->isSustainPedalPressed() )
@@ -356,6 +356,24 @@ void Oscillator::updateNoSub( sampleFrame * _ab, const fpp_t _frames,
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning;
 
+	if( W == WhiteNoise )
+	{
+		// noise doesn't depend on the phase, generate it blockwise
+		RandomGenerator & generator = RandomGenerator::current();
+		float noise[64];
+		for( fpp_t frame = 0; frame < _frames; frame += 64 )
+		{
+			const fpp_t block = qMin<fpp_t>( 64, _frames - frame );
+			generator.fillNoise( noise, block );
+			for( fpp_t f = 0; f < block; ++f )
+			{
+				_ab[frame + f][_chnl] = noise[f] * m_volume;
+			}
+		}
+		m_phase += osc_coeff * _frames;
+		return;
+	}
+
 	for( fpp_t frame = 0; frame < _frames; ++frame )
 	{
 		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
@@ -53,8 +53,10 @@ PeakController::PeakController( Model * _parent,
 			this, SLOT( handleDestroyedEffect( ) ) );
 	}
 	connect( Engine::mixer(), SIGNAL( sampleRateChanged() ), this, SLOT( updateCoeffs() ) );
-	connect( m_peakEffect->attackModel(), SIGNAL( dataChanged() ), this, SLOT( updateCoeffs() ) );
-	connect( m_peakEffect->decayModel(), SIGNAL( dataChanged() ), this, SLOT( updateCoeffs() ) );
+	m_peakEffect->attackModel()->addValueListener(
+					[this]() { updateCoeffs(); }, this );
+	m_peakEffect->decayModel()->addValueListener(
+					[this]() { updateCoeffs(); }, this );
 	m_coeffNeedsUpdate = true;
 }
 
@@ -63,6 +65,11 @@ PeakController::PeakController( Model * _parent,
 
 PeakController::~PeakController()
 {
+	if( m_peakEffect != NULL )
+	{
+		m_peakEffect->attackModel()->removeValueListeners( this );
+		m_peakEffect->decayModel()->removeValueListeners( this );
+	}
 	if( m_peakEffect != NULL && m_peakEffect->effectChain() != NULL )
 	{
 		m_peakEffect->effectChain()->removeEffect( m_peakEffect );
@@ -128,7 +135,10 @@ void PeakController::handleDestroyedEffect( )
 	disconnect( m_peakEffect );
 	m_peakEffect = NULL;
 	//deleteLater();
+	// don't let the mixer evaluate us while we're vanishing
+	Engine::mixer()->requestChangeInModel();
 	delete this;
+	Engine::mixer()->doneChangeInModel();
 }
 
 
@@ -26,6 +26,7 @@
 #include "BufferManager.h"
 #include "Engine.h"
 #include "Mixer.h"
+#include "MixerProfiler.h"
 
 #include <QtCore/QThread>
 #include <QDebug>
@@ -51,6 +52,8 @@ PlayHandle::~PlayHandle()
 
 void PlayHandle::doProcessing()
 {
+	MixerProfiler::Probe probe( MixerProfiler::PlayHandleProbe, audioPort() );
+
 	if( m_usesBuffer )
 	{
 		m_bufferReleased = false;
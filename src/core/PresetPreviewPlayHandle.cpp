@@ -23,7 +23,9 @@
  */
 
 #include <QAtomicPointer>
+#include <QDateTime>
 #include <QFileInfo>
+#include <QVector>
 
 #include "PresetPreviewPlayHandle.h"
 #include "Engine.h"
@@ -36,19 +38,81 @@
 
 
 
+static void loadPreset( InstrumentTrack * _track, const QString & _preset_file,
+					bool _load_by_plugin, DataFile * _data_file )
+{
+	if( _load_by_plugin )
+	{
+		Instrument * i = _track->instrument();
+		const QString ext = QFileInfo( _preset_file ).
+							suffix().toLower();
+		if( i == NULL || !i->descriptor()->supportsFileType( ext ) )
+		{
+			i = _track->loadInstrument(
+				pluginFactory->pluginSupportingExtension(ext).name());
+		}
+		if( i != NULL )
+		{
+			i->loadFile( _preset_file );
+		}
+	}
+	else
+	{
+		bool dataFileCreated = false;
+		if( _data_file == 0 )
+		{
+			_data_file = new DataFile( _preset_file );
+			dataFileCreated = true;
+		}
+
+		// vestige previews are bug prone; fallback on 3xosc with volume of 0
+		// without an instrument in preview track, it will segfault
+		if(_data_file->content().elementsByTagName( "vestige" ).length() == 0 )
+		{
+			_track->loadTrackSpecificSettings(
+				_data_file->content().firstChild().toElement() );
+		}
+		else
+		{
+			_track->loadInstrument("tripleoscillator");
+			_track->setVolume( 0 );
+		}
+		if( dataFileCreated )
+		{
+			delete _data_file;
+		}
+	}
+	// make sure, our preset-preview-track does not appear in any MIDI-
+	// devices list, so just disable receiving/sending MIDI-events at all
+	_track->midiPort()->setMode( MidiPort::Disabled );
+}
+
+
+
+
 // invisible track-container which is needed as parent for preview-channels
+//
+// It keeps the last few previewed presets loaded in a track each, so
+// auditioning one of them again doesn't load anything. Only the track
+// currently previewed is processed, the others are idle.
 class PreviewTrackContainer : public TrackContainer
 {
 public:
+	// maximum number of presets kept loaded
+	static const int MaxWarmTracks = 4;
+	// prefetching never replaces the presets of this many last previews,
+	// so switching back and forth between them stays instant
+	static const unsigned int KeptPreviews = 2;
+
 	PreviewTrackContainer() :
 		m_previewInstrumentTrack( NULL ),
 		m_previewNote( NULL ),
-		m_dataMutex()
+		m_dataMutex(),
+		m_lastUse( 0 ),
+		m_previews( 0 )
 	{
 		setJournalling( false );
-		m_previewInstrumentTrack = dynamic_cast<InstrumentTrack *>( Track::create( Track::InstrumentTrack, this ) );
-		m_previewInstrumentTrack->setJournalling( false );
-		m_previewInstrumentTrack->setPreviewMode( true );
+		m_previewInstrumentTrack = createTrack();
 	}
 
 	virtual ~PreviewTrackContainer()
@@ -65,6 +129,58 @@ public:
 		return m_previewInstrumentTrack;
 	}
 
+	// must only be called while the mixer is locked
+	void setPreviewInstrumentTrack( InstrumentTrack * _track )
+	{
+		m_previewInstrumentTrack = _track;
+	}
+
+	// returns a track with the given preset loaded. If none has it yet,
+	// the least recently used track gets loaded with it. When
+	// prefetching, the tracks of the last KeptPreviews previews are
+	// left alone and NULL is returned if there is no other one.
+	InstrumentTrack * warmTrack( const QString & _preset_file,
+					bool _load_by_plugin, DataFile * _data_file,
+					bool _prefetch )
+	{
+		const QString key = ( _load_by_plugin ? "plugin:" : "preset:" ) +
+								_preset_file;
+		const QDateTime modified = QFileInfo( _preset_file ).lastModified();
+
+		int slot = -1;
+		for( int i = 0; i < m_warmTracks.size(); ++i )
+		{
+			if( m_warmTracks[i].key == key &&
+				m_warmTracks[i].modified == modified )
+			{
+				slot = i;
+				break;
+			}
+		}
+
+		if( slot < 0 )
+		{
+			slot = recycleSlot( _prefetch );
+			if( slot < 0 )
+			{
+				return NULL;
+			}
+			// forget the old preset first in case loading fails half way
+			m_warmTracks[slot].key = QString();
+			loadPreset( m_warmTracks[slot].track, _preset_file,
+						_load_by_plugin, _data_file );
+			m_warmTracks[slot].key = key;
+			m_warmTracks[slot].modified = modified;
+		}
+
+		m_warmTracks[slot].lastUse = ++m_lastUse;
+		if( !_prefetch )
+		{
+			m_warmTracks[slot].lastPreview = ++m_previews;
+		}
+		return m_warmTracks[slot].track;
+	}
+
 	NotePlayHandle* previewNote()
 	{
 	#if QT_VERSION >= 0x050000
@@ -110,10 +226,70 @@ public:
 
 
 private:
+	struct WarmTrack
+	{
+		InstrumentTrack * track;
+		QString key;
+		QDateTime modified;
+		unsigned int lastUse;
+		// number of the last preview using it, 0 if none did
+		unsigned int lastPreview;
+	} ;
+
+	InstrumentTrack * createTrack()
+	{
+		WarmTrack w;
+		w.track = dynamic_cast<InstrumentTrack *>( Track::create( Track::InstrumentTrack, this ) );
+		w.track->setJournalling( false );
+		w.track->setPreviewMode( true );
+		w.lastUse = 0;
+		w.lastPreview = 0;
+		m_warmTracks.append( w );
+		return w.track;
+	}
+
+	// picks a track to load another preset into: an empty one, a new one
+	// while there are less than MaxWarmTracks or the least recently used,
+	// -1 if prefetching and all tracks are kept for recent previews
+	int recycleSlot( bool _prefetch )
+	{
+		int lru = -1;
+		for( int i = 0; i < m_warmTracks.size(); ++i )
+		{
+			const WarmTrack & w = m_warmTracks[i];
+			if( _prefetch && ( w.track == m_previewInstrumentTrack ||
+				( w.lastPreview > 0 &&
+					w.lastPreview + KeptPreviews > m_previews ) ) )
+			{
+				continue;
+			}
+			if( m_warmTracks[i].key.isEmpty() )
+			{
+				return i;
+			}
+			if( lru < 0 ||
+				m_warmTracks[i].lastUse < m_warmTracks[lru].lastUse )
+			{
+				lru = i;
+			}
+		}
+
+		if( m_warmTracks.size() < MaxWarmTracks )
+		{
+			createTrack();
+			return m_warmTracks.size() - 1;
+		}
+		return lru;
+	}
+
 	InstrumentTrack* m_previewInstrumentTrack;
 	QAtomicPointer<NotePlayHandle> m_previewNote;
 	QMutex m_dataMutex;
 
+	QVector<WarmTrack> m_warmTracks;
+	unsigned int m_lastUse;
+	unsigned int m_previews;
+
 	friend class PresetPreviewPlayHandle;
 
 } ;
@@ -139,62 +315,21 @@ PresetPreviewPlayHandle::PresetPreviewPlayHandle( const QString & _preset_file,
 	const bool j = Engine::projectJournal()->isJournalling();
 	Engine::projectJournal()->setJournalling( false );
 
-	if( _load_by_plugin )
-	{
-		Instrument * i = s_previewTC->previewInstrumentTrack()->instrument();
-		const QString ext = QFileInfo( _preset_file ).
-							suffix().toLower();
-		if( i == NULL || !i->descriptor()->supportsFileType( ext ) )
-		{
-			i = s_previewTC->previewInstrumentTrack()->
-				loadInstrument(pluginFactory->pluginSupportingExtension(ext).name());
-		}
-		if( i != NULL )
-		{
-			i->loadFile( _preset_file );
-		}
-	}
-	else
-	{
-		bool dataFileCreated = false;
-		if( dataFile == 0 )
-		{
-			dataFile = new DataFile( _preset_file );
-			dataFileCreated = true;
-		}
-
-		// vestige previews are bug prone; fallback on 3xosc with volume of 0
-		// without an instrument in preview track, it will segfault
-		if(dataFile->content().elementsByTagName( "vestige" ).length() == 0 )
-		{
-			s_previewTC->previewInstrumentTrack()->
-					loadTrackSpecificSettings(
-						dataFile->content().firstChild().toElement() );
-		}
-		else
-		{
-			s_previewTC->previewInstrumentTrack()->loadInstrument("tripleoscillator");
-			s_previewTC->previewInstrumentTrack()->setVolume( 0 );
-		}
-		if( dataFileCreated )
-		{
-			delete dataFile;
-		}
-	}
+	// nothing is loaded if the preset has been previewed or prefetched
+	// recently
+	InstrumentTrack * track = s_previewTC->warmTrack( _preset_file,
+						_load_by_plugin, dataFile, false );
 	dataFile = 0;
-	// make sure, our preset-preview-track does not appear in any MIDI-
-	// devices list, so just disable receiving/sending MIDI-events at all
-	s_previewTC->previewInstrumentTrack()->
-				midiPort()->setMode( MidiPort::Disabled );
 
 	Engine::mixer()->requestChangeInModel();
+	s_previewTC->setPreviewInstrumentTrack( track );
+
 	// create note-play-handle for it
-	m_previewNote = NotePlayHandleManager::acquire(
-			s_previewTC->previewInstrumentTrack(), 0,
+	m_previewNote = NotePlayHandleManager::acquire( track, 0,
 			typeInfo<f_cnt_t>::max() / 2,
 				Note( 0, 0, DefaultKey, 100 ) );
 
-	setAudioPort( s_previewTC->previewInstrumentTrack()->audioPort() );
+	setAudioPort( track->audioPort() );
 
 	s_previewTC->setPreviewNote( m_previewNote );
 
@@ -282,6 +417,38 @@ ConstNotePlayHandleList PresetPreviewPlayHandle::nphsOfInstrumentTrack(
 
 
 
+void PresetPreviewPlayHandle::prefetch( const QString & _preset_file,
+					bool _load_by_plugin, DataFile * dataFile )
+{
+	if( !s_previewTC )
+	{
+		return;
+	}
+
+	s_previewTC->lockData();
+	const bool j = Engine::projectJournal()->isJournalling();
+	Engine::projectJournal()->setJournalling( false );
+
+	// neither the preset currently previewed nor the ones before it get
+	// replaced
+	s_previewTC->warmTrack( _preset_file, _load_by_plugin, dataFile, true );
+
+	Engine::projectJournal()->setJournalling( j );
+	s_previewTC->unlockData();
+}
+
+
+
+
+bool PresetPreviewPlayHandle::isIdle( const InstrumentTrack * _it )
+{
+	return _it->isPreviewMode() && s_previewTC &&
+				s_previewTC->previewInstrumentTrack() != _it;
+}
+
+
+
+
 bool PresetPreviewPlayHandle::isPreviewing()
 {
 	if (s_previewTC) {
@@ -27,6 +27,7 @@
 #include "ProjectJournal.h"
 #include "Engine.h"
 #include "JournallingObject.h"
+#include "SharedSampleData.h"
 #include "Song.h"
 
 static const int EO_ID_MSB = 1 << 23;
@@ -68,9 +69,12 @@ void ProjectJournal::undo()
 			setJournalling( false );
 			jo->restoreState( c.data.content().firstChildElement() );
 			setJournalling( prev );
+			// the restored object holds its own references by now
+			releaseCheckPoint( c );
 			Engine::getSong()->setModified();
 			break;
 		}
+		releaseCheckPoint( c );
 	}
 }
 
@@ -93,9 +97,12 @@ void ProjectJournal::redo()
 			setJournalling( false );
 			jo->restoreState( c.data.content().firstChildElement() );
 			setJournalling( prev );
+			// the restored object holds its own references by now
+			releaseCheckPoint( c );
 			Engine::getSong()->setModified();
 			break;
 		}
+		releaseCheckPoint( c );
 	}
 }
 
@@ -115,6 +122,7 @@ void ProjectJournal::addJournalCheckPoint( JournallingObject *jo )
 {
 	if( isJournalling() )
 	{
+		releaseCheckPoints( m_redoCheckPoints );
 		m_redoCheckPoints.clear();
 
 		DataFile dataFile( DataFile::JournalData );
@@ -123,7 +131,12 @@ void ProjectJournal::addJournalCheckPoint( JournallingObject *jo )
 		m_undoCheckPoints.push( CheckPoint( jo->id(), dataFile ) );
 		if( m_undoCheckPoints.size() > MAX_UNDO_STATES )
 		{
-			m_undoCheckPoints.remove( 0, m_undoCheckPoints.size() - MAX_UNDO_STATES );
+			const int drop = m_undoCheckPoints.size() - MAX_UNDO_STATES;
+			for( int i = 0; i < drop; ++i )
+			{
+				releaseCheckPoint( m_undoCheckPoints[i] );
+			}
+			m_undoCheckPoints.remove( 0, drop );
 		}
 	}
 }
@@ -174,6 +187,8 @@ jo_id_t ProjectJournal::idFromSave( jo_id_t id )
 
 void ProjectJournal::clearJournal()
 {
+	releaseCheckPoints( m_undoCheckPoints );
+	releaseCheckPoints( m_redoCheckPoints );
 	m_undoCheckPoints.clear();
 	m_redoCheckPoints.clear();
 
@@ -190,6 +205,26 @@ void ProjectJournal::clearJournal()
 	}
 }
 
+void ProjectJournal::releaseCheckPoint( CheckPoint & c )
+{
+	// sample data is only referenced by checkpoints, not stored in them
+	SharedSampleData::releaseRetained( c.data.content() );
+}
+
+
+
+
+void ProjectJournal::releaseCheckPoints( CheckPointStack & stack )
+{
+	for( int i = 0; i < stack.size(); ++i )
+	{
+		releaseCheckPoint( stack[i] );
+	}
+}
+
+
+
+
 void ProjectJournal::stopAllJournalling()
 {
 	for( JoIdMap::Iterator it = m_joIDs.begin(); it != m_joIDs.end(); ++it)
@@ -26,6 +26,7 @@
 #include <QFile>
 
 #include "ProjectRenderer.h"
+#include "LocklessRingBuffer.h"
 #include "Song.h"
 
 #include "AudioFileWave.h"
@@ -70,38 +71,138 @@ const ProjectRenderer::FileEncodeDevice ProjectRenderer::fileEncodeDevices[] =
 
 
 
+// writes the periods rendered by the ProjectRenderer to one file, so
+// encoding overlaps with rendering the following periods
+class ProjectRenderer::EncoderThread : public QThread
+{
+public:
+	EncoderThread( ProjectRenderer * renderer, AudioFileDevice * fileDev ) :
+		m_renderer( renderer ),
+		m_fileDev( fileDev ),
+		m_queue( PipelineDepth + 1 )
+	{
+	}
+
+	//! called by the rendering thread, -1 finishes the thread
+	void enqueue( int period )
+	{
+		m_queue.write( &period, 1 );
+		m_queued.release();
+	}
+
+
+private:
+	virtual void run()
+	{
+		MemoryManager::ThreadGuard mmThreadGuard; Q_UNUSED(mmThreadGuard);
+
+		while( true )
+		{
+			m_queued.acquire();
+
+			int period;
+			m_queue.read( &period, 1 );
+			if( period < 0 )
+			{
+				break;
+			}
+			m_renderer->encodePeriod( m_fileDev, period );
+		}
+	}
+
+	ProjectRenderer * m_renderer;
+	AudioFileDevice * m_fileDev;
+
+	LocklessRingBuffer<int> m_queue;
+	QSemaphore m_queued;
+
+} ;
+
+
+
+
 ProjectRenderer::ProjectRenderer( const Mixer::qualitySettings & qualitySettings,
 					const OutputSettings & outputSettings,
 					ExportFileFormats exportFileFormat,
 					const QString & outputFilename ) :
 	QThread( Engine::mixer() ),
 	m_fileDev( NULL ),
+	m_outputSettings( outputSettings ),
 	m_qualitySettings( qualitySettings ),
+	m_nextPeriod( 0 ),
+	m_freePeriods( PipelineDepth ),
 	m_progress( 0 ),
 	m_abort( false )
 {
-	AudioFileDeviceInstantiaton audioEncoderFactory = fileEncodeDevices[exportFileFormat].m_getDevInst;
+	m_fileDev = createFileDevice( exportFileFormat, outputSettings,
+							outputFilename );
+
+	for( int i = 0; i < PipelineDepth; ++i )
+	{
+		m_periods[i].buffer = new surroundSampleFrame[
+					Engine::mixer()->framesPerPeriod()];
+		m_periods[i].frames = 0;
+		m_periods[i].masterGain = 1.0f;
+	}
+}
+
+
+
+
+ProjectRenderer::~ProjectRenderer()
+{
+	// the main device is deleted by the mixer when restoring the old one
+	for( int i = 0; i < m_additionalFileDevs.size(); ++i )
+	{
+		delete m_additionalFileDevs[i];
+	}
+
+	for( int i = 0; i < PipelineDepth; ++i )
+	{
+		delete[] m_periods[i].buffer;
+	}
+}
+
+
+
+
+bool ProjectRenderer::addOutput( ExportFileFormats fileFormat,
+					const QString & outputFilename )
+{
+	AudioFileDevice * fileDev = createFileDevice( fileFormat,
+					m_outputSettings, outputFilename );
+	if( fileDev )
+	{
+		m_additionalFileDevs.push_back( fileDev );
+	}
+	return fileDev != NULL;
+}
+
+
+
+
+AudioFileDevice * ProjectRenderer::createFileDevice(
+					ExportFileFormats fileFormat,
+					const OutputSettings & outputSettings,
+					const QString & outputFilename )
+{
+	AudioFileDeviceInstantiaton audioEncoderFactory = fileEncodeDevices[fileFormat].m_getDevInst;
 
 	if (audioEncoderFactory)
 	{
 		bool successful = false;
 
-		m_fileDev = audioEncoderFactory(
+		AudioFileDevice * fileDev = audioEncoderFactory(
 					outputFilename, outputSettings, DEFAULT_CHANNELS,
 					Engine::mixer(), successful );
-		if( !successful )
+		if( successful )
 		{
-			delete m_fileDev;
-			m_fileDev = NULL;
+			return fileDev;
 		}
+		delete fileDev;
 	}
-}
 
-
-
-
-ProjectRenderer::~ProjectRenderer()
-{
+	return NULL;
 }
 
 
@@ -188,12 +289,23 @@ void ProjectRenderer::run()
 	// Now start processing
 	Engine::mixer()->startProcessing(false);
 
+	m_encoders.push_back( new EncoderThread( this, m_fileDev ) );
+	for( int i = 0; i < m_additionalFileDevs.size(); ++i )
+	{
+		m_encoders.push_back( new EncoderThread( this,
+						m_additionalFileDevs[i] ) );
+	}
+	for( int i = 0; i < m_encoders.size(); ++i )
+	{
+		m_encoders[i]->start();
+	}
+
 	// Continually track and emit progress percentage to listeners
 	while( exportPos.getTicks() < endTick &&
 				Engine::getSong()->isExporting() == true
 							&& !m_abort )
 	{
-		m_fileDev->processNextBuffer();
+		renderPeriod();
 		const int nprog = lengthTicks == 0 ? 100 : (exportPos.getTicks()-startTick) * 100 / lengthTicks;
 		if( m_progress != nprog )
 		{
@@ -202,16 +314,72 @@ void ProjectRenderer::run()
 		}
 	}
 
+	// let the encoders write everything rendered so far
+	for( int i = 0; i < m_encoders.size(); ++i )
+	{
+		m_encoders[i]->enqueue( -1 );
+	}
+	for( int i = 0; i < m_encoders.size(); ++i )
+	{
+		m_encoders[i]->wait();
+		delete m_encoders[i];
+	}
+	m_encoders.clear();
+
 	// notify mixer of the end of processing
 	Engine::mixer()->stopProcessing();
 
 	Engine::getSong()->stopExport();
 
-	// if the user aborted export-process, the file has to be deleted
-	const QString f = m_fileDev->outputFile();
+	// if the user aborted export-process, the files have to be deleted
 	if( m_abort )
 	{
-		QFile( f ).remove();
+		QFile( m_fileDev->outputFile() ).remove();
+		for( int i = 0; i < m_additionalFileDevs.size(); ++i )
+		{
+			QFile( m_additionalFileDevs[i]->outputFile() ).remove();
+		}
+	}
+}
+
+
+
+
+void ProjectRenderer::renderPeriod()
+{
+	// periods are used round robin and every encoder writes them in order,
+	// so the oldest one is freed first
+	m_freePeriods.acquire();
+
+	Period & period = m_periods[m_nextPeriod];
+	period.frames = m_fileDev->getNextBuffer( period.buffer );
+	if( period.frames == 0 )
+	{
+		m_freePeriods.release();
+		return;
+	}
+	period.masterGain = Engine::mixer()->masterGain();
+	period.pendingEncoders.fetchAndStoreOrdered( m_encoders.size() );
+
+	for( int i = 0; i < m_encoders.size(); ++i )
+	{
+		m_encoders[i]->enqueue( m_nextPeriod );
+	}
+
+	m_nextPeriod = ( m_nextPeriod + 1 ) % PipelineDepth;
+}
+
+
+
+
+void ProjectRenderer::encodePeriod( AudioFileDevice * fileDev, int period )
+{
+	Period & p = m_periods[period];
+	fileDev->writeBuffer( p.buffer, p.frames, p.masterGain );
+
+	if( p.pendingEncoders.fetchAndAddOrdered( -1 ) == 1 )
+	{
+		m_freePeriods.release();
 	}
 }
 
@@ -0,0 +1,46 @@
+/*
+ * RandomGenerator.cpp - fast counter based random numbers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RandomGenerator.h"
+
+
+// defined here instead of inline so plugins see the same pointer as the
+// core on platforms where every library gets its own copy of inline statics
+static thread_local RandomGenerator * s_currentGenerator = NULL;
+
+
+
+
+RandomGenerator & RandomGenerator::current()
+{
+	return s_currentGenerator ? *s_currentGenerator : forThread();
+}
+
+
+
+
+RandomGenerator * RandomGenerator::setCurrent( RandomGenerator * _generator )
+{
+	RandomGenerator * previous = s_currentGenerator;
+	s_currentGenerator = _generator;
+	return previous;
+}
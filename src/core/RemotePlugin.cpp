@@ -29,8 +29,10 @@
 #endif
 
 #include "BufferManager.h"
+#include "ConfigManager.h"
 #include "RemotePlugin.h"
 #include "Mixer.h"
+#include "MixerProfiler.h"
 #include "Engine.h"
 
 #include <QDir>
@@ -93,7 +95,11 @@ RemotePlugin::RemotePlugin() :
 	m_shmSize( 0 ),
 	m_shm( NULL ),
 	m_inputCount( DEFAULT_CHANNELS ),
-	m_outputCount( DEFAULT_CHANNELS )
+	m_outputCount( DEFAULT_CHANNELS ),
+	m_pipelined( ConfigManager::inst()->value( "mixer",
+					"pipelinedremoteplugins" ).toInt() ),
+	m_processingInFlight( false ),
+	m_outputPending( false )
 {
 #ifndef SYNC_WITH_SHM_FIFO
 	struct sockaddr_un sa;
@@ -275,6 +281,8 @@ bool RemotePlugin::init(const QString &pluginExecutable,
 bool RemotePlugin::process( const sampleFrame * _in_buf,
 						sampleFrame * _out_buf )
 {
+	MixerProfiler::Probe probe( MixerProfiler::RemotePluginProbe, this );
+
 	const fpp_t frames = Engine::mixer()->framesPerPeriod();
 
 	if( m_failed || !isRunning() )
@@ -305,8 +313,103 @@ bool RemotePlugin::process( const sampleFrame * _in_buf,
 		return false;
 	}
 
+	if( m_pipelined )
+	{
+		return processPipelined( _in_buf, _out_buf, frames );
+	}
+
+	if( m_processingInFlight )
+	{
+		// pipelining was just turned off - let the remote process
+		// finish the last period before touching shared memory again
+		lock();
+		waitForMessage( IdProcessingDone );
+		m_processingInFlight = false;
+		m_outputPending = false;
+		unlock();
+	}
+
 	memset( m_shm, 0, m_shmSize );
 
+	writeInput( _in_buf, frames );
+
+	lock();
+	sendMessage( IdStartProcessing );
+
+	if( m_failed || _out_buf == NULL || m_outputCount == 0 )
+	{
+		unlock();
+		return false;
+	}
+
+	waitForMessage( IdProcessingDone );
+	unlock();
+
+	readOutput( _out_buf, frames );
+
+	return true;
+}
+
+
+
+
+bool RemotePlugin::processPipelined( const sampleFrame * _in_buf,
+					sampleFrame * _out_buf, const fpp_t frames )
+{
+	lock();
+
+	// collect the previous period - usually the remote process finished
+	// it long ago while the engine was busy with everything else
+	if( m_processingInFlight )
+	{
+		waitForMessage( IdProcessingDone );
+		m_processingInFlight = false;
+	}
+
+	const bool haveOutput = m_outputPending && _out_buf != NULL &&
+						m_outputCount > 0 && !m_failed;
+	if( haveOutput )
+	{
+		readOutput( _out_buf, frames );
+	}
+	else if( _out_buf != NULL )
+	{
+		BufferManager::clear( _out_buf, frames );
+	}
+
+	// hand over this period and return without waiting for it
+	memset( m_shm, 0, m_shmSize );
+	writeInput( _in_buf, frames );
+
+	sendMessage( IdStartProcessing );
+	m_processingInFlight = !m_failed && m_outputCount > 0;
+	m_outputPending = m_processingInFlight;
+
+	unlock();
+
+	return haveOutput;
+}
+
+
+
+
+void RemotePlugin::discardPendingOutput()
+{
+	lock();
+	if( m_processingInFlight )
+	{
+		waitForMessage( IdProcessingDone );
+		m_processingInFlight = false;
+	}
+	m_outputPending = false;
+	unlock();
+}
+
+
+
+
+void RemotePlugin::writeInput( const sampleFrame * _in_buf, const fpp_t frames )
+{
 	ch_cnt_t inputs = qMin<ch_cnt_t>( m_inputCount, DEFAULT_CHANNELS );
 
 	if( _in_buf != NULL && inputs > 0 )
@@ -338,19 +441,13 @@ bool RemotePlugin::process( const sampleFrame * _in_buf,
 			}
 		}
 	}
+}
 
-	lock();
-	sendMessage( IdStartProcessing );
 
-	if( m_failed || _out_buf == NULL || m_outputCount == 0 )
-	{
-		unlock();
-		return false;
-	}
 
-	waitForMessage( IdProcessingDone );
-	unlock();
 
+void RemotePlugin::readOutput( sampleFrame * _out_buf, const fpp_t frames )
+{
 	const ch_cnt_t outputs = qMin<ch_cnt_t>( m_outputCount,
 							DEFAULT_CHANNELS );
 	if( m_splitChannels )
@@ -385,8 +482,14 @@ bool RemotePlugin::process( const sampleFrame * _in_buf,
 			}
 		}
 	}
+}
 
-	return true;
+
+
+
+f_cnt_t RemotePlugin::latency() const
+{
+	return m_pipelined ? Engine::mixer()->framesPerPeriod() : 0;
 }
 
 
@@ -456,6 +559,8 @@ void RemotePlugin::resizeSharedProcessingMemory()
 	m_shm = (float *) shmat( m_shmID, 0, 0 );
 #endif
 	m_shmSize = s;
+	// whatever was pending in the old segment is gone now
+	m_outputPending = false;
 	sendMessage( message( IdChangeSharedMemoryKey ).
 				addInt( shm_key ).addInt( m_shmSize ) );
 }
@@ -521,6 +626,11 @@ bool RemotePlugin::processMessage( const message & _m )
 			break;
 
 		case IdProcessingDone:
+			// might have been picked up by someone else waiting
+			// for a different message
+			m_processingInFlight = false;
+			break;
+
 		case IdQuit:
 		default:
 			break;
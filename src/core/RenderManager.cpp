@@ -55,6 +55,14 @@ RenderManager::~RenderManager()
 	Engine::mixer()->changeQuality( m_oldQualitySettings );
 }
 
+void RenderManager::addFormat( ProjectRenderer::ExportFileFormats fmt )
+{
+	if( fmt != m_format && !m_additionalFormats.contains( fmt ) )
+	{
+		m_additionalFormats.push_back( fmt );
+	}
+}
+
 void RenderManager::abortProcessing()
 {
 	if ( m_activeRenderer ) {
@@ -93,11 +101,13 @@ void RenderManager::renderNextTrack()
 		int trackNum = m_tracksToRender.size() + 1;
 
 		// create a renderer for this track
+		const QString path = pathForTrack(renderTrack, trackNum);
 		m_activeRenderer = new ProjectRenderer(
 				m_qualitySettings,
 				m_outputSettings,
 				m_format,
-				pathForTrack(renderTrack, trackNum));
+				path);
+		addAdditionalOutputs( path );
 
 		if ( m_activeRenderer->isReady() )
 		{
@@ -167,6 +177,7 @@ void RenderManager::renderProject()
 			m_outputSettings,
 			m_format,
 			m_outputPath);
+	addAdditionalOutputs( m_outputPath );
 
 	if( m_activeRenderer->isReady() )
 	{
@@ -208,6 +219,33 @@ QString RenderManager::pathForTrack(const Track *track, int num)
 	return QDir(m_outputPath).filePath(name);
 }
 
+// Let the active renderer encode into all additional formats as well, using
+// the main output path with the respective extension
+void RenderManager::addAdditionalOutputs( const QString & path )
+{
+	if( !m_activeRenderer->isReady() )
+	{
+		return;
+	}
+
+	QString base = path;
+	const QString extension = ProjectRenderer::getFileExtensionFromFormat( m_format );
+	if( base.endsWith( extension ) )
+	{
+		base.chop( extension.length() );
+	}
+
+	for( int i = 0; i < m_additionalFormats.size(); ++i )
+	{
+		const ProjectRenderer::ExportFileFormats fmt = m_additionalFormats[i];
+		const QString file = base + ProjectRenderer::getFileExtensionFromFormat( fmt );
+		if( !m_activeRenderer->addOutput( fmt, file ) )
+		{
+			qWarning( "Could not create output file %s", file.toUtf8().constData() );
+		}
+	}
+}
+
 void RenderManager::updateConsoleProgress()
 {
 	if ( m_activeRenderer )
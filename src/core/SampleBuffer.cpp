@@ -26,18 +26,13 @@
 
 
 #include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QFile>
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QPainter>
-
-
-#include <sndfile.h>
-
-#define OV_EXCLUDE_STATIC_CALLBACKS
-#ifdef LMMS_HAVE_OGGVORBIS
-#include <vorbis/vorbisfile.h>
-#endif
+#include <QThreadPool>
 
 #ifdef LMMS_HAVE_FLAC_STREAM_ENCODER_H
 #include <FLAC/stream_encoder.h>
@@ -49,12 +44,14 @@
 
 
 #include "base64.h"
+#include "CompactSampleData.h"
 #include "ConfigManager.h"
-#include "DrumSynth.h"
-#include "endian_handling.h"
+#include "DataFile.h"
 #include "Engine.h"
 #include "GuiApplication.h"
 #include "Mixer.h"
+#include "SampleDecoder.h"
+#include "SharedSampleData.h"
 
 #include "FileDialog.h"
 
@@ -63,7 +60,6 @@ SampleBuffer::SampleBuffer( const QString & _audio_file,
 							bool _is_base64_data ) :
 	m_audioFile( ( _is_base64_data == true ) ? "" : _audio_file ),
 	m_origData( NULL ),
-	m_origFrames( 0 ),
 	m_data( NULL ),
 	m_frames( 0 ),
 	m_startFrame( 0 ),
@@ -73,7 +69,10 @@ SampleBuffer::SampleBuffer( const QString & _audio_file,
 	m_amplification( 1.0f ),
 	m_reversed( false ),
 	m_frequency( BaseFreq ),
-	m_sampleRate( Engine::mixer()->baseSampleRate() )
+	m_sampleRate( Engine::mixer()->baseSampleRate() ),
+	m_decoder( NULL ),
+	m_compact( false ),
+	m_sharedData( NULL )
 {
 	if( _is_base64_data == true )
 	{
@@ -89,7 +88,6 @@ SampleBuffer::SampleBuffer( const QString & _audio_file,
 SampleBuffer::SampleBuffer( const sampleFrame * _data, const f_cnt_t _frames ) :
 	m_audioFile( "" ),
 	m_origData( NULL ),
-	m_origFrames( 0 ),
 	m_data( NULL ),
 	m_frames( 0 ),
 	m_startFrame( 0 ),
@@ -99,13 +97,16 @@ SampleBuffer::SampleBuffer( const sampleFrame * _data, const f_cnt_t _frames ) :
 	m_amplification( 1.0f ),
 	m_reversed( false ),
 	m_frequency( BaseFreq ),
-	m_sampleRate( Engine::mixer()->baseSampleRate() )
+	m_sampleRate( Engine::mixer()->baseSampleRate() ),
+	m_decoder( NULL ),
+	m_compact( false ),
+	m_sharedData( NULL )
 {
 	if( _frames > 0 )
 	{
-		m_origData = MM_ALLOC( sampleFrame, _frames );
-		memcpy( m_origData, _data, _frames * BYTES_PER_FRAME );
-		m_origFrames = _frames;
+		sampleFrame * data = MM_ALLOC( sampleFrame, _frames );
+		memcpy( data, _data, _frames * BYTES_PER_FRAME );
+		m_origData = new SharedSampleData( data, _frames, false );
 	}
 	connect( Engine::mixer(), SIGNAL( sampleRateChanged() ), this, SLOT( sampleRateChanged() ) );
 	update();
@@ -117,7 +118,6 @@ SampleBuffer::SampleBuffer( const sampleFrame * _data, const f_cnt_t _frames ) :
 SampleBuffer::SampleBuffer( const f_cnt_t _frames ) :
 	m_audioFile( "" ),
 	m_origData( NULL ),
-	m_origFrames( 0 ),
 	m_data( NULL ),
 	m_frames( 0 ),
 	m_startFrame( 0 ),
@@ -127,13 +127,16 @@ SampleBuffer::SampleBuffer( const f_cnt_t _frames ) :
 	m_amplification( 1.0f ),
 	m_reversed( false ),
 	m_frequency( BaseFreq ),
-	m_sampleRate( Engine::mixer()->baseSampleRate() )
+	m_sampleRate( Engine::mixer()->baseSampleRate() ),
+	m_decoder( NULL ),
+	m_compact( false ),
+	m_sharedData( NULL )
 {
 	if( _frames > 0 )
 	{
-		m_origData = MM_ALLOC( sampleFrame, _frames );
-		memset( m_origData, 0, _frames * BYTES_PER_FRAME );
-		m_origFrames = _frames;
+		sampleFrame * data = MM_ALLOC( sampleFrame, _frames );
+		memset( data, 0, _frames * BYTES_PER_FRAME );
+		m_origData = new SharedSampleData( data, _frames, false );
 	}
 	connect( Engine::mixer(), SIGNAL( sampleRateChanged() ), this, SLOT( sampleRateChanged() ) );
 	update();
@@ -144,8 +147,15 @@ SampleBuffer::SampleBuffer( const f_cnt_t _frames ) :
 
 SampleBuffer::~SampleBuffer()
 {
-	MM_FREE( m_origData );
-	MM_FREE( m_data );
+	cancelPendingLoad();
+	if( m_origData )
+	{
+		m_origData->unref();
+	}
+	if( m_sharedData )
+	{
+		m_sharedData->unref();
+	}
 }
 
 
@@ -158,470 +168,259 @@ void SampleBuffer::sampleRateChanged()
 
 void SampleBuffer::update( bool _keep_settings )
 {
-	const bool lock = ( m_data != NULL );
-	if( lock )
-	{
-		Engine::mixer()->requestChangeInModel();
-		m_varLock.lockForWrite();
-		MM_FREE( m_data );
-	}
+	// whatever is loaded in the background would be outdated now
+	cancelPendingLoad();
 
-	// File size and sample length limits
-	const int fileSizeMax = 300; // MB
-	const int sampleLengthMax = 90; // Minutes
+	SharedSampleData * data = NULL;
+	SampleDecoder::Result result = SampleDecoder::Decoded;
 
-	bool fileLoadError = false;
-	if( m_audioFile.isEmpty() && m_origData != NULL && m_origFrames > 0 )
+	if( m_audioFile.isEmpty() && m_origData != NULL )
 	{
 		// TODO: reverse- and amplification-property is not covered
 		// by following code...
-		m_data = MM_ALLOC( sampleFrame, m_origFrames );
-		memcpy( m_data, m_origData, m_origFrames * BYTES_PER_FRAME );
-		if( _keep_settings == false )
-		{
-			m_frames = m_origFrames;
-			m_loopStartFrame = m_startFrame = 0;
-			m_loopEndFrame = m_endFrame = m_frames;
-		}
+		data = m_origData->convert( m_compact );
 	}
 	else if( !m_audioFile.isEmpty() )
 	{
-		QString file = tryToMakeAbsolute( m_audioFile );
-		int_sample_t * buf = NULL;
-		sample_t * fbuf = NULL;
-		ch_cnt_t channels = DEFAULT_CHANNELS;
-		sample_rate_t samplerate = Engine::mixer()->baseSampleRate();
-		m_frames = 0;
-
-		const QFileInfo fileInfo( file );
-		if( fileInfo.size() > fileSizeMax * 1024 * 1024 )
-		{
-			fileLoadError = true;
-		}
-		else
+		const QString file = tryToMakeAbsolute( m_audioFile );
+		const QString key = fileKey( file, m_reversed );
+		data = SharedSampleData::find( key, m_compact );
+		if( data == NULL )
 		{
-			// Use QFile to handle unicode file names on Windows
-			QFile f(file);
-			f.open(QIODevice::ReadOnly);
-			SNDFILE * snd_file;
-			SF_INFO sf_info;
-			sf_info.format = 0;
-			if( ( snd_file = sf_open_fd( f.handle(), SFM_READ, &sf_info, false ) ) != NULL )
-			{
-				f_cnt_t frames = sf_info.frames;
-				int rate = sf_info.samplerate;
-				if( frames / rate > sampleLengthMax * 60 )
-				{
-					fileLoadError = true;
-				}
-				sf_close( snd_file );
-			}
-			f.close();
-		}
-
-		if( !fileLoadError )
-		{
-#ifdef LMMS_HAVE_OGGVORBIS
-			// workaround for a bug in libsndfile or our libsndfile decoder
-			// causing some OGG files to be distorted -> try with OGG Vorbis
-			// decoder first if filename extension matches "ogg"
-			if( m_frames == 0 && fileInfo.suffix() == "ogg" )
-			{
-				m_frames = decodeSampleOGGVorbis( file, buf, channels, samplerate );
-			}
-#endif
-			if( m_frames == 0 )
-			{
-				m_frames = decodeSampleSF( file, fbuf, channels,
-									samplerate );
-			}
-#ifdef LMMS_HAVE_OGGVORBIS
-			if( m_frames == 0 )
-			{
-				m_frames = decodeSampleOGGVorbis( file, buf, channels,
-									samplerate );
-			}
-#endif
-			if( m_frames == 0 )
+			// reversing a sample doesn't need decoding it again
+			SharedSampleData * other = SharedSampleData::find(
+					fileKey( file, !m_reversed ), m_compact );
+			if( other )
 			{
-				m_frames = decodeSampleDS( file, buf, channels,
-									samplerate );
+				data = other->reversed();
+				data->publish( key );
+				other->unref();
 			}
 		}
-
-		if ( m_frames == 0 || fileLoadError )  // if still no frames, bail
-		{
-			// sample couldn't be decoded, create buffer containing
-			// one sample-frame
-			m_data = MM_ALLOC( sampleFrame, 1 );
-			memset( m_data, 0, sizeof( *m_data ) );
-			m_frames = 1;
-			m_loopStartFrame = m_startFrame = 0;
-			m_loopEndFrame = m_endFrame = 1;
-		}
-		else // otherwise normalize sample rate
+		if( data == NULL )
 		{
-			normalizeSampleRate( samplerate, _keep_settings );
+			// decode before locking so the mixer keeps running
+			// meanwhile
+			SampleDecoder decoder( file,
+					Engine::mixer()->baseSampleRate(),
+					m_reversed );
+			result = decoder.decode();
+			data = takeDecodedData( decoder, key );
 		}
 	}
-	else
-	{
-		// neither an audio-file nor a buffer to copy from, so create
-		// buffer containing one sample-frame
-		m_data = MM_ALLOC( sampleFrame, 1 );
-		memset( m_data, 0, sizeof( *m_data ) );
-		m_frames = 1;
-		m_loopStartFrame = m_startFrame = 0;
-		m_loopEndFrame = m_endFrame = 1;
-	}
-
-	if( lock )
-	{
-		m_varLock.unlock();
-		Engine::mixer()->doneChangeInModel();
-	}
 
-	emit sampleUpdated();
+	setData( data, _keep_settings );
 
-	if( fileLoadError )
+	if( result == SampleDecoder::TooLarge )
 	{
-		QString title = tr( "Fail to open file" );
-		QString message = tr( "Audio files are limited to %1 MB "
-				"in size and %2 minutes of playing time"
-				).arg( fileSizeMax ).arg( sampleLengthMax );
-		if( gui )
-		{
-			QMessageBox::information( NULL,
-				title, message,	QMessageBox::Ok );
-		}
-		else
-		{
-			fprintf( stderr, "%s\n", message.toUtf8().constData() );
-		}
+		showLoadError();
 	}
 }
 
 
-void SampleBuffer::convertIntToFloat ( int_sample_t * & _ibuf, f_cnt_t _frames, int _channels)
-{
-	// following code transforms int-samples into
-	// float-samples and does amplifying & reversing
-	const float fac = 1 / OUTPUT_SAMPLE_MULTIPLIER;
-	m_data = MM_ALLOC( sampleFrame, _frames );
-	const int ch = ( _channels > 1 ) ? 1 : 0;
-
-	// if reversing is on, we also reverse when
-	// scaling
-	if( m_reversed )
-	{
-		int idx = ( _frames - 1 ) * _channels;
-		for( f_cnt_t frame = 0; frame < _frames;
-						++frame )
-		{
-			m_data[frame][0] = _ibuf[idx+0] * fac;
-			m_data[frame][1] = _ibuf[idx+ch] * fac;
-			idx -= _channels;
-		}
-	}
-	else
-	{
-		int idx = 0;
-		for( f_cnt_t frame = 0; frame < _frames;
-						++frame )
-		{
-			m_data[frame][0] = _ibuf[idx+0] * fac;
-			m_data[frame][1] = _ibuf[idx+ch] * fac;
-			idx += _channels;
-		}
-	}
-
-	delete[] _ibuf;
-}
 
-void SampleBuffer::directFloatWrite ( sample_t * & _fbuf, f_cnt_t _frames, int _channels)
 
+void SampleBuffer::loadAudioFileAsync( const QString & _audio_file )
 {
+	cancelPendingLoad();
 
-	m_data = MM_ALLOC( sampleFrame, _frames );
-	const int ch = ( _channels > 1 ) ? 1 : 0;
+	m_audioFile = tryToMakeRelative( _audio_file );
+	const QString file = tryToMakeAbsolute( m_audioFile );
+
+	SharedSampleData * data = SharedSampleData::find(
+				fileKey( file, m_reversed ), m_compact );
+	if( data )
+	{
+		setData( data, false );
+		return;
+	}
+
+	m_decoder = new SampleDecoder( file, Engine::mixer()->baseSampleRate(),
+								m_reversed );
+	connect( m_decoder, SIGNAL( progressChanged( int ) ),
+				this, SIGNAL( loadingProgress( int ) ) );
+	// finished() is emitted from the pool's thread, so both slots are
+	// queued and run in this order
+	connect( m_decoder, SIGNAL( finished() ),
+				this, SLOT( asyncLoadFinished() ) );
+	connect( m_decoder, SIGNAL( finished() ),
+				m_decoder, SLOT( deleteLater() ) );
+	QThreadPool::globalInstance()->start( m_decoder );
+}
 
-	// if reversing is on, we also reverse when
-	// scaling
-	if( m_reversed )
-	{
-		int idx = ( _frames - 1 ) * _channels;
-		for( f_cnt_t frame = 0; frame < _frames;
-						++frame )
-		{
-			m_data[frame][0] = _fbuf[idx+0];
-			m_data[frame][1] = _fbuf[idx+ch];
-			idx -= _channels;
-		}
-	}
-	else
-	{
-		int idx = 0;
-		for( f_cnt_t frame = 0; frame < _frames;
-						++frame )
-		{
-			m_data[frame][0] = _fbuf[idx+0];
-			m_data[frame][1] = _fbuf[idx+ch];
-			idx += _channels;
-		}
-	}
 
-	delete[] _fbuf;
-}
 
 
-void SampleBuffer::normalizeSampleRate( const sample_rate_t _src_sr,
-							bool _keep_settings )
+void SampleBuffer::asyncLoadFinished()
 {
-	// do samplerate-conversion to our default-samplerate
-	if( _src_sr != Engine::mixer()->baseSampleRate() )
+	SampleDecoder * decoder = qobject_cast<SampleDecoder *>( sender() );
+	if( decoder == NULL || decoder != m_decoder )
 	{
-		SampleBuffer * resampled = resample( _src_sr,
-					Engine::mixer()->baseSampleRate() );
-		MM_FREE( m_data );
-		m_frames = resampled->frames();
-		m_data = MM_ALLOC( sampleFrame, m_frames );
-		memcpy( m_data, resampled->data(), m_frames *
-							sizeof( sampleFrame ) );
-		delete resampled;
+		// superseded by another file or update() meanwhile
+		return;
 	}
+	m_decoder = NULL;
 
-	if( _keep_settings == false )
+	setData( takeDecodedData( *decoder, fileKey(
+			tryToMakeAbsolute( m_audioFile ), m_reversed ) ), false );
+
+	if( decoder->result() == SampleDecoder::TooLarge )
 	{
-		// update frame-variables
-		m_loopStartFrame = m_startFrame = 0;
-		m_loopEndFrame = m_endFrame = m_frames;
+		showLoadError();
 	}
 }
 
 
 
 
-f_cnt_t SampleBuffer::decodeSampleSF(QString _f,
-					sample_t * & _buf,
-					ch_cnt_t & _channels,
-					sample_rate_t & _samplerate )
+void SampleBuffer::cancelPendingLoad()
 {
-	SNDFILE * snd_file;
-	SF_INFO sf_info;
-	sf_info.format = 0;
-	f_cnt_t frames = 0;
-	bool sf_rr = false;
-
-
-	// Use QFile to handle unicode file names on Windows
-	QFile f(_f);
-	f.open(QIODevice::ReadOnly);
-	if( ( snd_file = sf_open_fd( f.handle(), SFM_READ, &sf_info, false ) ) != NULL )
-	{
-		frames = sf_info.frames;
-
-		_buf = new sample_t[sf_info.channels * frames];
-		sf_rr = sf_read_float( snd_file, _buf, sf_info.channels * frames );
-
-		if( sf_rr < sf_info.channels * frames )
-		{
-#ifdef DEBUG_LMMS
-			qDebug( "SampleBuffer::decodeSampleSF(): could not read"
-				" sample %s: %s", _f, sf_strerror( NULL ) );
-#endif
-		}
-		_channels = sf_info.channels;
-		_samplerate = sf_info.samplerate;
-
-		sf_close( snd_file );
-	}
-	else
-	{
-#ifdef DEBUG_LMMS
-		qDebug( "SampleBuffer::decodeSampleSF(): could not load "
-				"sample %s: %s", _f, sf_strerror( NULL ) );
-#endif
-	}
-	f.close();
-
-	//write down either directly or convert i->f depending on file type
-
-	if ( frames > 0 && _buf != NULL )
+	if( m_decoder )
 	{
-		directFloatWrite ( _buf, frames, _channels);
+		// it deletes itself once finished
+		m_decoder->cancel();
+		m_decoder = NULL;
 	}
-
-	return frames;
 }
 
 
 
 
-#ifdef LMMS_HAVE_OGGVORBIS
-
-// callback-functions for reading ogg-file
-
-size_t qfileReadCallback( void * _ptr, size_t _size, size_t _n, void * _udata )
+QString SampleBuffer::fileKey( const QString & _file, bool _reversed ) const
 {
-	return static_cast<QFile *>( _udata )->read( (char*) _ptr,
-								_size * _n );
+	// the data of a file that changed meanwhile must not be shared
+	const QFileInfo info( _file );
+	return QString( "file:%1:%2:%3:%4:%5" ).
+			arg( info.absoluteFilePath() ).
+			arg( info.size() ).
+			arg( info.lastModified().toMSecsSinceEpoch() ).
+			arg( Engine::mixer()->baseSampleRate() ).
+			arg( _reversed );
 }
 
 
 
 
-int qfileSeekCallback( void * _udata, ogg_int64_t _offset, int _whence )
+SharedSampleData * SampleBuffer::takeDecodedData( SampleDecoder & _decoder,
+							const QString & _key )
 {
-	QFile * f = static_cast<QFile *>( _udata );
-
-	if( _whence == SEEK_CUR )
-	{
-		f->seek( f->pos() + _offset );
-	}
-	else if( _whence == SEEK_END )
-	{
-		f->seek( f->size() + _offset );
-	}
-	else
+	if( _decoder.result() != SampleDecoder::Decoded )
 	{
-		f->seek( _offset );
+		return NULL;
 	}
-	return 0;
-}
-
-
 
-
-int qfileCloseCallback( void * _udata )
-{
-	delete static_cast<QFile *>( _udata );
-	return 0;
+	const f_cnt_t frames = _decoder.frames();
+	SharedSampleData * data = new SharedSampleData( _decoder.takeData(),
+							frames, m_compact );
+	data->publish( _key );
+	return data;
 }
 
 
 
 
-long qfileTellCallback( void * _udata )
+void SampleBuffer::setData( SharedSampleData * _data, bool _keep_settings )
 {
-	return static_cast<QFile *>( _udata )->pos();
-}
-
-
-
-
-f_cnt_t SampleBuffer::decodeSampleOGGVorbis( QString _f,
-						int_sample_t * & _buf,
-						ch_cnt_t & _channels,
-						sample_rate_t & _samplerate )
-{
-	static ov_callbacks callbacks =
+	if( _data == NULL )
 	{
-		qfileReadCallback,
-		qfileSeekCallback,
-		qfileCloseCallback,
-		qfileTellCallback
-	} ;
+		// neither an audio-file nor a buffer to copy from or sample
+		// couldn't be decoded, so create buffer containing one
+		// sample-frame
+		sampleFrame * silence = MM_ALLOC( sampleFrame, 1 );
+		memset( silence, 0, sizeof( *silence ) );
+		_data = new SharedSampleData( silence, 1, false );
+		_keep_settings = false;
+	}
 
-	OggVorbis_File vf;
+	SharedSampleData * oldData = m_sharedData;
 
-	f_cnt_t frames = 0;
+	const bool lock = ( oldData != NULL );
+	if( lock )
+	{
+		Engine::mixer()->requestChangeInModel();
+		m_varLock.lockForWrite();
+	}
 
-	QFile * f = new QFile( _f );
-	if( f->open( QFile::ReadOnly ) == false )
+	m_sharedData = _data;
+	m_data = _data->data();
+	m_frames = _data->frames();
+	if( _keep_settings == false )
 	{
-		delete f;
-		return 0;
+		// update frame-variables
+		m_loopStartFrame = m_startFrame = 0;
+		m_loopEndFrame = m_endFrame = m_frames;
 	}
 
-	int err = ov_open_callbacks( f, &vf, NULL, 0, callbacks );
+	if( lock )
+	{
+		m_varLock.unlock();
+		Engine::mixer()->doneChangeInModel();
+	}
 
-	if( err < 0 )
+	if( oldData )
 	{
-		switch( err )
-		{
-			case OV_EREAD:
-				printf( "SampleBuffer::decodeSampleOGGVorbis():"
-						" media read error\n" );
-				break;
-			case OV_ENOTVORBIS:
-/*				printf( "SampleBuffer::decodeSampleOGGVorbis():"
-					" not an Ogg Vorbis file\n" );*/
-				break;
-			case OV_EVERSION:
-				printf( "SampleBuffer::decodeSampleOGGVorbis():"
-						" vorbis version mismatch\n" );
-				break;
-			case OV_EBADHEADER:
-				printf( "SampleBuffer::decodeSampleOGGVorbis():"
-					" invalid Vorbis bitstream header\n" );
-				break;
-			case OV_EFAULT:
-				printf( "SampleBuffer::decodeSampleOgg(): "
-					"internal logic fault\n" );
-				break;
-		}
-		delete f;
-		return 0;
+		oldData->unref();
 	}
 
-	ov_pcm_seek( &vf, 0 );
+	emit sampleUpdated();
+}
 
-   	_channels = ov_info( &vf, -1 )->channels;
-   	_samplerate = ov_info( &vf, -1 )->rate;
 
-	ogg_int64_t total = ov_pcm_total( &vf, -1 );
 
-	_buf = new int_sample_t[total * _channels];
-	int bitstream = 0;
-	long bytes_read = 0;
 
-	do
+void SampleBuffer::setCompact( bool _on )
+{
+	if( _on == m_compact )
 	{
-		bytes_read = ov_read( &vf, (char *) &_buf[frames * _channels],
-					( total - frames ) * _channels *
-							BYTES_PER_INT_SAMPLE,
-					isLittleEndian() ? 0 : 1,
-					BYTES_PER_INT_SAMPLE, 1, &bitstream );
-		if( bytes_read < 0 )
-		{
-			break;
-		}
-		frames += bytes_read / ( _channels * BYTES_PER_INT_SAMPLE );
+		return;
 	}
-	while( bytes_read != 0 && bitstream == 0 );
-
-	ov_clear( &vf );
-	// if buffer isn't empty, convert it to float and write it down
+	m_compact = _on;
 
-	if ( frames > 0 && _buf != NULL )
+	// convert what we have right now
+	if( m_origData != NULL )
 	{
-		convertIntToFloat ( _buf, frames, _channels);
+		SharedSampleData * orig = m_origData->convert( m_compact );
+		m_origData->unref();
+		m_origData = orig;
+	}
+	if( m_frames > 1 )
+	{
+		setData( m_audioFile.isEmpty() && m_origData != NULL ?
+					m_origData->ref() :
+					m_sharedData->convert( m_compact ),
+									true );
 	}
-
-	return frames;
 }
-#endif
 
 
 
 
-f_cnt_t SampleBuffer::decodeSampleDS( QString _f,
-						int_sample_t * & _buf,
-						ch_cnt_t & _channels,
-						sample_rate_t & _samplerate )
+void SampleBuffer::readFrames( f_cnt_t _from, f_cnt_t _frames,
+						sampleFrame * _dst ) const
 {
-	DrumSynth ds;
-	f_cnt_t frames = ds.GetDSFileSamples( _f, _buf, _channels, _samplerate );
+	m_sharedData->read( _from, _frames, _dst );
+}
 
-	if ( frames > 0 && _buf != NULL )
-	{
-		convertIntToFloat ( _buf, frames, _channels);
-	}
 
-	return frames;
 
-}
 
+void SampleBuffer::showLoadError()
+{
+	QString title = tr( "Fail to open file" );
+	QString message = tr( "Audio files are limited to %1 MB "
+			"in size and %2 minutes of playing time"
+			).arg( SampleDecoder::FileSizeMax ).arg(
+					SampleDecoder::SampleLengthMax );
+	if( gui )
+	{
+		QMessageBox::information( NULL,
+			title, message,	QMessageBox::Ok );
+	}
+	else
+	{
+		fprintf( stderr, "%s\n", message.toUtf8().constData() );
+	}
+}
 
 
 
@@ -799,25 +598,29 @@ sampleFrame * SampleBuffer::getSampleFragment( f_cnt_t _index,
 		f_cnt_t _frames, LoopMode _loopmode, sampleFrame * * _tmp, bool * _backwards,
 		f_cnt_t _loopstart, f_cnt_t _loopend, f_cnt_t _end ) const
 {
-	if( _loopmode == LoopOff )
+	// compact buffers always have to be decoded to *_tmp
+	if( m_data != NULL )
 	{
-		if( _index + _frames <= _end )
+		if( _loopmode == LoopOff )
 		{
-			return m_data + _index;
+			if( _index + _frames <= _end )
+			{
+				return m_data + _index;
+			}
 		}
-	}
-	else if( _loopmode == LoopOn )
-	{
-		if( _index + _frames <= _loopend )
+		else if( _loopmode == LoopOn )
 		{
-			return m_data + _index;
+			if( _index + _frames <= _loopend )
+			{
+				return m_data + _index;
+			}
 		}
-	}
-	else
-	{
-		if( ! *_backwards && _index + _frames < _loopend )
+		else
 		{
-			return m_data + _index;
+			if( ! *_backwards && _index + _frames < _loopend )
+			{
+				return m_data + _index;
+			}
 		}
 	}
 
@@ -826,19 +629,19 @@ sampleFrame * SampleBuffer::getSampleFragment( f_cnt_t _index,
 	if( _loopmode == LoopOff )
 	{
 		f_cnt_t available = _end - _index;
-		memcpy( *_tmp, m_data + _index, available * BYTES_PER_FRAME );
+		readFrames( _index, available, *_tmp );
 		memset( *_tmp + available, 0, ( _frames - available ) *
 							BYTES_PER_FRAME );
 	}
 	else if( _loopmode == LoopOn )
 	{
 		f_cnt_t copied = qMin( _frames, _loopend - _index );
-		memcpy( *_tmp, m_data + _index, copied * BYTES_PER_FRAME );
+		readFrames( _index, copied, *_tmp );
 		f_cnt_t loop_frames = _loopend - _loopstart;
 		while( copied < _frames )
 		{
 			f_cnt_t todo = qMin( _frames - copied, loop_frames );
-			memcpy( *_tmp + copied, m_data + _loopstart, todo * BYTES_PER_FRAME );
+			readFrames( _loopstart, todo, *_tmp + copied );
 			copied += todo;
 		}
 	}
@@ -854,18 +657,14 @@ sampleFrame * SampleBuffer::getSampleFragment( f_cnt_t _index,
 		if( backwards )
 		{
 			copied = qMin( _frames, pos - _loopstart );
-			for( int i=0; i < copied; i++ )
-			{
-				(*_tmp)[i][0] = m_data[ pos - i ][0];
-				(*_tmp)[i][1] = m_data[ pos - i ][1];
-			}
+			readFramesBackwards( pos, copied, *_tmp );
 			pos -= copied;
 			if( pos == _loopstart ) backwards = false;
 		}
 		else
 		{
 			copied = qMin( _frames, _loopend - pos );
-			memcpy( *_tmp, m_data + pos, copied * BYTES_PER_FRAME );
+			readFrames( pos, copied, *_tmp );
 			pos += copied;
 			if( pos == _loopend ) backwards = true;
 		}
@@ -875,11 +674,7 @@ sampleFrame * SampleBuffer::getSampleFragment( f_cnt_t _index,
 			if( backwards )
 			{
 				f_cnt_t todo = qMin( _frames - copied, pos - _loopstart );
-				for ( int i=0; i < todo; i++ )
-				{
-					(*_tmp)[ copied + i ][0] = m_data[ pos - i ][0];
-					(*_tmp)[ copied + i ][1] = m_data[ pos - i ][1];
-				}
+				readFramesBackwards( pos, todo, *_tmp + copied );
 				pos -= todo;
 				copied += todo;
 				if( pos <= _loopstart ) backwards = false;
@@ -887,7 +682,7 @@ sampleFrame * SampleBuffer::getSampleFragment( f_cnt_t _index,
 			else
 			{
 				f_cnt_t todo = qMin( _frames - copied, _loopend - pos );
-				memcpy( *_tmp + copied, m_data + pos, todo * BYTES_PER_FRAME );
+				readFrames( pos, todo, *_tmp + copied );
 				pos += todo;
 				copied += todo;
 				if( pos >= _loopend ) backwards = true;
@@ -902,6 +697,23 @@ sampleFrame * SampleBuffer::getSampleFragment( f_cnt_t _index,
 
 
 
+void SampleBuffer::readFramesBackwards( f_cnt_t _from, f_cnt_t _frames,
+						sampleFrame * _dst ) const
+{
+	// frames _from, _from - 1, ...
+	readFrames( _from - _frames + 1, _frames, _dst );
+	for( f_cnt_t i = 0; i < _frames / 2; ++i )
+	{
+		for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+		{
+			qSwap( _dst[i][ch], _dst[_frames - 1 - i][ch] );
+		}
+	}
+}
+
+
+
+
 f_cnt_t SampleBuffer::getLoopedIndex( f_cnt_t _index, f_cnt_t _startf, f_cnt_t _endf ) const
 {
 	if( _index < _endf )
@@ -950,14 +762,37 @@ void SampleBuffer::visualize( QPainter & _p, const QRect & _dr,
 	const int xb = _dr.x();
 	const int first = focus_on_range ? _from_frame : 0;
 	const int last = focus_on_range ? _to_frame : m_frames;
+
+	// compact buffers are decoded piece by piece
+	sampleFrame * buf = m_data != NULL ? NULL :
+			MM_ALLOC( sampleFrame, CompactSampleData::BlockFrames );
+	f_cnt_t bufStart = 0;
+	f_cnt_t bufEnd = 0;
 	for( int frame = first; frame < last; frame += fpp )
 	{
+		const sampleFrame * data;
+		if( buf == NULL )
+		{
+			data = m_data + frame;
+		}
+		else
+		{
+			if( frame >= bufEnd )
+			{
+				bufStart = frame;
+				bufEnd = qMin<f_cnt_t>( last, frame +
+					CompactSampleData::BlockFrames );
+				readFrames( bufStart, bufEnd - bufStart, buf );
+			}
+			data = buf + frame - bufStart;
+		}
 		l[n] = QPointF( xb + ( (frame - first) * double( w ) / nb_frames ),
-			( yb - ( m_data[frame][0] * y_space * m_amplification ) ) );
+			( yb - ( (*data)[0] * y_space * m_amplification ) ) );
 		r[n] = QPointF( xb + ( (frame - first) * double( w ) / nb_frames ),
-			( yb - ( m_data[frame][1] * y_space * m_amplification ) ) );
+			( yb - ( (*data)[1] * y_space * m_amplification ) ) );
 		++n;
 	}
+	MM_FREE( buf );
 	_p.setRenderHint( QPainter::Antialiasing );
 	_p.drawPolyline( l, nb_frames / fpp );
 	_p.drawPolyline( r, nb_frames / fpp );
@@ -1138,12 +973,14 @@ QString & SampleBuffer::toBase64( QString & _dst ) const
 		f_cnt_t remaining = qMin<f_cnt_t>( FRAMES_PER_BUF,
 							m_frames - frame_cnt );
 		FLAC__int32 buf[FRAMES_PER_BUF * DEFAULT_CHANNELS];
+		sampleFrame frames[FRAMES_PER_BUF];
+		readFrames( frame_cnt, remaining, frames );
 		for( f_cnt_t f = 0; f < remaining; ++f )
 		{
 			for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
 			{
 				buf[f*DEFAULT_CHANNELS+ch] = (FLAC__int32)(
-					Mixer::clip( m_data[f+frame_cnt][ch] ) *
+					Mixer::clip( frames[f][ch] ) *
 						OUTPUT_SAMPLE_MULTIPLIER );
 			}
 		}
@@ -1162,8 +999,15 @@ QString & SampleBuffer::toBase64( QString & _dst ) const
 
 #else	/* LMMS_HAVE_FLAC_STREAM_ENCODER_H */
 
-	base64::encode( (const char *) m_data,
+	sampleFrame * data = NULL;
+	if( m_data == NULL )
+	{
+		data = MM_ALLOC( sampleFrame, m_frames );
+		readFrames( 0, m_frames, data );
+	}
+	base64::encode( (const char *) ( data ? data : m_data ),
 					m_frames * sizeof( sampleFrame ), _dst );
+	MM_FREE( data );
 
 #endif	/* LMMS_HAVE_FLAC_STREAM_ENCODER_H */
 
@@ -1176,12 +1020,13 @@ QString & SampleBuffer::toBase64( QString & _dst ) const
 SampleBuffer * SampleBuffer::resample( const sample_rate_t _src_sr,
 						const sample_rate_t _dst_sr )
 {
-	sampleFrame * data = m_data;
 	const f_cnt_t frames = m_frames;
+	sampleFrame * data = MM_ALLOC( sampleFrame, frames );
+	readFrames( 0, frames, data );
 	const f_cnt_t dst_frames = static_cast<f_cnt_t>( frames /
 					(float) _src_sr * (float) _dst_sr );
-	SampleBuffer * dst_sb = new SampleBuffer( dst_frames );
-	sampleFrame * dst_buf = dst_sb->m_origData;
+	sampleFrame * dst_buf = MM_ALLOC( sampleFrame, dst_frames );
+	memset( dst_buf, 0, dst_frames * BYTES_PER_FRAME );
 
 	// yeah, libsamplerate, let's rock with sinc-interpolation!
 	int error;
@@ -1207,7 +1052,9 @@ SampleBuffer * SampleBuffer::resample( const sample_rate_t _src_sr,
 	{
 		printf( "Error: src_new() failed in sample_buffer.cpp!\n" );
 	}
-	dst_sb->update();
+	SampleBuffer * dst_sb = new SampleBuffer( dst_buf, dst_frames );
+	MM_FREE( dst_buf );
+	MM_FREE( data );
 	return dst_sb;
 }
 
@@ -1316,6 +1163,80 @@ void flacStreamDecoderErrorCallback( const FLAC__StreamDecoder *,
 
 
 void SampleBuffer::loadFromBase64( const QString & _data )
+{
+	// copies of clips and undo steps store the same data over and over,
+	// so share it instead of decoding another copy
+	const QString key = "base64:" + QString( QCryptographicHash::hash(
+		QByteArray::fromRawData( (const char *) _data.constData(),
+					_data.size() * sizeof( QChar ) ),
+					QCryptographicHash::Sha1 ).toHex() );
+	SharedSampleData * orig = SharedSampleData::find( key, m_compact );
+	if( orig == NULL )
+	{
+		orig = decodeBase64( _data );
+		orig->publish( key );
+	}
+
+	setOrigData( orig );
+}
+
+
+
+
+void SampleBuffer::saveData( QDomDocument & _doc, QDomElement & _this,
+					const QString & _attribute ) const
+{
+	const DataFile::Type type = DataFile::documentType( _doc );
+	if( m_sharedData && ( type == DataFile::ClipboardData ||
+					type == DataFile::JournalData ) )
+	{
+		m_sharedData->retain( _this );
+		return;
+	}
+
+	QString s;
+	_this.setAttribute( _attribute, toBase64( s ) );
+}
+
+
+
+
+bool SampleBuffer::loadData( const QDomElement & _this,
+						const QString & _attribute )
+{
+	SharedSampleData * data = SharedSampleData::findRetained( _this );
+	if( data )
+	{
+		setOrigData( data );
+		return true;
+	}
+	if( _this.hasAttribute( _attribute ) )
+	{
+		loadFromBase64( _this.attribute( _attribute ) );
+		return true;
+	}
+	return false;
+}
+
+
+
+
+void SampleBuffer::setOrigData( SharedSampleData * _data )
+{
+	if( m_origData )
+	{
+		m_origData->unref();
+	}
+	m_origData = _data;
+
+	m_audioFile = QString();
+	update();
+}
+
+
+
+
+SharedSampleData * SampleBuffer::decodeBase64( const QString & _data ) const
 {
 	char * dst = NULL;
 	int dsize = 0;
@@ -1356,24 +1277,21 @@ void SampleBuffer::loadFromBase64( const QString & _data )
 	orig_data = ba_writer.buffer();
 	printf("%d\n", (int) orig_data.size() );
 
-	m_origFrames = orig_data.size() / sizeof( sampleFrame );
-	MM_FREE( m_origData );
-	m_origData = MM_ALLOC( sampleFrame, m_origFrames );
-	memcpy( m_origData, orig_data.data(), orig_data.size() );
+	const f_cnt_t frames = orig_data.size() / sizeof( sampleFrame );
+	sampleFrame * data = MM_ALLOC( sampleFrame, frames );
+	memcpy( data, orig_data.data(), frames * sizeof( sampleFrame ) );
 
 #else /* LMMS_HAVE_FLAC_STREAM_DECODER_H */
 
-	m_origFrames = dsize / sizeof( sampleFrame );
-	MM_FREE( m_origData );
-	m_origData = MM_ALLOC( sampleFrame, m_origFrames );
-	memcpy( m_origData, dst, dsize );
+	const f_cnt_t frames = dsize / sizeof( sampleFrame );
+	sampleFrame * data = MM_ALLOC( sampleFrame, frames );
+	memcpy( data, dst, frames * sizeof( sampleFrame ) );
 
 #endif
 
 	delete[] dst;
 
-	m_audioFile = QString();
-	update();
+	return new SharedSampleData( data, frames, m_compact );
 }
 
 
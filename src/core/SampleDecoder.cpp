@@ -0,0 +1,660 @@
+/*
+ * SampleDecoder.cpp - decodes audio files into sample data at a given rate
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SampleDecoder.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <cstring>
+
+#include <sndfile.h>
+
+#define OV_EXCLUDE_STATIC_CALLBACKS
+#ifdef LMMS_HAVE_OGGVORBIS
+#include <vorbis/vorbisfile.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "DrumSynth.h"
+#include "endian_handling.h"
+#include "Mixer.h"
+
+
+// number of frames converted and resampled at once
+static const f_cnt_t BlockSize = 4096;
+
+
+
+SampleDecoder::SampleDecoder( const QString & _file,
+					sample_rate_t _sample_rate, bool _reversed ) :
+	m_file( _file ),
+	m_sampleRate( _sample_rate ),
+	m_reversed( _reversed ),
+	m_cancelled( 0 ),
+	m_progress( 0 ),
+	m_data( NULL ),
+	m_frames( 0 ),
+	m_capacity( 0 ),
+	m_inputFrames( 0 ),
+	m_inputDone( 0 ),
+	m_resampler( NULL ),
+	m_ratio( 1.0 ),
+	m_result( Failed )
+{
+	setAutoDelete( false );
+}
+
+
+
+
+SampleDecoder::~SampleDecoder()
+{
+	MM_FREE( m_data );
+}
+
+
+
+
+SampleDecoder::Result SampleDecoder::decode()
+{
+	const QFileInfo fileInfo( m_file );
+	if( fileInfo.size() > (qint64) FileSizeMax * 1024 * 1024 )
+	{
+		m_result = TooLarge;
+		return m_result;
+	}
+
+	m_result = Failed;
+#ifdef LMMS_HAVE_OGGVORBIS
+	// workaround for a bug in libsndfile or our libsndfile decoder
+	// causing some OGG files to be distorted -> try with OGG Vorbis
+	// decoder first if filename extension matches "ogg"
+	if( fileInfo.suffix() == "ogg" )
+	{
+		m_result = decodeOggVorbis();
+	}
+#endif
+	if( m_result == Failed )
+	{
+		m_result = decodeSndfile();
+	}
+#ifdef LMMS_HAVE_OGGVORBIS
+	if( m_result == Failed )
+	{
+		m_result = decodeOggVorbis();
+	}
+#endif
+	if( m_result == Failed )
+	{
+		m_result = decodeDrumSynth();
+	}
+
+	if( m_result != Decoded )
+	{
+		MM_FREE( m_data );
+		m_data = NULL;
+		m_frames = 0;
+	}
+
+	return m_result;
+}
+
+
+
+
+void SampleDecoder::cancel()
+{
+	m_cancelled.fetchAndStoreOrdered( 1 );
+}
+
+
+
+
+int SampleDecoder::progress() const
+{
+	return m_progress;
+}
+
+
+
+
+sampleFrame * SampleDecoder::takeData()
+{
+	sampleFrame * data = m_data;
+	m_data = NULL;
+	return data;
+}
+
+
+
+
+void SampleDecoder::run()
+{
+	decode();
+	emit finished();
+}
+
+
+
+
+void SampleDecoder::toStereo( const float * _src, sampleFrame * _dst,
+					f_cnt_t _frames, int _channels )
+{
+	if( _channels == DEFAULT_CHANNELS )
+	{
+		// interleaved stereo already has the layout of sampleFrame
+		memcpy( _dst, _src, _frames * sizeof( sampleFrame ) );
+		return;
+	}
+
+	f_cnt_t f = 0;
+	if( _channels == 1 )
+	{
+#ifdef __SSE2__
+		float * dst = _dst[0];
+		for( ; f + 4 <= _frames; f += 4 )
+		{
+			const __m128 in = _mm_loadu_ps( _src + f );
+			_mm_storeu_ps( dst + 2 * f, _mm_unpacklo_ps( in, in ) );
+			_mm_storeu_ps( dst + 2 * f + 4, _mm_unpackhi_ps( in, in ) );
+		}
+#endif
+		for( ; f < _frames; ++f )
+		{
+			_dst[f][0] = _dst[f][1] = _src[f];
+		}
+		return;
+	}
+
+	for( ; f < _frames; ++f )
+	{
+		_dst[f][0] = _src[f * _channels];
+		_dst[f][1] = _src[f * _channels + 1];
+	}
+}
+
+
+
+
+void SampleDecoder::toStereo( const int_sample_t * _src, sampleFrame * _dst,
+					f_cnt_t _frames, int _channels )
+{
+	const float fac = 1 / OUTPUT_SAMPLE_MULTIPLIER;
+	float * dst = _dst[0];
+	f_cnt_t f = 0;
+
+	if( _channels == DEFAULT_CHANNELS )
+	{
+#ifdef __SSE2__
+		const __m128 scale = _mm_set1_ps( fac );
+		for( ; f + 4 <= _frames; f += 4 )
+		{
+			// sign-extend 8 samples to 32 bit by putting them into
+			// the upper half and shifting them down again
+			const __m128i in = _mm_loadu_si128(
+				reinterpret_cast<const __m128i *>( _src + 2 * f ) );
+			const __m128i lo = _mm_srai_epi32( _mm_unpacklo_epi16( in, in ), 16 );
+			const __m128i hi = _mm_srai_epi32( _mm_unpackhi_epi16( in, in ), 16 );
+			_mm_storeu_ps( dst + 2 * f, _mm_mul_ps( _mm_cvtepi32_ps( lo ), scale ) );
+			_mm_storeu_ps( dst + 2 * f + 4, _mm_mul_ps( _mm_cvtepi32_ps( hi ), scale ) );
+		}
+#endif
+		for( ; f < _frames; ++f )
+		{
+			_dst[f][0] = _src[2 * f] * fac;
+			_dst[f][1] = _src[2 * f + 1] * fac;
+		}
+		return;
+	}
+
+	if( _channels == 1 )
+	{
+#ifdef __SSE2__
+		const __m128 scale = _mm_set1_ps( fac );
+		for( ; f + 8 <= _frames; f += 8 )
+		{
+			const __m128i in = _mm_loadu_si128(
+				reinterpret_cast<const __m128i *>( _src + f ) );
+			const __m128 lo = _mm_mul_ps( _mm_cvtepi32_ps(
+				_mm_srai_epi32( _mm_unpacklo_epi16( in, in ), 16 ) ), scale );
+			const __m128 hi = _mm_mul_ps( _mm_cvtepi32_ps(
+				_mm_srai_epi32( _mm_unpackhi_epi16( in, in ), 16 ) ), scale );
+			_mm_storeu_ps( dst + 2 * f, _mm_unpacklo_ps( lo, lo ) );
+			_mm_storeu_ps( dst + 2 * f + 4, _mm_unpackhi_ps( lo, lo ) );
+			_mm_storeu_ps( dst + 2 * f + 8, _mm_unpacklo_ps( hi, hi ) );
+			_mm_storeu_ps( dst + 2 * f + 12, _mm_unpackhi_ps( hi, hi ) );
+		}
+#endif
+		for( ; f < _frames; ++f )
+		{
+			_dst[f][0] = _dst[f][1] = _src[f] * fac;
+		}
+		return;
+	}
+
+	for( ; f < _frames; ++f )
+	{
+		_dst[f][0] = _src[f * _channels] * fac;
+		_dst[f][1] = _src[f * _channels + 1] * fac;
+	}
+}
+
+
+
+
+SampleDecoder::Result SampleDecoder::decodeSndfile()
+{
+	// Use QFile to handle unicode file names on Windows
+	QFile f( m_file );
+	if( f.open( QIODevice::ReadOnly ) == false )
+	{
+		return Failed;
+	}
+
+	SF_INFO sf_info;
+	sf_info.format = 0;
+	SNDFILE * snd_file = sf_open_fd( f.handle(), SFM_READ, &sf_info, false );
+	if( snd_file == NULL )
+	{
+#ifdef LMMS_DEBUG
+		qDebug( "SampleDecoder::decodeSndfile(): could not load "
+				"sample %s: %s", qPrintable( m_file ),
+						sf_strerror( NULL ) );
+#endif
+		return Failed;
+	}
+
+	Result result = Failed;
+	if( sf_info.samplerate > 0 &&
+		sf_info.frames / sf_info.samplerate > SampleLengthMax * 60 )
+	{
+		result = TooLarge;
+	}
+	else if( begin( sf_info.frames, sf_info.samplerate ) )
+	{
+		float * in = new float[BlockSize * sf_info.channels];
+		sampleFrame * block = MM_ALLOC( sampleFrame, BlockSize );
+
+		result = Decoded;
+		sf_count_t frames;
+		while( ( frames = sf_readf_float( snd_file, in, BlockSize ) ) > 0 )
+		{
+			toStereo( in, block, frames, sf_info.channels );
+			if( write( block, frames ) == false )
+			{
+				result = Cancelled;
+				break;
+			}
+		}
+		end();
+
+		MM_FREE( block );
+		delete[] in;
+	}
+
+	sf_close( snd_file );
+
+	return result == Decoded && m_frames == 0 ? Failed : result;
+}
+
+
+
+
+#ifdef LMMS_HAVE_OGGVORBIS
+
+// callback-functions for reading ogg-file
+
+static size_t qfileReadCallback( void * _ptr, size_t _size, size_t _n, void * _udata )
+{
+	return static_cast<QFile *>( _udata )->read( (char*) _ptr,
+								_size * _n );
+}
+
+
+
+
+static int qfileSeekCallback( void * _udata, ogg_int64_t _offset, int _whence )
+{
+	QFile * f = static_cast<QFile *>( _udata );
+
+	if( _whence == SEEK_CUR )
+	{
+		f->seek( f->pos() + _offset );
+	}
+	else if( _whence == SEEK_END )
+	{
+		f->seek( f->size() + _offset );
+	}
+	else
+	{
+		f->seek( _offset );
+	}
+	return 0;
+}
+
+
+
+
+static int qfileCloseCallback( void * _udata )
+{
+	delete static_cast<QFile *>( _udata );
+	return 0;
+}
+
+
+
+
+static long qfileTellCallback( void * _udata )
+{
+	return static_cast<QFile *>( _udata )->pos();
+}
+
+
+
+
+SampleDecoder::Result SampleDecoder::decodeOggVorbis()
+{
+	static ov_callbacks callbacks =
+	{
+		qfileReadCallback,
+		qfileSeekCallback,
+		qfileCloseCallback,
+		qfileTellCallback
+	} ;
+
+	OggVorbis_File vf;
+
+	QFile * f = new QFile( m_file );
+	if( f->open( QFile::ReadOnly ) == false )
+	{
+		delete f;
+		return Failed;
+	}
+
+	int err = ov_open_callbacks( f, &vf, NULL, 0, callbacks );
+
+	if( err < 0 )
+	{
+		switch( err )
+		{
+			case OV_EREAD:
+				printf( "SampleDecoder::decodeOggVorbis():"
+						" media read error\n" );
+				break;
+			case OV_ENOTVORBIS:
+				break;
+			case OV_EVERSION:
+				printf( "SampleDecoder::decodeOggVorbis():"
+						" vorbis version mismatch\n" );
+				break;
+			case OV_EBADHEADER:
+				printf( "SampleDecoder::decodeOggVorbis():"
+					" invalid Vorbis bitstream header\n" );
+				break;
+			case OV_EFAULT:
+				printf( "SampleDecoder::decodeOggVorbis(): "
+					"internal logic fault\n" );
+				break;
+		}
+		delete f;
+		return Failed;
+	}
+
+	ov_pcm_seek( &vf, 0 );
+
+	const int channels = ov_info( &vf, -1 )->channels;
+	const long rate = ov_info( &vf, -1 )->rate;
+	const ogg_int64_t total = ov_pcm_total( &vf, -1 );
+
+	Result result = Failed;
+	if( rate > 0 && total / rate > SampleLengthMax * 60 )
+	{
+		result = TooLarge;
+	}
+	else if( begin( total, rate ) )
+	{
+		int_sample_t * in = new int_sample_t[BlockSize * channels];
+		sampleFrame * block = MM_ALLOC( sampleFrame, BlockSize );
+
+		result = Decoded;
+		int bitstream = 0;
+		do
+		{
+			const long bytes = ov_read( &vf, (char *) in,
+					BlockSize * channels * BYTES_PER_INT_SAMPLE,
+					isLittleEndian() ? 0 : 1,
+					BYTES_PER_INT_SAMPLE, 1, &bitstream );
+			if( bytes <= 0 )
+			{
+				break;
+			}
+			const f_cnt_t frames = bytes /
+					( channels * BYTES_PER_INT_SAMPLE );
+			toStereo( in, block, frames, channels );
+			if( write( block, frames ) == false )
+			{
+				result = Cancelled;
+				break;
+			}
+		}
+		while( bitstream == 0 );
+		end();
+
+		MM_FREE( block );
+		delete[] in;
+	}
+
+	ov_clear( &vf );
+
+	return result == Decoded && m_frames == 0 ? Failed : result;
+}
+
+#endif
+
+
+
+
+SampleDecoder::Result SampleDecoder::decodeDrumSynth()
+{
+	// DrumSynth renders at the requested rate right away
+	DrumSynth ds;
+	int_sample_t * buf = NULL;
+	const f_cnt_t frames = ds.GetDSFileSamples( m_file, buf,
+						DEFAULT_CHANNELS, m_sampleRate );
+
+	Result result = Failed;
+	if( frames > 0 && buf != NULL && begin( frames, m_sampleRate ) )
+	{
+		sampleFrame * block = MM_ALLOC( sampleFrame, BlockSize );
+
+		result = Decoded;
+		for( f_cnt_t f = 0; f < frames; f += BlockSize )
+		{
+			const f_cnt_t n = qMin( BlockSize, frames - f );
+			toStereo( buf + f * DEFAULT_CHANNELS, block, n,
+							DEFAULT_CHANNELS );
+			if( write( block, n ) == false )
+			{
+				result = Cancelled;
+				break;
+			}
+		}
+		end();
+
+		MM_FREE( block );
+	}
+	delete[] buf;
+
+	return result;
+}
+
+
+
+
+bool SampleDecoder::begin( f_cnt_t _frames, sample_rate_t _sample_rate )
+{
+	MM_FREE( m_data );
+	m_data = NULL;
+	m_frames = 0;
+
+	if( _frames <= 0 || _sample_rate <= 0 )
+	{
+		return false;
+	}
+
+	m_ratio = (double) m_sampleRate / _sample_rate;
+	m_inputFrames = _frames;
+	m_inputDone = 0;
+	m_capacity = static_cast<f_cnt_t>( _frames * m_ratio ) + 1;
+	if( m_capacity <= 0 )
+	{
+		return false;
+	}
+	m_data = MM_ALLOC( sampleFrame, m_capacity );
+
+	if( _sample_rate != m_sampleRate )
+	{
+		// yeah, libsamplerate, let's rock with sinc-interpolation!
+		int error;
+		if( ( m_resampler = src_new( SRC_SINC_MEDIUM_QUALITY,
+					DEFAULT_CHANNELS, &error ) ) == NULL )
+		{
+			printf( "SampleDecoder: src_new() failed: %s\n",
+							src_strerror( error ) );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+
+
+bool SampleDecoder::write( const sampleFrame * _block, f_cnt_t _frames )
+{
+	if( isCancelled() )
+	{
+		return false;
+	}
+
+	if( m_resampler )
+	{
+		resample( _block, _frames, false );
+	}
+	else
+	{
+		// the header may have reported fewer frames than there are
+		const f_cnt_t frames = qMin( _frames, m_capacity - m_frames );
+		memcpy( m_data + m_frames, _block, frames * sizeof( sampleFrame ) );
+		m_frames += frames;
+	}
+
+	m_inputDone += _frames;
+	const int progress = qMin<qint64>( 99, (qint64) m_inputDone * 100 / m_inputFrames );
+	if( progress != m_progress )
+	{
+		m_progress.fetchAndStoreOrdered( progress );
+		emit progressChanged( progress );
+	}
+
+	return true;
+}
+
+
+
+
+void SampleDecoder::resample( const sampleFrame * _block, f_cnt_t _frames,
+							bool _end_of_input )
+{
+	SRC_DATA src_data;
+	src_data.data_in = (float *) _block[0];
+	src_data.input_frames = _frames;
+	src_data.src_ratio = m_ratio;
+	src_data.end_of_input = _end_of_input ? 1 : 0;
+
+	while( m_frames < m_capacity )
+	{
+		src_data.data_out = m_data[m_frames];
+		src_data.output_frames = m_capacity - m_frames;
+		const int error = src_process( m_resampler, &src_data );
+		if( error )
+		{
+			printf( "SampleDecoder: error while resampling: %s\n",
+							src_strerror( error ) );
+			break;
+		}
+		m_frames += src_data.output_frames_gen;
+		src_data.data_in += src_data.input_frames_used * DEFAULT_CHANNELS;
+		src_data.input_frames -= src_data.input_frames_used;
+
+		// everything consumed and - at the end - nothing buffered
+		// inside the resampler anymore?
+		if( ( src_data.input_frames == 0 && !_end_of_input ) ||
+			( src_data.input_frames_used == 0 &&
+					src_data.output_frames_gen == 0 ) )
+		{
+			break;
+		}
+	}
+}
+
+
+
+
+void SampleDecoder::end()
+{
+	if( m_resampler )
+	{
+		// flush what is still buffered inside the resampler
+		static const sampleFrame silence = { 0, 0 };
+		resample( &silence, 0, true );
+		src_delete( m_resampler );
+		m_resampler = NULL;
+	}
+
+	if( m_reversed )
+	{
+		for( f_cnt_t f = 0; f < m_frames / 2; ++f )
+		{
+			for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+			{
+				qSwap( m_data[f][ch], m_data[m_frames - 1 - f][ch] );
+			}
+		}
+	}
+
+	m_progress.fetchAndStoreOrdered( 100 );
+	emit progressChanged( 100 );
+}
+
+
+
+
+bool SampleDecoder::isCancelled() const
+{
+	return m_cancelled != 0;
+}
@@ -0,0 +1,264 @@
+/*
+ * SharedSampleData.cpp - immutable sample data shared between SampleBuffers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SharedSampleData.h"
+
+#include <cstring>
+
+#include "CompactSampleData.h"
+
+
+const char * const SharedSampleData::RETAINED_ATTRIBUTE = "sampledataref";
+
+QMutex SharedSampleData::s_lock;
+QHash<QString, SharedSampleData *> SharedSampleData::s_registry;
+QHash<QString, SharedSampleData *> SharedSampleData::s_retained;
+int SharedSampleData::s_lastRetainedKey = 0;
+
+
+
+
+SharedSampleData::SharedSampleData( sampleFrame * _data, f_cnt_t _frames,
+							bool _compact ) :
+	m_data( _data ),
+	m_compactData( NULL ),
+	m_frames( _frames ),
+	m_referenceCount( 1 ),
+	m_retainCount( 0 )
+{
+	if( _compact )
+	{
+		m_compactData = new CompactSampleData( m_data, m_frames );
+		MM_FREE( m_data );
+		m_data = NULL;
+	}
+}
+
+
+
+
+SharedSampleData::~SharedSampleData()
+{
+	MM_FREE( m_data );
+	delete m_compactData;
+}
+
+
+
+
+SharedSampleData * SharedSampleData::find( const QString & _key,
+							bool _compact )
+{
+	QMutexLocker lock( &s_lock );
+
+	SharedSampleData * data = s_registry.value(
+					registryKey( _key, _compact ), NULL );
+	if( data )
+	{
+		++data->m_referenceCount;
+	}
+	return data;
+}
+
+
+
+
+void SharedSampleData::publish( const QString & _key )
+{
+	QMutexLocker lock( &s_lock );
+
+	const QString key = registryKey( _key, isCompact() );
+	if( m_key.isEmpty() && !s_registry.contains( key ) )
+	{
+		m_key = key;
+		s_registry.insert( key, this );
+	}
+}
+
+
+
+
+SharedSampleData * SharedSampleData::ref()
+{
+	QMutexLocker lock( &s_lock );
+
+	++m_referenceCount;
+	return this;
+}
+
+
+
+
+void SharedSampleData::unref()
+{
+	s_lock.lock();
+	const bool deleteData = --m_referenceCount <= 0;
+	if( deleteData && !m_key.isEmpty() )
+	{
+		s_registry.remove( m_key );
+	}
+	s_lock.unlock();
+
+	if( deleteData )
+	{
+		delete this;
+	}
+}
+
+
+
+
+SharedSampleData * SharedSampleData::convert( bool _compact )
+{
+	if( isCompact() == _compact )
+	{
+		return ref();
+	}
+
+	// the key stored is the one of the registry, strip the storage
+	const QString key = m_key.left( m_key.lastIndexOf( '#' ) );
+	if( !m_key.isEmpty() )
+	{
+		SharedSampleData * converted = find( key, _compact );
+		if( converted )
+		{
+			return converted;
+		}
+	}
+
+	sampleFrame * data = MM_ALLOC( sampleFrame, m_frames );
+	read( 0, m_frames, data );
+	SharedSampleData * converted = new SharedSampleData( data, m_frames,
+								_compact );
+	if( !m_key.isEmpty() )
+	{
+		converted->publish( key );
+	}
+	return converted;
+}
+
+
+
+
+SharedSampleData * SharedSampleData::reversed() const
+{
+	sampleFrame * data = MM_ALLOC( sampleFrame, m_frames );
+	read( 0, m_frames, data );
+	for( f_cnt_t f = 0; f < m_frames / 2; ++f )
+	{
+		for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+		{
+			qSwap( data[f][ch], data[m_frames - 1 - f][ch] );
+		}
+	}
+	return new SharedSampleData( data, m_frames, isCompact() );
+}
+
+
+
+
+void SharedSampleData::retain( QDomElement & _elem )
+{
+	QMutexLocker lock( &s_lock );
+
+	if( m_retainCount++ == 0 )
+	{
+		// all retains share one reference
+		++m_referenceCount;
+		m_retainedKey = QString::number( ++s_lastRetainedKey );
+		s_retained.insert( m_retainedKey, this );
+	}
+	_elem.setAttribute( RETAINED_ATTRIBUTE, m_retainedKey );
+}
+
+
+
+
+SharedSampleData * SharedSampleData::findRetained( const QDomElement & _elem )
+{
+	QMutexLocker lock( &s_lock );
+
+	SharedSampleData * data = s_retained.value(
+				_elem.attribute( RETAINED_ATTRIBUTE ), NULL );
+	if( data )
+	{
+		++data->m_referenceCount;
+	}
+	return data;
+}
+
+
+
+
+void SharedSampleData::releaseRetained( const QDomElement & _elem )
+{
+	for( QDomElement child = _elem.firstChildElement(); !child.isNull();
+					child = child.nextSiblingElement() )
+	{
+		releaseRetained( child );
+	}
+
+	if( !_elem.hasAttribute( RETAINED_ATTRIBUTE ) )
+	{
+		return;
+	}
+
+	s_lock.lock();
+	SharedSampleData * data = s_retained.value(
+				_elem.attribute( RETAINED_ATTRIBUTE ), NULL );
+	const bool lastRetain = data && --data->m_retainCount == 0;
+	if( lastRetain )
+	{
+		s_retained.remove( data->m_retainedKey );
+		data->m_retainedKey = QString();
+	}
+	s_lock.unlock();
+
+	if( lastRetain )
+	{
+		data->unref();
+	}
+}
+
+
+
+
+void SharedSampleData::read( f_cnt_t _from, f_cnt_t _frames,
+						sampleFrame * _dst ) const
+{
+	if( m_compactData )
+	{
+		m_compactData->read( _from, _frames, _dst );
+	}
+	else
+	{
+		memcpy( _dst, m_data + _from, _frames * sizeof( sampleFrame ) );
+	}
+}
+
+
+
+
+QString SharedSampleData::registryKey( const QString & _key, bool _compact )
+{
+	return _key + ( _compact ? "#compact" : "#plain" );
+}
@@ -95,8 +95,8 @@ Song::Song() :
 	m_elapsedTicks( 0 ),
 	m_elapsedTacts( 0 )
 {
-	connect( &m_tempoModel, SIGNAL( dataChanged() ),
-						this, SLOT( setTempo() ) );
+	// tempo automation has to take effect in the period it's played in
+	m_tempoModel.addValueListener( [this]() { setTempo(); } );
 	connect( &m_tempoModel, SIGNAL( dataUnchanged() ),
 						this, SLOT( setTempo() ) );
 	connect( &m_timeSigModel, SIGNAL( dataChanged() ),
@@ -1540,7 +1540,10 @@ void Song::removeController( Controller * controller )
 		m_controllers.remove( index );
 
 		emit controllerRemoved( controller );
+
+		Engine::mixer()->requestChangeInModel();
 		delete controller;
+		Engine::mixer()->doneChangeInModel();
 
 		this->setModified();
 	}
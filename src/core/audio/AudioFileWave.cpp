@@ -36,7 +36,9 @@ AudioFileWave::AudioFileWave( OutputSettings const & outputSettings,
 				const QString & file,
 				Mixer* mixer ) :
 	AudioFileDevice( outputSettings, channels, file, mixer ),
-	m_sf( NULL )
+	m_sf( NULL ),
+	m_floatBuffer( NULL ),
+	m_intBuffer( NULL )
 {
 	successful = outputFileOpened() && startEncoding();
 }
@@ -47,6 +49,9 @@ AudioFileWave::AudioFileWave( OutputSettings const & outputSettings,
 AudioFileWave::~AudioFileWave()
 {
 	finishEncoding();
+
+	delete[] m_floatBuffer;
+	delete[] m_intBuffer;
 }
 
 
@@ -62,17 +67,22 @@ bool AudioFileWave::startEncoding()
 
 	m_si.format = SF_FORMAT_WAV;
 
+	const int bufferSize = mixer()->framesPerPeriod() * channels();
+
 	switch( getOutputSettings().getBitDepth() )
 	{
 	case OutputSettings::Depth_32Bit:
 		m_si.format |= SF_FORMAT_FLOAT;
+		m_floatBuffer = new float[bufferSize];
 		break;
 	case OutputSettings::Depth_24Bit:
 		m_si.format |= SF_FORMAT_PCM_24;
+		m_floatBuffer = new float[bufferSize];
 		break;
 	case OutputSettings::Depth_16Bit:
 	default:
 		m_si.format |= SF_FORMAT_PCM_16;
+		m_intBuffer = new int_sample_t[bufferSize];
 		break;
 	}
 
@@ -100,11 +110,9 @@ void AudioFileWave::writeBuffer( const surroundSampleFrame * _ab,
 						const fpp_t _frames,
 						const float _master_gain )
 {
-	OutputSettings::BitDepth bitDepth = getOutputSettings().getBitDepth();
-
-	if( bitDepth == OutputSettings::Depth_32Bit || bitDepth == OutputSettings::Depth_24Bit )
+	if( m_floatBuffer )
 	{
-		float *  buf = new float[_frames*channels()];
+		float * buf = m_floatBuffer;
 		for( fpp_t frame = 0; frame < _frames; ++frame )
 		{
 			for( ch_cnt_t chnl = 0; chnl < channels(); ++chnl )
@@ -114,16 +122,13 @@ void AudioFileWave::writeBuffer( const surroundSampleFrame * _ab,
 			}
 		}
 		sf_writef_float( m_sf, buf, _frames );
-		delete[] buf;
 	}
 	else
 	{
-		int_sample_t * buf = new int_sample_t[_frames * channels()];
-		convertToS16( _ab, _frames, _master_gain, buf,
+		convertToS16( _ab, _frames, _master_gain, m_intBuffer,
 							!isLittleEndian() );
 
-		sf_writef_short( m_sf, buf, _frames );
-		delete[] buf;
+		sf_writef_short( m_sf, m_intBuffer, _frames );
 	}
 }
 
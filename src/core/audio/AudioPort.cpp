@@ -28,6 +28,7 @@
 #include "FxMixer.h"
 #include "Engine.h"
 #include "Mixer.h"
+#include "MixerProfiler.h"
 #include "MixHelpers.h"
 #include "BufferManager.h"
 
@@ -41,6 +42,8 @@ AudioPort::AudioPort( const QString & _name, bool _has_effect_chain,
 	m_nextFxChannel( 0 ),
 	m_name( "unnamed port" ),
 	m_effects( _has_effect_chain ? new EffectChain( NULL ) : NULL ),
+	m_sourceLatency( 0 ),
+	m_compensation(),
 	m_volumeModel( volumeModel ),
 	m_panningModel( panningModel ),
 	m_mutedModel( mutedModel )
@@ -102,6 +105,14 @@ bool AudioPort::processEffects()
 }
 
 
+f_cnt_t AudioPort::latency() const
+{
+	return m_sourceLatency + ( m_effects ? m_effects->latency() : 0 );
+}
+
+
+
+
 void AudioPort::doProcessing()
 {
 	if( m_mutedModel && m_mutedModel->value() )
@@ -109,6 +120,8 @@ void AudioPort::doProcessing()
 		return;
 	}
 
+	MixerProfiler::Probe probe( MixerProfiler::AudioPortProbe, this );
+
 	const fpp_t fpp = Engine::mixer()->framesPerPeriod();
 
 	// clear the buffer
@@ -221,12 +234,16 @@ void AudioPort::doProcessing()
 
 	// handle effects
 	const bool me = processEffects();
-	if( me || m_bufferUsage )
+
+	// delay the output if other paths into the same FX channel have
+	// higher latency - this also flushes the delayed tail once we're silent
+	if( m_compensation.process( m_portBuffer, m_portBuffer, fpp,
+							me || m_bufferUsage ) )
 	{
 		Engine::fxMixer()->mixToChannel( m_portBuffer, m_nextFxChannel ); 	// send output to fx mixer
 																			// TODO: improve the flow here - convert to pull model
-		m_bufferUsage = false;
 	}
+	m_bufferUsage = false;
 }
 
 
@@ -128,6 +128,8 @@ void printHelp()
 		"          caution).\n"
 		"  -c, --config <configfile>      Get the configuration from <configfile>\n"
 		"  -h, --help                     Show this usage information and exit.\n"
+		"      --trace <out>              Write a timing trace of all tracks,\n"
+		"          effects and FX channels to <out> (Chrome trace format)\n"
 		"  -v, --version                  Show version information and exit.\n"
 		"\nOptions if no action is given:\n"
 		"      --geometry <geometry>      Specify the size and position of\n"
@@ -139,8 +141,17 @@ void printHelp()
 		"  -a, --float                    Use 32bit float bit depth\n"
 		"  -b, --bitrate <bitrate>        Specify output bitrate in KBit/s\n"
 		"          Default: 160.\n"
+		"      --blocksize <frames>       Render in blocks of <frames> frames\n"
+		"          instead of the default period size. Larger blocks\n"
+		"          (e.g. 4096) render faster, but automation is\n"
+		"          applied only once per block and knobs without\n"
+		"          sample exact controller support follow controllers\n"
+		"          only once per block, so fast sweeps sound stepped.\n"
+		"          Range: 32 to 4096\n"
 		"  -f, --format <format>         Specify format of render-output where\n"
 		"          Format is either 'wav', 'flac', 'ogg' or 'mp3'.\n"
+		"          Several comma separated formats (e.g. 'wav,mp3') are\n"
+		"          encoded at once from the same rendering.\n"
 		"  -i, --interpolation <method>   Specify interpolation method\n"
 		"          Possible values:\n"
 		"            - linear\n"
@@ -209,6 +220,7 @@ int main( int argc, char * * argv )
 	bool renderLoop = false;
 	bool renderTracks = false;
 	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, configFile;
+	QString traceOutputFile;
 
 	// first of two command-line parsing stages
 	for( int i = 1; i < argc; ++i )
@@ -266,6 +278,8 @@ int main( int argc, char * * argv )
 	Mixer::qualitySettings qs( Mixer::qualitySettings::Mode_HighQuality );
 	OutputSettings os( 44100, OutputSettings::BitRateSettings(160, false), OutputSettings::Depth_16Bit, OutputSettings::StereoMode_JointStereo );
 	ProjectRenderer::ExportFileFormats eff = ProjectRenderer::WaveFile;
+	QVector<ProjectRenderer::ExportFileFormats> additionalFormats;
+	fpp_t renderBlockSize = 0;
 
 	// second of two command-line parsing stages
 	for( int i = 1; i < argc; ++i )
@@ -385,27 +399,70 @@ int main( int argc, char * * argv )
 			}
 
 
-			const QString ext = QString( argv[i] );
+			// several formats can be given separated by commas, the
+			// first one determines the main output file
+			const QStringList exts = QString( argv[i] ).split( ',' );
+			additionalFormats.clear();
 
-			if( ext == "wav" )
+			for( int e = 0; e < exts.size(); ++e )
 			{
-				eff = ProjectRenderer::WaveFile;
-			}
+				const QString & ext = exts[e];
+				ProjectRenderer::ExportFileFormats fmt;
+
+				if( ext == "wav" )
+				{
+					fmt = ProjectRenderer::WaveFile;
+				}
 #ifdef LMMS_HAVE_OGGVORBIS
-			else if( ext == "ogg" )
-			{
-				eff = ProjectRenderer::OggFile;
-			}
+				else if( ext == "ogg" )
+				{
+					fmt = ProjectRenderer::OggFile;
+				}
 #endif
 #ifdef LMMS_HAVE_MP3LAME
-			else if( ext == "mp3" )
+				else if( ext == "mp3" )
+				{
+					fmt = ProjectRenderer::MP3File;
+				}
+#endif
+				else
+				{
+					printf( "\nInvalid output format %s.\n\n"
+	"Try \"%s --help\" for more information.\n\n", ext.toUtf8().constData(), argv[0] );
+					return EXIT_FAILURE;
+				}
+
+				if( e == 0 )
+				{
+					eff = fmt;
+				}
+				else
+				{
+					additionalFormats.push_back( fmt );
+				}
+			}
+		}
+		else if( arg == "--blocksize" )
+		{
+			++i;
+
+			if( i == argc )
 			{
-				eff = ProjectRenderer::MP3File;
+				printf( "\nNo block size specified.\n\n"
+	"Try \"%s --help\" for more information.\n\n", argv[0] );
+				return EXIT_FAILURE;
+			}
+
+
+			int frames = QString( argv[i] ).toInt();
+			if( frames >= MINIMUM_BUFFER_SIZE &&
+					frames <= MAXIMUM_RENDER_BUFFER_SIZE )
+			{
+				renderBlockSize = frames;
 			}
-#endif
 			else
 			{
-				printf( "\nInvalid output format %s.\n\n"
+				printf( "\nInvalid block size %s.\n\n"
 	"Try \"%s --help\" for more information.\n\n", argv[i], argv[0] );
 				return EXIT_FAILURE;
 			}
@@ -603,6 +660,20 @@ int main( int argc, char * * argv )
 
 			profilerOutputFile = QString::fromLocal8Bit( argv[i] );
 		}
+		else if( arg == "--trace" )
+		{
+			++i;
+
+			if( i == argc )
+			{
+				printf( "\nNo trace file specified.\n\n"
+	"Try \"%s --help\" for more information.\n\n", argv[0] );
+				return EXIT_FAILURE;
+			}
+
+
+			traceOutputFile = QString::fromLocal8Bit( argv[i] );
+		}
 		else if( arg == "--config" || arg == "-c" )
 		{
 			++i;
@@ -707,7 +778,7 @@ int main( int argc, char * * argv )
 	// without starting the GUI
 	if( !renderOut.isEmpty() )
 	{
-		Engine::init( true );
+		Engine::init( true, renderBlockSize );
 		destroyEngine = true;
 
 		printf( "Loading project...\n" );
@@ -731,6 +802,10 @@ int main( int argc, char * * argv )
 
 		// create renderer
 		RenderManager * r = new RenderManager( qs, os, eff, renderOut );
+		for( int i = 0; i < additionalFormats.size(); ++i )
+		{
+			r->addFormat( additionalFormats[i] );
+		}
 		QCoreApplication::instance()->connect( r,
 				SIGNAL( finished() ), SLOT( quit() ) );
 
@@ -745,6 +820,11 @@ int main( int argc, char * * argv )
 			Engine::mixer()->profiler().setOutputFile( profilerOutputFile );
 		}
 
+		if( traceOutputFile.isEmpty() == false )
+		{
+			Engine::mixer()->profiler().setTraceFile( traceOutputFile );
+		}
+
 		// start now!
 		if ( renderTracks )
 		{
@@ -759,6 +839,11 @@ int main( int argc, char * * argv )
 	{
 		new GuiApplication();
 
+		if( traceOutputFile.isEmpty() == false )
+		{
+			Engine::mixer()->profiler().setTraceFile( traceOutputFile );
+		}
+
 		// re-intialize RNG - shared libraries might have srand() or
 		// srandom() calls in their init procedure
 		srand( getpid() + time( 0 ) );
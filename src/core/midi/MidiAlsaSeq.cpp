@@ -72,6 +72,7 @@ MidiAlsaSeq::MidiAlsaSeq() :
 	MidiClient(),
 	m_seqMutex(),
 	m_seqHandle( NULL ),
+	m_sourceAddressPos( 0 ),
 	m_queueID( -1 ),
 	m_quit( false ),
 	m_portListUpdateTimer( this )
@@ -116,7 +117,9 @@ MidiAlsaSeq::MidiAlsaSeq() :
 		perror( "MidiAlsaSeq: pipe" );
 	}
 
-	start( QThread::IdlePriority );
+	// the thread only timestamps and queues incoming events, so it can run
+	// at high priority without taking much time from anything else
+	start( QThread::HighPriority );
 }
 
 
@@ -224,11 +227,20 @@ void MidiAlsaSeq::processOutEvent( const MidiEvent& event, const MidiTime& time,
 			return;
 	}
 
+	// sent out by flushOutEvents() at the end of the period
 	m_seqMutex.lock();
 	snd_seq_event_output( m_seqHandle, &ev );
-	snd_seq_drain_output( m_seqHandle );
 	m_seqMutex.unlock();
+}
+
+
 
+
+void MidiAlsaSeq::flushOutEvents()
+{
+	m_seqMutex.lock();
+	snd_seq_drain_output( m_seqHandle );
+	m_seqMutex.unlock();
 }
 
 
@@ -505,6 +517,8 @@ void MidiAlsaSeq::run()
 			}
 			m_seqMutex.unlock();
 
+			const qint64 timestamp = MidiClient::timestamp();
+
 			snd_seq_addr_t * source = NULL;
 			MidiPort * dest = NULL;
 			for( int i = 0; i < m_portIDs.size(); ++i )
@@ -517,10 +531,17 @@ void MidiAlsaSeq::run()
 						m_portIDs.values()[i][1] == ev->source.port ) ||
 							m_portIDs.values()[i][0] == ev->source.port )
 				{
-					source = &ev->source;
+					source = &m_sourceAddresses[m_sourceAddressPos];
 				}
 			}
 
+			if( source )
+			{
+				*source = ev->source;
+				m_sourceAddressPos = ( m_sourceAddressPos + 1 ) %
+							SourceAddressCount;
+			}
+
 			if( dest == NULL )
 			{
 				continue;
@@ -529,70 +550,70 @@ void MidiAlsaSeq::run()
 			switch( ev->type )
 			{
 				case SND_SEQ_EVENT_NOTEON:
-					dest->processInEvent( MidiEvent( MidiNoteOn,
+					dest->queueInEvent( MidiEvent( MidiNoteOn,
 								ev->data.note.channel,
 								ev->data.note.note -
 								KeysPerOctave,
 								ev->data.note.velocity,
 								source
 								),
-							MidiTime( ev->time.tick ) );
+							MidiTime( ev->time.tick ), timestamp );
 					break;
 
 				case SND_SEQ_EVENT_NOTEOFF:
-					dest->processInEvent( MidiEvent( MidiNoteOff,
+					dest->queueInEvent( MidiEvent( MidiNoteOff,
 								ev->data.note.channel,
 								ev->data.note.note -
 								KeysPerOctave,
 								ev->data.note.velocity,
 								source
 								),
-							MidiTime( ev->time.tick) );
+							MidiTime( ev->time.tick ), timestamp );
 					break;
 
 				case SND_SEQ_EVENT_KEYPRESS:
-					dest->processInEvent( MidiEvent(
+					dest->queueInEvent( MidiEvent(
 									MidiKeyPressure,
 								ev->data.note.channel,
 								ev->data.note.note -
 								KeysPerOctave,
 								ev->data.note.velocity,
 								source
-								), MidiTime() );
+								), MidiTime(), timestamp );
 					break;
 
 				case SND_SEQ_EVENT_CONTROLLER:
-					dest->processInEvent( MidiEvent(
+					dest->queueInEvent( MidiEvent(
 								MidiControlChange,
 							ev->data.control.channel,
 							ev->data.control.param,
 							ev->data.control.value, source ),
-									MidiTime() );
+									MidiTime(), timestamp );
 					break;
 
 				case SND_SEQ_EVENT_PGMCHANGE:
-					dest->processInEvent( MidiEvent(
+					dest->queueInEvent( MidiEvent(
 								MidiProgramChange,
 							ev->data.control.channel,
 							ev->data.control.param,
 							ev->data.control.value, source ),
-									MidiTime() );
+									MidiTime(), timestamp );
 					break;
 
 				case SND_SEQ_EVENT_CHANPRESS:
-					dest->processInEvent( MidiEvent(
+					dest->queueInEvent( MidiEvent(
 								MidiChannelPressure,
 							ev->data.control.channel,
 							ev->data.control.param,
 							ev->data.control.value, source ),
-									MidiTime() );
+									MidiTime(), timestamp );
 					break;
 
 				case SND_SEQ_EVENT_PITCHBEND:
-					dest->processInEvent( MidiEvent( MidiPitchBend,
+					dest->queueInEvent( MidiEvent( MidiPitchBend,
 							ev->data.control.channel,
 							ev->data.control.value + 8192, 0, source ),
-									MidiTime() );
+									MidiTime(), timestamp );
 					break;
 
 				case SND_SEQ_EVENT_SENSING:
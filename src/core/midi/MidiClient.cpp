@@ -23,11 +23,27 @@
  *
  */
 
+#include <QElapsedTimer>
+
 #include "MidiClient.h"
 #include "MidiPort.h"
+#include "Engine.h"
+#include "Mixer.h"
 #include "Note.h"
 
 
+static QElapsedTimer startedTimer()
+{
+	QElapsedTimer timer;
+	timer.start();
+	return timer;
+}
+
+// monotonic, so adjusting the system clock can't shift queued events. It's
+// started before any MIDI thread exists, so it's only ever read afterwards.
+static const QElapsedTimer s_timestampTimer = startedTimer();
+
+
 MidiClient::MidiClient()
 {
 }
@@ -63,7 +79,16 @@ void MidiClient::applyPortName( MidiPort* )
 
 void MidiClient::addPort( MidiPort* port )
 {
+	// the port list is walked by the rendering thread
+	if( Engine::mixer() )
+	{
+		Engine::mixer()->requestChangeInModel();
+	}
 	m_midiPorts.push_back( port );
+	if( Engine::mixer() )
+	{
+		Engine::mixer()->doneChangeInModel();
+	}
 }
 
 
@@ -80,13 +105,41 @@ void MidiClient::removePort( MidiPort* port )
 		qFind( m_midiPorts.begin(), m_midiPorts.end(), port );
 	if( it != m_midiPorts.end() )
 	{
+		if( Engine::mixer() )
+		{
+			Engine::mixer()->requestChangeInModel();
+		}
 		m_midiPorts.erase( it );
+		if( Engine::mixer() )
+		{
+			Engine::mixer()->doneChangeInModel();
+		}
 	}
 }
 
 
 
 
+void MidiClient::processQueuedInEvents( fpp_t frames, sample_rate_t sampleRate )
+{
+	const qint64 now = timestamp();
+	for( int i = 0; i < m_midiPorts.size(); ++i )
+	{
+		m_midiPorts[i]->processQueuedInEvents( now, frames, sampleRate );
+	}
+}
+
+
+
+
+qint64 MidiClient::timestamp()
+{
+	return s_timestampTimer.nsecsElapsed() / 1000;
+}
+
+
+
+
 void MidiClient::subscribeReadablePort( MidiPort*, const QString& , bool )
 {
 }
@@ -118,7 +171,7 @@ MidiClientRaw::~MidiClientRaw()
 
 
 
-void MidiClientRaw::parseData( const unsigned char c )
+void MidiClientRaw::parseData( const unsigned char c, qint64 timestamp )
 {
 	/*********************************************************************/
 	/* 'Process' system real-time messages                               */
@@ -134,7 +187,7 @@ void MidiClientRaw::parseData( const unsigned char c )
 		{
 			m_midiParseData.m_midiEvent.setType( MidiSystemReset );
 			m_midiParseData.m_status = 0;
-			processParsedEvent();
+			processParsedEvent( timestamp );
 		}
 		return;
 	}
@@ -245,17 +298,17 @@ void MidiClientRaw::parseData( const unsigned char c )
 			return;
 	}
 
-	processParsedEvent();
+	processParsedEvent( timestamp );
 }
 
 
 
 
-void MidiClientRaw::processParsedEvent()
+void MidiClientRaw::processParsedEvent( qint64 timestamp )
 {
 	for( int i = 0; i < m_midiPorts.size(); ++i )
 	{
-		m_midiPorts[i]->processInEvent( m_midiParseData.m_midiEvent );
+		m_midiPorts[i]->queueInEvent( m_midiParseData.m_midiEvent, MidiTime(), timestamp );
 	}
 }
 
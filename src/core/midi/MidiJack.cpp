@@ -174,15 +174,23 @@ void MidiJack::JackMidiRead(jack_nframes_t nframes)
 	jack_nframes_t event_index = 0;
 	jack_nframes_t event_count = jack_midi_get_event_count(port_buf);
 
+	// the events of this cycle were received during the last nframes
+	// frames, so timestamp them relative to now
+	const qint64 now = timestamp();
+	const jack_nframes_t sampleRate = jack_get_sample_rate(jackClient());
+
 	jack_midi_event_get(&in_event, port_buf, 0);
 	for(i=0; i<nframes; i++)
 	{
 		if((in_event.time == i) && (event_index < event_count))
 		{
+			const qint64 eventTime = now -
+				(qint64)(nframes - in_event.time) * 1000000 / sampleRate;
+
 			// lmms is setup to parse bytes coming from a device
 			// parse it byte by byte as it expects
 			for(b=0;b<in_event.size;b++)
-				parseData( *(in_event.buffer + b) );
+				parseData( *(in_event.buffer + b), eventTime );
 
 			event_index++;
 			if(event_index < event_count)
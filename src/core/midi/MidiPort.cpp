@@ -33,6 +33,9 @@
 
 static MidiDummy s_dummyClient;
 
+// events a single port can receive during one period
+const int InEventQueueSize = 256;
+
 
 
 MidiPort::MidiPort( const QString& name,
@@ -56,7 +59,8 @@ MidiPort::MidiPort( const QString& name,
 	m_outputProgramModel( 1, 1, MidiProgramCount, this, tr( "Output MIDI program" ) ),
 	m_baseVelocityModel( MidiMaxVelocity/2, 1, MidiMaxVelocity, this, tr( "Base velocity" ) ),
 	m_readableModel( false, this, tr( "Receive MIDI-events" ) ),
-	m_writableModel( false, this, tr( "Send MIDI-events" ) )
+	m_writableModel( false, this, tr( "Send MIDI-events" ) ),
+	m_inEventQueue( InEventQueueSize )
 {
 	m_midiClient->addPort( this );
 
@@ -117,7 +121,7 @@ void MidiPort::setMode( Mode mode )
 
 
 
-void MidiPort::processInEvent( const MidiEvent& event, const MidiTime& time )
+void MidiPort::processInEvent( const MidiEvent& event, const MidiTime& time, f_cnt_t offset )
 {
 	// mask event
 	if( isInputEnabled() &&
@@ -139,7 +143,39 @@ void MidiPort::processInEvent( const MidiEvent& event, const MidiTime& time )
 			}
 		}
 
-		m_midiEventProcessor->processInEvent( inEvent, time );
+		m_midiEventProcessor->processInEvent( inEvent, time, offset );
+	}
+}
+
+
+
+
+void MidiPort::queueInEvent( const MidiEvent& event, const MidiTime& time, qint64 timestamp )
+{
+	QueuedInEvent e;
+	e.event = event;
+	e.time = time;
+	e.timestamp = timestamp;
+	if( m_inEventQueue.write( &e, 1 ) == 0 )
+	{
+		qWarning( "MidiPort: input queue of %s is full, dropping event",
+						qPrintable( displayName() ) );
+	}
+}
+
+
+
+
+void MidiPort::processQueuedInEvents( qint64 now, fpp_t frames, sample_rate_t sampleRate )
+{
+	QueuedInEvent e;
+	while( m_inEventQueue.read( &e, 1 ) > 0 )
+	{
+		// an event which arrived right now is played at the end of the
+		// period, anything older than one period at its beginning
+		const qint64 age = ( now - e.timestamp ) * sampleRate / 1000000;
+		const f_cnt_t offset = qBound<qint64>( 0, frames - 1 - age, frames - 1 );
+		processInEvent( e.event, e.time, offset );
 	}
 }
 
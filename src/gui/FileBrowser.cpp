@@ -320,6 +320,8 @@ FileBrowserTreeWidget::FileBrowserTreeWidget(QWidget * parent ) :
 	m_pressPos(),
 	m_previewPlayHandle( NULL ),
 	m_pphMutex( QMutex::Recursive ),
+	m_prefetchByPlugin( false ),
+	m_prefetchTimer(),
 	m_contextMenuItem( NULL )
 {
 	setColumnCount( 1 );
@@ -333,6 +335,12 @@ FileBrowserTreeWidget::FileBrowserTreeWidget(QWidget * parent ) :
 	connect( this, SIGNAL( itemExpanded( QTreeWidgetItem * ) ),
 				SLOT( updateDirectory( QTreeWidgetItem * ) ) );
 
+	// only prefetch when the user lingers on a preview, clicking through
+	// presets quickly shouldn't be slowed down by loading others
+	m_prefetchTimer.setSingleShot( true );
+	m_prefetchTimer.setInterval( 400 );
+	connect( &m_prefetchTimer, SIGNAL( timeout() ),
+					this, SLOT( prefetchPreset() ) );
 }
 
 
@@ -374,6 +382,10 @@ void FileBrowserTreeWidget::contextMenuEvent(QContextMenuEvent * e )
 
 void FileBrowserTreeWidget::mousePressEvent(QMouseEvent * me )
 {
+	// the user moved on, don't block them with loading the next preset
+	m_prefetchTimer.stop();
+	m_prefetchFile = QString();
+
 	QTreeWidget::mousePressEvent( me );
 	if( me->button() != Qt::LeftButton )
 	{
@@ -453,6 +465,22 @@ void FileBrowserTreeWidget::mousePressEvent(QMouseEvent * me )
 				m_previewPlayHandle = NULL;
 			}
 		}
+
+		// while this preset is being auditioned, load the next one so
+		// stepping through a folder starts each preview at once
+		FileItem * next = dynamic_cast<FileItem *>( itemBelow( f ) );
+		if( m_previewPlayHandle != NULL &&
+			m_previewPlayHandle->type() == PlayHandle::TypePresetPreviewHandle &&
+			next != NULL &&
+			next->type() != FileItem::SampleFile &&
+			next->type() != FileItem::VstPluginFile &&
+			( next->handling() == FileItem::LoadAsPreset ||
+				next->handling() == FileItem::LoadByPlugin ) )
+		{
+			m_prefetchFile = next->fullName();
+			m_prefetchByPlugin = next->handling() == FileItem::LoadByPlugin;
+			m_prefetchTimer.start();
+		}
 		m_pphMutex.unlock();
 	}
 }
@@ -460,6 +488,33 @@ void FileBrowserTreeWidget::mousePressEvent(QMouseEvent * me )
 
 
 
+void FileBrowserTreeWidget::prefetchPreset()
+{
+	if( m_prefetchFile.isEmpty() )
+	{
+		return;
+	}
+	const QString file = m_prefetchFile;
+	m_prefetchFile = QString();
+
+	const QString ext = FileItem::extension( file );
+	if( ext == "xiz" || ext == "sf2" || ext == "gig" || ext == "pat" )
+	{
+		PresetPreviewPlayHandle::prefetch( file, m_prefetchByPlugin );
+		return;
+	}
+
+	// broken files are reported once they're actually previewed
+	DataFile dataFile( file );
+	if( dataFile.validate( ext ) )
+	{
+		PresetPreviewPlayHandle::prefetch( file, m_prefetchByPlugin, &dataFile );
+	}
+}
+
+
+
+
 void FileBrowserTreeWidget::mouseMoveEvent( QMouseEvent * me )
 {
 	if( m_mousePressed == true &&
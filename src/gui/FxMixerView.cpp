@@ -573,6 +573,10 @@ void FxMixerView::updateFaders()
 {
 	FxMixer * m = Engine::fxMixer();
 
+	// only measure the per-channel CPU load while it can be seen
+	const bool showCpuLoad = parentWidget()->isVisible();
+	Engine::mixer()->profiler().setChannelLoadEnabled( showCpuLoad );
+
 	// apply master gain
 	m->effectChannel(0)->m_peakLeft *= Engine::mixer()->masterGain();
 	m->effectChannel(0)->m_peakRight *= Engine::mixer()->masterGain();
@@ -601,5 +605,8 @@ void FxMixerView::updateFaders()
 		{
 			m_fxChannelViews[i]->m_fader->setPeak_R( opr/fallOff );
 		}
+
+		m_fxChannelViews[i]->m_fxLine->setCpuLoad(
+				showCpuLoad ? m->effectChannel(i)->m_cpuLoad : -1 );
 	}
 }
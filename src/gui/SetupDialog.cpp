@@ -130,6 +130,10 @@ SetupDialog::SetupDialog( ConfigTabs _tab_to_open ) :
 					"compacttrackbuttons" ).toInt() ),
 	m_syncVSTPlugins( ConfigManager::inst()->value( "ui",
 							"syncvstplugins", "1" ).toInt() ),
+	m_pipelinedRemotePlugins( ConfigManager::inst()->value( "mixer",
+					"pipelinedremoteplugins" ).toInt() ),
+	m_compactSamples( ConfigManager::inst()->value( "mixer",
+					"compactsamples" ).toInt() ),
 	m_animateAFP(ConfigManager::inst()->value( "ui",
 						   "animateafp", "1" ).toInt() ),
 	m_printNoteLabels(ConfigManager::inst()->value( "ui",
@@ -291,6 +295,24 @@ SetupDialog::SetupDialog( ConfigTabs _tab_to_open ) :
 	connect( syncVST, SIGNAL( toggled( bool ) ),
 				this, SLOT( toggleSyncVSTPlugins( bool ) ) );
 
+	LedCheckBox * pipelinedRemote = new LedCheckBox(
+			tr( "Run VST and ZynAddSubFX in parallel (one period latency)" ),
+								misc_tw );
+	labelNumber++;
+	pipelinedRemote->move( XDelta, YDelta*labelNumber );
+	pipelinedRemote->setChecked( m_pipelinedRemotePlugins );
+	connect( pipelinedRemote, SIGNAL( toggled( bool ) ),
+			this, SLOT( togglePipelinedRemotePlugins( bool ) ) );
+
+	LedCheckBox * compactSamples = new LedCheckBox(
+			tr( "Keep samples compressed in memory (16 bit)" ),
+								misc_tw );
+	labelNumber++;
+	compactSamples->move( XDelta, YDelta*labelNumber );
+	compactSamples->setChecked( m_compactSamples );
+	connect( compactSamples, SIGNAL( toggled( bool ) ),
+				this, SLOT( toggleCompactSamples( bool ) ) );
+
 	LedCheckBox * noteLabels = new LedCheckBox(
 				tr( "Enable note labels in piano roll" ),
 								misc_tw );
@@ -1097,6 +1119,10 @@ void SetupDialog::accept()
 					QString::number( m_compactTrackButtons ) );
 	ConfigManager::inst()->setValue( "ui", "syncvstplugins",
 					QString::number( m_syncVSTPlugins ) );
+	ConfigManager::inst()->setValue( "mixer", "pipelinedremoteplugins",
+				QString::number( m_pipelinedRemotePlugins ) );
+	ConfigManager::inst()->setValue( "mixer", "compactsamples",
+					QString::number( m_compactSamples ) );
 	ConfigManager::inst()->setValue( "ui", "animateafp",
 					QString::number( m_animateAFP ) );
 	ConfigManager::inst()->setValue( "ui", "printnotelabels",
@@ -1298,6 +1324,16 @@ void SetupDialog::toggleSyncVSTPlugins( bool _enabled )
 	m_syncVSTPlugins = _enabled;
 }
 
+void SetupDialog::togglePipelinedRemotePlugins( bool _enabled )
+{
+	m_pipelinedRemotePlugins = _enabled;
+}
+
+void SetupDialog::toggleCompactSamples( bool _enabled )
+{
+	m_compactSamples = _enabled;
+}
+
 void SetupDialog::toggleAnimateAFP( bool _enabled )
 {
 	m_animateAFP = _enabled;
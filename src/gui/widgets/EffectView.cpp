@@ -234,6 +234,14 @@ void EffectView::closeEffects()
 
 
 
+void EffectView::setOversampling( QAction * _action )
+{
+	effect()->m_oversamplingModel.setValue( _action->data().toInt() );
+}
+
+
+
+
 void EffectView::contextMenuEvent( QContextMenuEvent * )
 {
 	QPointer<CaptionMenu> contextMenu = new CaptionMenu( model()->displayName(), this );
@@ -244,6 +252,23 @@ void EffectView::contextMenuEvent( QContextMenuEvent * )
 						tr( "Move &down" ),
 						this, SLOT( moveDown() ) );
 	contextMenu->addSeparator();
+	if( effect()->supportsOversampling() )
+	{
+		QMenu * oversamplingMenu =
+				contextMenu->addMenu( tr( "&Oversampling" ) );
+		const int current = effect()->m_oversamplingModel.value();
+		for( int i = 0; i <= effect()->m_oversamplingModel.maxValue(); ++i )
+		{
+			QAction * action = oversamplingMenu->addAction(
+								tr( "%1x" ).arg( 1 << i ) );
+			action->setData( i );
+			action->setCheckable( true );
+			action->setChecked( i == current );
+		}
+		connect( oversamplingMenu, SIGNAL( triggered( QAction * ) ),
+				this, SLOT( setOversampling( QAction * ) ) );
+		contextMenu->addSeparator();
+	}
 	contextMenu->addAction( embed::getIconPixmap( "cancel" ),
 						tr( "&Remove this plugin" ),
 						this, SLOT( deletePlugin() ) );
@@ -43,6 +43,7 @@ FxLine::FxLine( QWidget * _parent, FxMixerView * _mv, int _channelIndex ) :
 	QWidget( _parent ),
 	m_mv( _mv ),
 	m_channelIndex( _channelIndex ),
+	m_cpuLoad( -1 ),
 	m_backgroundActive( Qt::SolidPattern ),
 	m_strokeOuterActive( 0, 0, 0 ),
 	m_strokeOuterInactive( 0, 0, 0 ),
@@ -141,6 +142,27 @@ void FxLine::setChannelIndex( int index )
 
 
 
+void FxLine::setCpuLoad( int load )
+{
+	if( load == m_cpuLoad )
+	{
+		return;
+	}
+
+	m_cpuLoad = load;
+
+	if( !m_inRename )
+	{
+		QString name = Engine::fxMixer()->effectChannel( m_channelIndex )->m_name;
+		setToolTip( m_cpuLoad < 0 ? name :
+				name + "\n" + tr( "CPU: %1%" ).arg( m_cpuLoad ) );
+	}
+	update();
+}
+
+
+
+
 void FxLine::drawFxLine( QPainter* p, const FxLine *fxLine, bool isActive, bool sendToThis, bool receiveFromThis )
 {
 	QString name = Engine::fxMixer()->effectChannel( m_channelIndex )->m_name;
@@ -172,6 +194,14 @@ void FxLine::drawFxLine( QPainter* p, const FxLine *fxLine, bool isActive, bool
 	{
 		p->drawPixmap( 2, 0, 29, 56, *s_receiveBgArrow );
 	}
+
+	// CPU load of this channel and its tracks along the right border
+	if( m_cpuLoad > 0 )
+	{
+		const int barHeight = ( height - 6 ) * m_cpuLoad / 100;
+		p->fillRect( width - 5, height - 3 - barHeight, 2, barHeight,
+				m_cpuLoad > 50 ? QColor( 224, 64, 32 ) : QColor( 64, 192, 64 ) );
+	}
 }
 
 
@@ -126,14 +126,11 @@ InstrumentTrack::InstrumentTrack( TrackContainer* tc ) :
 
 	setName( tr( "Default preset" ) );
 
-	connect( &m_baseNoteModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateBaseNote() ), Qt::DirectConnection );
-	connect( &m_pitchModel, SIGNAL( dataChanged() ),
-			this, SLOT( updatePitch() ), Qt::DirectConnection );
-	connect( &m_pitchRangeModel, SIGNAL( dataChanged() ),
-			this, SLOT( updatePitchRange() ), Qt::DirectConnection );
-	connect( &m_effectChannelModel, SIGNAL( dataChanged() ),
-			this, SLOT( updateEffectChannel() ), Qt::DirectConnection );
+	// these have to follow automation right in the rendering thread
+	m_baseNoteModel.addValueListener( [this]() { updateBaseNote(); } );
+	m_pitchModel.addValueListener( [this]() { updatePitch(); } );
+	m_pitchRangeModel.addValueListener( [this]() { updatePitchRange(); } );
+	m_effectChannelModel.addValueListener( [this]() { updateEffectChannel(); } );
 }
 
 
@@ -167,6 +164,8 @@ void InstrumentTrack::processAudioBuffer( sampleFrame* buf, const fpp_t frames,
 		return;
 	}
 
+	m_audioPort.setSourceLatency( m_instrument->latency() );
+
 	// Test for silent input data if instrument provides a single stream only (i.e. driven by InstrumentPlayHandle)
 	// We could do that in all other cases as well but the overhead for silence test is bigger than
 	// what we potentially save. While playing a note, a NotePlayHandle-driven instrument will produce sound in
@@ -673,10 +672,7 @@ bool InstrumentTrack::play( const MidiTime & _start, const fpp_t _frames,
 		if( cur_start > 0 )
 		{
 			// skip notes which are posated before start-tact
-			while( nit != notes.end() && ( *nit )->pos() < cur_start )
-			{
-				++nit;
-			}
+			nit = p->firstNoteFrom( cur_start );
 		}
 
 		Note * cur_note;
@@ -24,6 +24,8 @@
  */
 #include "Pattern.h"
 
+#include <algorithm>
+
 #include <QTimer>
 #include <QMenu>
 #include <QMouseEvent>
@@ -75,6 +77,7 @@ Pattern::Pattern( const Pattern& other ) :
 	m_patternType( other.m_patternType ),
 	m_steps( other.m_steps )
 {
+	m_notes.reserve( other.m_notes.size() );
 	for( NoteVector::ConstIterator it = other.m_notes.begin(); it != other.m_notes.end(); ++it )
 	{
 		m_notes.push_back( new Note( **it ) );
@@ -227,6 +230,56 @@ Note * Pattern::addNote( const Note & _new_note, const bool _quant_pos )
 
 
 
+void Pattern::addNotes( const QVector<Note> & _new_notes,
+						const bool _quant_pos )
+{
+	if( _new_notes.isEmpty() )
+	{
+		return;
+	}
+
+	NoteVector new_notes;
+	new_notes.reserve( _new_notes.size() );
+	for( QVector<Note>::ConstIterator it = _new_notes.begin();
+						it != _new_notes.end(); ++it )
+	{
+		Note * new_note = new Note( *it );
+		if( _quant_pos && gui->pianoRoll() )
+		{
+			new_note->quantizePos( gui->pianoRoll()->quantization() );
+		}
+		new_notes.push_back( new_note );
+	}
+	// stable, so notes at equal positions keep their order like they do
+	// when added one by one
+	std::stable_sort( new_notes.begin(), new_notes.end(), Note::lessThan );
+
+	instrumentTrack()->lock();
+	const int old_size = m_notes.size();
+	m_notes += new_notes;
+	std::inplace_merge( m_notes.begin(), m_notes.begin() + old_size,
+						m_notes.end(), Note::lessThan );
+	instrumentTrack()->unlock();
+
+	checkType();
+	updateLength();
+
+	emit dataChanged();
+}
+
+
+
+
+NoteVector::ConstIterator Pattern::firstNoteFrom( const MidiTime & _pos ) const
+{
+	// notes are sorted by position
+	return std::lower_bound( m_notes.begin(), m_notes.end(), _pos,
+							Note::startsBefore );
+}
+
+
+
+
 void Pattern::removeNote( Note * _note_to_del )
 {
 	instrumentTrack()->lock();
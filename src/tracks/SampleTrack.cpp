@@ -38,6 +38,7 @@
 #include "embed.h"
 #include "ToolTip.h"
 #include "BBTrack.h"
+#include "ConfigManager.h"
 #include "SamplePlayHandle.h"
 #include "SampleRecordHandle.h"
 #include "SongEditor.h"
@@ -54,6 +55,9 @@ SampleTCO::SampleTCO( Track * _track ) :
 	m_sampleBuffer( new SampleBuffer ),
 	m_isPlaying( false )
 {
+	m_sampleBuffer->setCompact( ConfigManager::inst()->value( "mixer",
+					"compactsamples" ).toInt() );
+
 	saveJournallingState( false );
 	setSampleFile( "" );
 	restoreJournallingState();
@@ -79,9 +83,9 @@ SampleTCO::SampleTCO( Track * _track ) :
 			this, SLOT( playbackPositionChanged() ), Qt::DirectConnection );
 	//care about mute TCOs
 	connect( this, SIGNAL( dataChanged() ), this, SLOT( playbackPositionChanged() ) );
-	//care about mute track
-	connect( getTrack()->getMutedModel(), SIGNAL( dataChanged() ),
-			this, SLOT( playbackPositionChanged() ), Qt::DirectConnection );
+	//care about mute track, also when it's automated
+	getTrack()->getMutedModel()->addValueListener(
+			[this]() { playbackPositionChanged(); }, this );
 	//care about TCO position
 	connect( this, SIGNAL( positionChanged() ), this, SLOT( updateTrackTcos() ) );
 
@@ -105,6 +109,8 @@ SampleTCO::SampleTCO( Track * _track ) :
 
 SampleTCO::~SampleTCO()
 {
+	getTrack()->getMutedModel()->removeValueListeners( this );
+
 	SampleTrack * sampletrack = dynamic_cast<SampleTrack*>( getTrack() );
 	if( sampletrack)
 	{
@@ -138,6 +144,8 @@ void SampleTCO::setSampleBuffer( SampleBuffer* sb )
 {
 	sharedObject::unref( m_sampleBuffer );
 	m_sampleBuffer = sb;
+	m_sampleBuffer->setCompact( ConfigManager::inst()->value( "mixer",
+					"compactsamples" ).toInt() );
 	updateLength();
 
 	emit sampleChanged();
@@ -245,8 +253,7 @@ void SampleTCO::saveSettings( QDomDocument & _doc, QDomElement & _this )
 	_this.setAttribute( "src", sampleFile() );
 	if( sampleFile() == "" )
 	{
-		QString s;
-		_this.setAttribute( "data", m_sampleBuffer->toBase64( s ) );
+		m_sampleBuffer->saveData( _doc, _this, "data" );
 	}
 	// TODO: start- and end-frame
 }
@@ -261,9 +268,9 @@ void SampleTCO::loadSettings( const QDomElement & _this )
 		movePosition( _this.attribute( "pos" ).toInt() );
 	}
 	setSampleFile( _this.attribute( "src" ) );
-	if( sampleFile().isEmpty() && _this.hasAttribute( "data" ) )
+	if( sampleFile().isEmpty() )
 	{
-		m_sampleBuffer->loadFromBase64( _this.attribute( "data" ) );
+		m_sampleBuffer->loadData( _this, "data" );
 	}
 	changeLength( _this.attribute( "len" ).toInt() );
 	setMuted( _this.attribute( "muted" ).toInt() );
@@ -0,0 +1,241 @@
+/*
+ * BasicFiltersTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "BasicFilters.h"
+
+#include <cmath>
+
+class BasicFiltersTest : QTestSuite
+{
+	Q_OBJECT
+private:
+	static const int FRAMES = 4096;
+
+	// sum of a few sines spread over the spectrum
+	static void fillTestSignal(sampleFrame* buf, int frames)
+	{
+		for (int f = 0; f < frames; ++f)
+		{
+			buf[f][0] = 0.3f * sinf(f * 0.01f) + 0.3f * sinf(f * 0.3f) + 0.2f * sinf(f * 2.1f);
+			buf[f][1] = 0.5f * sinf(f * 0.05f) + 0.4f * sinf(f * 1.3f);
+		}
+	}
+
+	// RBJ cookbook lowpass, same formulas as used by the Eq plugin
+	static void setLowpass(StereoBiQuad& bq, float freq, float q, float sampleRate)
+	{
+		const float w0 = F_2PI * freq / sampleRate;
+		const float c = cosf(w0);
+		const float alpha = sinf(w0) / (2 * q);
+		const float a0 = 1 + alpha;
+		bq.setCoeffs(-2 * c / a0, (1 - alpha) / a0,
+			(1 - c) * 0.5f / a0, (1 - c) / a0, (1 - c) * 0.5f / a0);
+	}
+
+	// coefficients of a filter whose parameter is automated, at _frame
+	typedef void (*AutomatedCoeffs)(int frame, float* c);
+
+	static void sweepLowpass(int frame, float* c)
+	{
+		const float w0 = F_2PI * 200.f * powf(40.f, frame / float(FRAMES)) / 44100.f;
+		const float alpha = sinf(w0) / (2 * 0.707f);
+		const float a0 = 1 + alpha;
+		c[0] = -2 * cosf(w0) / a0;
+		c[1] = (1 - alpha) / a0;
+		c[2] = (1 - cosf(w0)) * 0.5f / a0;
+		c[3] = (1 - cosf(w0)) / a0;
+		c[4] = c[2];
+	}
+
+	// RBJ cookbook peaking filter with its gain swept from -18 to +18 dB
+	static void sweepPeakGain(int frame, float* c)
+	{
+		const float w0 = F_2PI * 2000.f / 44100.f;
+		const float alpha = sinf(w0) / (2 * 0.707f);
+		const float A = powf(10, (-18.f + 36.f * frame / FRAMES) / 40);
+		const float a0 = 1 + alpha / A;
+		c[0] = -2 * cosf(w0) / a0;
+		c[1] = (1 - alpha / A) / a0;
+		c[2] = (1 + alpha * A) / a0;
+		c[3] = c[0];
+		c[4] = (1 - alpha * A) / a0;
+	}
+
+	// runs the test signal through the automated filter, once with
+	// coefficients recalculated for every frame and once with them
+	// recalculated every 16 frames and glided to in between, and returns
+	// the largest difference - the one without gliding goes to stepped
+	static float glideError(AutomatedCoeffs coeffs, float* stepped)
+	{
+		sampleFrame expected[FRAMES];
+		sampleFrame glided[FRAMES];
+		sampleFrame steps[FRAMES];
+		fillTestSignal(expected, FRAMES);
+		fillTestSignal(glided, FRAMES);
+		fillTestSignal(steps, FRAMES);
+
+		float c[5];
+		StereoBiQuad perFrame;
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			coeffs(f, c);
+			perFrame.setCoeffs(c[0], c[1], c[2], c[3], c[4]);
+			expected[f][0] = perFrame.update(expected[f][0], 0);
+			expected[f][1] = perFrame.update(expected[f][1], 1);
+		}
+
+		const int BLOCK = 16;
+		StereoBiQuad glide;
+		StereoBiQuad step;
+		coeffs(0, c);
+		glide.setCoeffs(c[0], c[1], c[2], c[3], c[4]);
+		for (int offset = 0; offset < FRAMES; offset += BLOCK)
+		{
+			// the Eq samples parameters at the end of each block
+			coeffs(offset + BLOCK - 1, c);
+			glide.glideCoeffs(c[0], c[1], c[2], c[3], c[4]);
+			glide.processBuffer(glided + offset, BLOCK);
+
+			coeffs(offset, c);
+			step.setCoeffs(c[0], c[1], c[2], c[3], c[4]);
+			step.processBuffer(steps + offset, BLOCK);
+		}
+
+		float error = 0;
+		*stepped = 0;
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			error = qMax(error, qAbs(expected[f][0] - glided[f][0]));
+			error = qMax(error, qAbs(expected[f][1] - glided[f][1]));
+			*stepped = qMax(*stepped, qAbs(expected[f][0] - steps[f][0]));
+		}
+		return error;
+	}
+
+private slots:
+	void testBiQuadGlideFollowsAutomation()
+	{
+		// with the coefficients only recalculated every 16 frames the
+		// output has to stay close to the one with per frame automation,
+		// instead of jumping at every block boundary
+		float stepped;
+		QVERIFY(glideError(sweepLowpass, &stepped) < 2e-4f);
+		QVERIFY(stepped > 1e-3f);
+		QVERIFY(glideError(sweepPeakGain, &stepped) < 2e-4f);
+		QVERIFY(stepped > 1e-3f);
+	}
+
+	void testBiQuadBlockMatchesPerFrame()
+	{
+		StereoBiQuad perFrame;
+		StereoBiQuad block;
+		setLowpass(perFrame, 1000.f, 0.707f, 44100.f);
+		setLowpass(block, 1000.f, 0.707f, 44100.f);
+
+		sampleFrame expected[FRAMES];
+		sampleFrame actual[FRAMES];
+		fillTestSignal(expected, FRAMES);
+		fillTestSignal(actual, FRAMES);
+
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			expected[f][0] = perFrame.update(expected[f][0], 0);
+			expected[f][1] = perFrame.update(expected[f][1], 1);
+		}
+
+		// odd block sizes to make sure the state is carried over properly
+		for (int offset = 0; offset < FRAMES; offset += 77)
+		{
+			block.processBuffer(actual + offset, qMin(77, FRAMES - offset));
+		}
+
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			QVERIFY(qAbs(expected[f][0] - actual[f][0]) < 1e-6f);
+			QVERIFY(qAbs(expected[f][1] - actual[f][1]) < 1e-6f);
+		}
+	}
+
+	void testLinkwitzRileyBlockMatchesPerFrame()
+	{
+		StereoLinkwitzRiley perFrame(44100);
+		StereoLinkwitzRiley block(44100);
+		perFrame.setLowpass(2000.f);
+		block.setLowpass(2000.f);
+
+		sampleFrame expected[FRAMES];
+		sampleFrame actual[FRAMES];
+		fillTestSignal(expected, FRAMES);
+		fillTestSignal(actual, FRAMES);
+
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			expected[f][0] = perFrame.update(expected[f][0], 0);
+			expected[f][1] = perFrame.update(expected[f][1], 1);
+		}
+
+		for (int offset = 0; offset < FRAMES; offset += 100)
+		{
+			block.processBuffer(actual + offset, qMin(100, FRAMES - offset));
+		}
+
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			QVERIFY(qAbs(expected[f][0] - actual[f][0]) < 1e-6f);
+			QVERIFY(qAbs(expected[f][1] - actual[f][1]) < 1e-6f);
+		}
+	}
+
+	void benchmarkBiQuadPerFrame()
+	{
+		StereoBiQuad bq;
+		setLowpass(bq, 1000.f, 0.707f, 44100.f);
+		sampleFrame buf[FRAMES];
+		fillTestSignal(buf, FRAMES);
+
+		QBENCHMARK
+		{
+			for (int f = 0; f < FRAMES; ++f)
+			{
+				buf[f][0] = bq.update(buf[f][0], 0);
+				buf[f][1] = bq.update(buf[f][1], 1);
+			}
+		}
+	}
+
+	void benchmarkBiQuadBlock()
+	{
+		StereoBiQuad bq;
+		setLowpass(bq, 1000.f, 0.707f, 44100.f);
+		sampleFrame buf[FRAMES];
+		fillTestSignal(buf, FRAMES);
+
+		QBENCHMARK
+		{
+			bq.processBuffer(buf, FRAMES);
+		}
+	}
+} BasicFiltersTests;
+
+#include "BasicFiltersTest.moc"
@@ -0,0 +1,149 @@
+/*
+ * CompactSampleDataTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "CompactSampleData.h"
+
+#include <cmath>
+
+class CompactSampleDataTest : QTestSuite
+{
+	Q_OBJECT
+private:
+	static const int FRAMES = 10000;
+
+	// 16 bit samples as they come out of SampleDecoder::toStereo()
+	static float int16(double value)
+	{
+		return (short) lrint(value * 32767) * (1 / 32767.0f);
+	}
+
+	// 16 bit samples as they come out of sf_readf_float()
+	static float sndfile16(int value)
+	{
+		return (short) value * (1 / 32768.0f);
+	}
+
+private slots:
+	void testMonoLossless()
+	{
+		sampleFrame data[FRAMES];
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			data[f][0] = data[f][1] = int16(0.8 * sin(f * 0.01));
+		}
+
+		CompactSampleData compact(data, FRAMES);
+		QCOMPARE(int(compact.channels()), 1);
+		// at least four times smaller than sampleFrames
+		QVERIFY(compact.size() * 4 <= FRAMES * int(sizeof(sampleFrame)));
+
+		sampleFrame out[FRAMES];
+		compact.read(0, FRAMES, out);
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			QCOMPARE(out[f][0], data[f][0]);
+			QCOMPARE(out[f][1], data[f][1]);
+		}
+	}
+
+	void testStereoReadAcrossBlocks()
+	{
+		sampleFrame data[FRAMES];
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			data[f][0] = int16(0.5 * sin(f * 0.01));
+			data[f][1] = int16(0.5 * cos(f * 0.003));
+		}
+		CompactSampleData compact(data, FRAMES);
+		QCOMPARE(int(compact.channels()), 2);
+
+		// starts before and ends after the data
+		const int from = -10;
+		const int frames = CompactSampleData::BlockFrames * 3;
+		sampleFrame out[frames];
+		compact.read(from, frames, out);
+		for (int f = 0; f < frames; ++f)
+		{
+			const float expected = from + f < 0 ? 0.f : data[from + f][1];
+			QCOMPARE(out[f][1], expected);
+		}
+
+		compact.read(FRAMES - 5, 10, out);
+		QCOMPARE(out[4][0], data[FRAMES - 1][0]);
+		QCOMPARE(out[5][0], 0.f);
+	}
+
+	void testFullScaleLossless()
+	{
+		sampleFrame data[FRAMES];
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			// sweeps the whole 16 bit range including -32768 and 32767
+			data[f][0] = sndfile16(f * 65535 / (FRAMES - 1) - 32768);
+			data[f][1] = sndfile16(f % 2 ? 32767 : -32768);
+		}
+
+		CompactSampleData compact(data, FRAMES);
+		sampleFrame out[FRAMES];
+		compact.read(0, FRAMES, out);
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			QCOMPARE(out[f][0], data[f][0]);
+			QCOMPARE(out[f][1], data[f][1]);
+		}
+
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			data[f][0] = data[f][1] = (short) (f % 2 ? 32767 : -32768) *
+								(1 / 32767.0f);
+		}
+
+		CompactSampleData compactDecoder(data, FRAMES);
+		compactDecoder.read(0, FRAMES, out);
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			QCOMPARE(out[f][0], data[f][0]);
+		}
+	}
+
+	void testLoudFloatData()
+	{
+		sampleFrame data[FRAMES];
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			data[f][0] = data[f][1] = 4 * sin(f * 0.001);
+		}
+		CompactSampleData compact(data, FRAMES);
+
+		sampleFrame out[FRAMES];
+		compact.read(0, FRAMES, out);
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			// quantized relative to the peak instead of clipped
+			QVERIFY(qAbs(out[f][0] - data[f][0]) <= 4 / 32768.f);
+		}
+	}
+} CompactSampleDataTests;
+
+#include "CompactSampleDataTest.moc"
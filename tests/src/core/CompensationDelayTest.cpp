@@ -0,0 +1,93 @@
+/*
+ * CompensationDelayTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "CompensationDelay.h"
+
+class CompensationDelayTest : QTestSuite
+{
+	Q_OBJECT
+private:
+	static const int FRAMES = 64;
+
+	static void fillRamp(sampleFrame* buf, int frames, int start)
+	{
+		for (int f = 0; f < frames; ++f)
+		{
+			buf[f][0] = start + f;
+			buf[f][1] = -(start + f);
+		}
+	}
+
+private slots:
+	void testZeroDelayPassesThrough()
+	{
+		CompensationDelay delay;
+		sampleFrame in[FRAMES];
+		sampleFrame out[FRAMES];
+		fillRamp(in, FRAMES, 1);
+
+		QVERIFY(delay.process(in, out, FRAMES, true));
+		QCOMPARE(out[10][0], 11.f);
+		QVERIFY(!delay.process(in, out, FRAMES, false));
+	}
+
+	void testDelaysAcrossPeriods()
+	{
+		const int d = 100;
+		CompensationDelay delay;
+		delay.setDelay(d);
+
+		sampleFrame buf[FRAMES];
+		for (int period = 0; period < 4; ++period)
+		{
+			fillRamp(buf, FRAMES, period * FRAMES);
+			QVERIFY(delay.process(buf, buf, FRAMES, true));
+			for (int f = 0; f < FRAMES; ++f)
+			{
+				const int pos = period * FRAMES + f;
+				const float expected = pos < d ? 0.f : pos - d;
+				QCOMPARE(buf[f][0], expected);
+				QCOMPARE(buf[f][1], -expected);
+			}
+		}
+	}
+
+	void testFlushesTailAfterInputStops()
+	{
+		const int d = 100;
+		CompensationDelay delay;
+		delay.setDelay(d);
+
+		sampleFrame buf[FRAMES];
+		fillRamp(buf, FRAMES, 1);
+		QVERIFY(delay.process(buf, buf, FRAMES, true));
+
+		// the input is still in the delay line for two more periods
+		QVERIFY(delay.process(buf, buf, FRAMES, false));
+		QVERIFY(delay.process(buf, buf, FRAMES, false));
+		QVERIFY(!delay.process(buf, buf, FRAMES, false));
+	}
+} CompensationDelayTests;
+
+#include "CompensationDelayTest.moc"
@@ -0,0 +1,183 @@
+/*
+ * FastMathTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "lmms_math.h"
+
+class FastMathTest : QTestSuite
+{
+	Q_OBJECT
+private:
+	static const int STEPS = 100000;
+	static const int FRAMES = 4096;
+
+	static float at(double from, double to, int step)
+	{
+		return static_cast<float>(from + (to - from) * step / STEPS);
+	}
+
+	static void fillRamp(float* buf, int frames, float from, float to)
+	{
+		for (int f = 0; f < frames; ++f)
+		{
+			buf[f] = from + (to - from) * f / frames;
+		}
+	}
+
+private slots:
+	void testExp2()
+	{
+		for (int i = 0; i <= STEPS; ++i)
+		{
+			const float x = at(-126, 127, i);
+			const double expected = exp2(static_cast<double>(x));
+			QVERIFY(qAbs(fastExp2f(x) - expected) / expected < 3e-7);
+		}
+		QCOMPARE(fastExp2f(0.f), 1.f);
+		QCOMPARE(fastExp2f(-1000.f), fastExp2f(-126.f));
+		QCOMPARE(fastExp2f(INFINITY), fastExp2f(127.f));
+	}
+
+	void testExp()
+	{
+		for (int i = 0; i <= STEPS; ++i)
+		{
+			const float x = at(-87, 88, i);
+			const double expected = exp(static_cast<double>(x));
+			QVERIFY(qAbs(fastExpf(x) - expected) / expected < 4e-6);
+		}
+	}
+
+	void testLog2()
+	{
+		for (int i = 0; i <= STEPS; ++i)
+		{
+			const float x = at(0.01, 4, i);
+			const double expected = log2(static_cast<double>(x));
+			QVERIFY(qAbs(fastLog2f(x) - expected) < 4e-7);
+		}
+		QCOMPARE(fastLog2f(1024.f), 10.f);
+	}
+
+	void testTanh()
+	{
+		for (int i = 0; i <= STEPS; ++i)
+		{
+			const float x = at(-20, 20, i);
+			QVERIFY(qAbs(fastTanhf(x) - tanh(static_cast<double>(x))) < 2e-7);
+		}
+		QCOMPARE(fastTanhf(INFINITY), 1.f);
+		QCOMPARE(fastTanhf(-INFINITY), -1.f);
+	}
+
+	void testSinCos()
+	{
+		for (int i = 0; i <= STEPS; ++i)
+		{
+			const float x = at(-1000, 1000, i);
+			QVERIFY(qAbs(fastSinf(x) - sin(static_cast<double>(x))) < 3e-7);
+			QVERIFY(qAbs(fastCosf(x) - cos(static_cast<double>(x))) < 3e-7);
+		}
+	}
+
+	void testBlocksMatchSingleValues()
+	{
+		float in[FRAMES];
+		float out[FRAMES];
+		fillRamp(in, FRAMES, -10.f, 10.f);
+
+		fastExp2f(in, out, FRAMES);
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			QCOMPARE(out[f], fastExp2f(in[f]));
+		}
+
+		fastTanhf(in, out, FRAMES);
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			QCOMPARE(out[f], fastTanhf(in[f]));
+		}
+
+		fastSinf(in, out, FRAMES);
+		for (int f = 0; f < FRAMES; ++f)
+		{
+			QCOMPARE(out[f], fastSinf(in[f]));
+		}
+	}
+
+	void benchmarkLibmExp2()
+	{
+		float in[FRAMES];
+		float out[FRAMES];
+		fillRamp(in, FRAMES, -10.f, 10.f);
+
+		QBENCHMARK
+		{
+			for (int f = 0; f < FRAMES; ++f)
+			{
+				out[f] = exp2f(in[f]);
+			}
+		}
+	}
+
+	void benchmarkFastExp2()
+	{
+		float in[FRAMES];
+		float out[FRAMES];
+		fillRamp(in, FRAMES, -10.f, 10.f);
+
+		QBENCHMARK
+		{
+			fastExp2f(in, out, FRAMES);
+		}
+	}
+
+	void benchmarkLibmTanh()
+	{
+		float in[FRAMES];
+		float out[FRAMES];
+		fillRamp(in, FRAMES, -4.f, 4.f);
+
+		QBENCHMARK
+		{
+			for (int f = 0; f < FRAMES; ++f)
+			{
+				out[f] = tanhf(in[f]);
+			}
+		}
+	}
+
+	void benchmarkFastTanh()
+	{
+		float in[FRAMES];
+		float out[FRAMES];
+		fillRamp(in, FRAMES, -4.f, 4.f);
+
+		QBENCHMARK
+		{
+			fastTanhf(in, out, FRAMES);
+		}
+	}
+} FastMathTests;
+
+#include "FastMathTest.moc"
@@ -0,0 +1,133 @@
+/*
+ * MidiInputJitterTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include <QVector>
+
+#include "MidiClient.h"
+#include "MidiEventProcessor.h"
+#include "MidiPort.h"
+
+// virtual MIDI port feeding everything sent to it straight back into the
+// raw MIDI parser, stamped with a time set by the test
+class LoopbackMidiClient : public MidiClientRaw
+{
+public:
+	qint64 m_sendTime;
+
+protected:
+	virtual void sendByte(const unsigned char c)
+	{
+		parseData(c, m_sendTime);
+	}
+};
+
+class RecordingProcessor : public MidiEventProcessor
+{
+public:
+	f_cnt_t m_periodStart;
+	QVector<f_cnt_t> m_frames;
+
+	virtual void processInEvent(const MidiEvent& event, const MidiTime&, f_cnt_t offset)
+	{
+		if (event.type() == MidiNoteOn)
+		{
+			m_frames.push_back(m_periodStart + offset);
+		}
+	}
+
+	virtual void processOutEvent(const MidiEvent&, const MidiTime&, f_cnt_t)
+	{
+	}
+};
+
+class MidiInputJitterTest : QTestSuite
+{
+	Q_OBJECT
+private:
+	static const int FRAMES = 256;
+	static const int SAMPLE_RATE = 44100;
+	static const int EVENTS = 100;
+
+private slots:
+	// sends notes at an interval unrelated to the period size through the
+	// loopback port and checks that all of them come out with the same
+	// latency
+	void testConstantLatency()
+	{
+		LoopbackMidiClient client;
+		RecordingProcessor processor;
+		MidiPort port("loopback", &client, &processor, NULL, MidiPort::Duplex);
+
+		const qint64 start = 1000 * 1000;
+		const qint64 interval = 1723;
+		QVector<f_cnt_t> sent;
+
+		int next = 0;
+		for (int period = 1; next < EVENTS; ++period)
+		{
+			const qint64 periodStart = start + (qint64) period * FRAMES * 1000000 / SAMPLE_RATE;
+			while (next < EVENTS && start + next * interval < periodStart)
+			{
+				client.m_sendTime = start + next * interval;
+				port.processOutEvent(MidiEvent(MidiNoteOn, 0, 60, 100));
+				sent.push_back(next * interval * SAMPLE_RATE / 1000000);
+				++next;
+			}
+
+			processor.m_periodStart = period * FRAMES;
+			port.processQueuedInEvents(periodStart, FRAMES, SAMPLE_RATE);
+		}
+
+		QCOMPARE(processor.m_frames.size(), int(EVENTS));
+
+		int maxJitter = 0;
+		for (int i = 0; i < EVENTS; ++i)
+		{
+			const int latency = processor.m_frames[i] - sent[i];
+			maxJitter = qMax(maxJitter, qAbs(latency - (FRAMES - 1)));
+		}
+		// only rounding of the timestamps to frames is left, without the
+		// queue the latency varied by up to one period
+		QVERIFY(maxJitter <= 2);
+	}
+
+	// events older than one period are placed at the start of the period
+	void testLateEventsClamped()
+	{
+		LoopbackMidiClient client;
+		RecordingProcessor processor;
+		MidiPort port("loopback", &client, &processor, NULL, MidiPort::Duplex);
+
+		client.m_sendTime = 0;
+		port.processOutEvent(MidiEvent(MidiNoteOn, 0, 60, 100));
+
+		processor.m_periodStart = 0;
+		port.processQueuedInEvents(1000 * 1000, FRAMES, SAMPLE_RATE);
+
+		QCOMPARE(processor.m_frames.size(), 1);
+		QCOMPARE(processor.m_frames[0], f_cnt_t(0));
+	}
+} MidiInputJitterTests;
+
+#include "MidiInputJitterTest.moc"
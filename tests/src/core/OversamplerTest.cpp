@@ -0,0 +1,138 @@
+/*
+ * OversamplerTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "Oversampler.h"
+
+#include <cmath>
+
+class OversamplerTest : QTestSuite
+{
+	Q_OBJECT
+private:
+	static const int FRAMES = 256;
+	static const int PERIODS = 16;
+
+private slots:
+	void testFactor()
+	{
+		QCOMPARE(Oversampler(2, FRAMES).factor(), 2);
+		QCOMPARE(Oversampler(4, FRAMES).factor(), 4);
+		QCOMPARE(Oversampler(8, FRAMES).factor(), 8);
+	}
+
+	void testImpulseDelayedByLatency()
+	{
+		for (int factor = 2; factor <= 8; factor *= 2)
+		{
+			Oversampler os(factor, FRAMES);
+			sampleFrame buf[FRAMES];
+			int peak = 0;
+			float peakValue = 0.f;
+			for (int p = 0; p < 4; ++p)
+			{
+				memset(buf, 0, sizeof(buf));
+				if (p == 0)
+				{
+					buf[0][0] = buf[0][1] = 1.f;
+				}
+				os.up(buf, FRAMES);
+				os.down(buf, FRAMES);
+				for (int f = 0; f < FRAMES; ++f)
+				{
+					if (qAbs(buf[f][0]) > peakValue)
+					{
+						peakValue = qAbs(buf[f][0]);
+						peak = p * FRAMES + f;
+					}
+				}
+			}
+			QCOMPARE(peak, int(os.latency()));
+		}
+	}
+
+	void testDcGain()
+	{
+		for (int factor = 2; factor <= 8; factor *= 2)
+		{
+			Oversampler os(factor, FRAMES);
+			sampleFrame buf[FRAMES];
+			for (int p = 0; p < 4; ++p)
+			{
+				for (int f = 0; f < FRAMES; ++f)
+				{
+					buf[f][0] = buf[f][1] = 0.5f;
+				}
+				os.up(buf, FRAMES);
+				os.down(buf, FRAMES);
+			}
+			QVERIFY(qAbs(buf[FRAMES - 1][0] - 0.5f) < 1e-4f);
+			QVERIFY(qAbs(buf[FRAMES - 1][1] - 0.5f) < 1e-4f);
+		}
+	}
+
+	void testSineRoundTrip()
+	{
+		for (int factor = 2; factor <= 8; factor *= 2)
+		{
+			Oversampler os(factor, FRAMES);
+			const int latency = os.latency();
+			const double w = 2 * M_PI * 1000. / 44100.;
+			sampleFrame buf[FRAMES];
+			for (int p = 0; p < PERIODS; ++p)
+			{
+				for (int f = 0; f < FRAMES; ++f)
+				{
+					buf[f][0] = buf[f][1] = sin(w * (p * FRAMES + f));
+				}
+				os.up(buf, FRAMES);
+				os.down(buf, FRAMES);
+				// skip the filters settling
+				if (p < 2)
+				{
+					continue;
+				}
+				for (int f = 0; f < FRAMES; ++f)
+				{
+					const float expected = sin(w * (p * FRAMES + f - latency));
+					QVERIFY(qAbs(buf[f][0] - expected) < 1e-4f);
+				}
+			}
+		}
+	}
+
+	void benchmarkRoundTrip4x()
+	{
+		Oversampler os(4, FRAMES);
+		sampleFrame buf[FRAMES];
+		memset(buf, 0, sizeof(buf));
+
+		QBENCHMARK
+		{
+			os.up(buf, FRAMES);
+			os.down(buf, FRAMES);
+		}
+	}
+} OversamplerTests;
+
+#include "OversamplerTest.moc"
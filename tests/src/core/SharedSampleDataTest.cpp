@@ -0,0 +1,100 @@
+/*
+ * SharedSampleDataTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "DataFile.h"
+#include "SharedSampleData.h"
+
+class SharedSampleDataTest : QTestSuite
+{
+	Q_OBJECT
+private:
+	static SharedSampleData* createData()
+	{
+		const f_cnt_t frames = 100;
+		sampleFrame* data = MM_ALLOC(sampleFrame, frames);
+		for (f_cnt_t f = 0; f < frames; ++f)
+		{
+			data[f][0] = data[f][1] = f * 0.01f;
+		}
+		return new SharedSampleData(data, frames, false);
+	}
+
+private slots:
+	// data referenced by undo checkpoints stays alive after its last user
+	// is gone until every checkpoint referencing it is released
+	void testRetainedUntilReleased()
+	{
+		DataFile doc(DataFile::JournalData);
+		QDomElement first = doc.createElement("sampletco");
+		QDomElement second = doc.createElement("sampletco");
+
+		SharedSampleData* data = createData();
+		data->retain(first);
+		data->retain(second);
+		data->unref();
+
+		SharedSampleData* found = SharedSampleData::findRetained(second);
+		QVERIFY(found == data);
+		QCOMPARE(found->frames(), f_cnt_t(100));
+		found->unref();
+
+		SharedSampleData::releaseRetained(first);
+		found = SharedSampleData::findRetained(second);
+		QVERIFY(found == data);
+		found->unref();
+
+		SharedSampleData::releaseRetained(second);
+		QVERIFY(SharedSampleData::findRetained(second) == NULL);
+	}
+
+	// a checkpoint of a whole track releases the data of all its clips
+	void testReleaseChildren()
+	{
+		DataFile doc(DataFile::ClipboardData);
+		QDomElement track = doc.createElement("track");
+		QDomElement tco = doc.createElement("sampletco");
+		track.appendChild(tco);
+
+		SharedSampleData* data = createData();
+		data->retain(tco);
+
+		SharedSampleData::releaseRetained(track);
+		QVERIFY(SharedSampleData::findRetained(tco) == NULL);
+
+		// the reference of the creator is still there
+		QCOMPARE(data->frames(), f_cnt_t(100));
+		data->unref();
+	}
+
+	void testDocumentType()
+	{
+		QCOMPARE(DataFile::documentType(DataFile(DataFile::JournalData)),
+				DataFile::JournalData);
+		QCOMPARE(DataFile::documentType(DataFile(DataFile::ClipboardData)),
+				DataFile::ClipboardData);
+		QCOMPARE(DataFile::documentType(QDomDocument()), DataFile::UnknownType);
+	}
+} SharedSampleDataTests;
+
+#include "SharedSampleDataTest.moc"
@@ -0,0 +1,164 @@
+/*
+ * VibratingStringTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "ConfigManager.h"
+#include "RandomGenerator.h"
+#include "vibrating_string.h"
+
+#include <cmath>
+
+namespace
+{
+
+const int FRAMES = 2048;
+const int GOLDEN_STEP = 64;
+
+struct StringConfig
+{
+	float pitch;
+	int oversample;
+	bool state;
+	float pick;
+	float pickup;
+};
+
+const StringConfig CONFIGS[] =
+{
+	{ 110.f, 1, false, 0.f, 0.05f },
+	{ 440.f, 2, true, 0.3f, 0.2f },
+	{ 1000.f, 3, false, 0.5f, 0.7f },
+	{ 55.f, 1, true, 0.1f, 0.5f }
+};
+
+struct GoldenOutput
+{
+	float rms;
+	float samples[FRAMES / GOLDEN_STEP];
+};
+
+// every 64th sample and the RMS of all samples rendered by the string
+// model before it was changed to render whole periods, at 44.1 kHz with
+// the random generator seeded with 1
+const GoldenOutput GOLDEN[] =
+{
+	{
+		0.315575118f,
+		{
+			0.412185669f, 0.48136124f, -0.276632339f, -0.505342424f, -0.190481007f,
+			0.0893758535f, 0.425745547f, 0.298300594f, -0.0651176572f,
+			-0.360258549f, -0.161507487f, -0.0217940807f, 0.455777526f,
+			0.385692239f, 0.0179316998f, -0.337470978f, -0.389988273f,
+			-0.0806204677f, 0.264048398f, 0.439316273f, 0.136865884f, -0.21266371f,
+			-0.463297307f, -0.126301348f, 0.282491922f, 0.408244282f, 0.250101924f,
+			-0.203007579f, -0.451479524f, -0.25127089f, 0.0655301213f, 0.414865166f
+		}
+	},
+	{
+		0.279681652f,
+		{
+			0.f, -0.235080689f, 0.451994687f, 4.76878849e-05f, -0.42686826f,
+			0.190984353f, 0.468487322f, -3.92726029e-08f, 7.00415841e-35f,
+			0.144267648f, -0.275643408f, 2.56181317e-24f, -0.480318606f,
+			-0.397900701f, 2.37628859e-14f, -0.102778673f, 0.312443346f,
+			1.62270499e-05f, -0.0061130398f, 0.36542204f, 0.347368121f,
+			-0.487456262f, 1.42680996e-17f, 0.329728037f, -0.0485948324f,
+			1.04269064e-08f, -0.377905369f, 0.489864886f, 0.0400759876f,
+			-0.291718781f, 0.0405952521f, 0.491463304f
+		}
+	},
+	{
+		0.933651922f,
+		{
+			1.06516564f, -1.42585003f, 0.994533956f, -0.753164172f, 0.525199592f,
+			-0.0527531356f, -0.294473946f, 0.791623592f, -0.96355468f, 1.05165172f,
+			-1.34743369f, 1.41879594f, -1.16607785f, 0.849745095f, -0.595106959f,
+			0.268837512f, 0.190384194f, -0.580819368f, 0.941929162f, -1.14779246f,
+			1.12389743f, -1.27949774f, 1.3954711f, -1.02330422f, 0.655017495f,
+			-0.333293974f, 0.0310693383f, 0.393697172f, -0.822296679f, 1.09130907f,
+			-1.24920893f, 1.16460645f
+		}
+	},
+	{
+		0.139561256f,
+		{
+			0.f, 0.f, 0.f, 0.f, 0.f, 0.024533838f, 0.f, -5.04870987e-30f,
+			-0.0972532779f, 1.05888214e-20f, -0.f, -0.f, -0.f, -0.f, -0.f, -0.f,
+			-0.f, 0.0733652487f, -0.f, 3.72529035e-10f, 0.f, -0.144737616f,
+			-2.29608499e-39f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.190828085f,
+			9.18435256e-39f
+		}
+	}
+};
+
+}
+
+class VibratingStringTest : QTestSuite
+{
+	Q_OBJECT
+private slots:
+	void testMatchesGoldenOutput()
+	{
+		// the oversampling depends on the base sample rate
+		const QString oldSampleRate = ConfigManager::inst()->value("mixer", "samplerate");
+		ConfigManager::inst()->setValue("mixer", "samplerate", "44100");
+
+		float impulse[128];
+		for (int i = 0; i < 128; ++i)
+		{
+			impulse[i] = sinf(2 * 3.14159265f * i / 128);
+		}
+
+		for (int c = 0; c < 4; ++c)
+		{
+			const StringConfig& config = CONFIGS[c];
+			RandomGenerator generator(1);
+			RandomGenerator::Scope scope(generator);
+			vibratingString string(config.pitch, config.pick, config.pickup, impulse, 128,
+					44100, config.oversample, 0.f, 0.f, 0.f, config.state);
+
+			// in blocks of different sizes, as periods of voices vary
+			float out[FRAMES];
+			string.render(out, 256);
+			string.render(out + 256, 1000);
+			string.render(out + 1256, FRAMES - 1256);
+
+			double energy = 0;
+			for (int f = 0; f < FRAMES; ++f)
+			{
+				energy += out[f] * out[f];
+			}
+			const float rms = sqrt(energy / FRAMES);
+			QVERIFY(qAbs(rms - GOLDEN[c].rms) <= 1e-4f * GOLDEN[c].rms);
+
+			for (int f = 0; f < FRAMES; f += GOLDEN_STEP)
+			{
+				QVERIFY(qAbs(out[f] - GOLDEN[c].samples[f / GOLDEN_STEP]) <= 1e-4f);
+			}
+		}
+
+		ConfigManager::inst()->setValue("mixer", "samplerate", oldSampleRate);
+	}
+} VibratingStringTests;
+
+#include "VibratingStringTest.moc"
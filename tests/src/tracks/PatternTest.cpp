@@ -0,0 +1,243 @@
+/*
+ * PatternTest.cpp
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "InstrumentTrack.h"
+#include "Pattern.h"
+
+#include "Engine.h"
+#include "Song.h"
+
+class PatternTest : QTestSuite
+{
+	Q_OBJECT
+private:
+	static const int BENCHMARK_NOTES = 100000;
+
+	static Pattern* createPattern()
+	{
+		InstrumentTrack* track = dynamic_cast<InstrumentTrack*>(
+				Track::create(Track::InstrumentTrack, Engine::getSong()));
+		return dynamic_cast<Pattern*>(track->createTCO(0));
+	}
+
+	// the length identifies a note in these tests
+	static QVector<int> ids(const Pattern* pattern)
+	{
+		QVector<int> result;
+		for (const Note* note : pattern->notes())
+		{
+			result.push_back(note->length());
+		}
+		return result;
+	}
+
+	static Note note(int id, int pos, int key = DefaultKey)
+	{
+		return Note(MidiTime(id), MidiTime(pos), key);
+	}
+
+	// how InstrumentTrack::play() used to find the first note to play
+	static NoteVector::ConstIterator linearFirstNoteFrom(const Pattern* pattern, const MidiTime& pos)
+	{
+		NoteVector::ConstIterator it = pattern->notes().begin();
+		while (it != pattern->notes().end() && (*it)->pos() < pos)
+		{
+			++it;
+		}
+		return it;
+	}
+
+	// chords of four notes on every 16th over 100k notes
+	static QVector<Note> benchmarkNotes()
+	{
+		QVector<Note> notes;
+		notes.reserve(BENCHMARK_NOTES);
+		for (int i = 0; i < BENCHMARK_NOTES; ++i)
+		{
+			notes.push_back(Note(MidiTime(12), MidiTime(i / 4 * 12), DefaultKey + i % 4 * 4));
+		}
+		return notes;
+	}
+
+private slots:
+	void testMergeWithExistingNotes()
+	{
+		Pattern* pattern = createPattern();
+		pattern->addNote(note(1, 0), false);
+		pattern->addNote(note(2, 96), false);
+		pattern->addNote(note(3, 192), false);
+
+		QVector<Note> notes;
+		notes.push_back(note(4, 300));
+		notes.push_back(note(5, 96));
+		notes.push_back(note(6, 48));
+		notes.push_back(note(7, 96, DefaultKey + 12));
+		pattern->addNotes(notes, false);
+
+		// notes at the same position are sorted by descending key,
+		// notes equal to an existing one go behind it
+		QVector<int> expected;
+		expected << 1 << 6 << 7 << 2 << 5 << 3 << 4;
+		QCOMPARE(ids(pattern), expected);
+		// the last note ends in the second tact
+		QCOMPARE((int) pattern->length(), 2 * MidiTime::ticksPerTact());
+	}
+
+	void testEqualNotesKeepOrder()
+	{
+		Pattern* pattern = createPattern();
+
+		QVector<Note> notes;
+		QVector<int> expected;
+		for (int id = 1; id <= 20; ++id)
+		{
+			notes.push_back(note(id, id % 2 ? 48 : 0));
+		}
+		for (int id = 2; id <= 20; id += 2)
+		{
+			expected << id;
+		}
+		for (int id = 1; id <= 20; id += 2)
+		{
+			expected << id;
+		}
+		pattern->addNotes(notes, false);
+
+		QCOMPARE(ids(pattern), expected);
+	}
+
+	void testMatchesAddNote()
+	{
+		Pattern* single = createPattern();
+		Pattern* bulk = createPattern();
+
+		// some notes already there, positions and keys repeat often
+		QVector<Note> notes;
+		for (int id = 1; id <= 500; ++id)
+		{
+			const Note n = note(id, (id * 37) % 101 * 12, DefaultKey + id % 3);
+			single->addNote(n, false);
+			if (id <= 50)
+			{
+				bulk->addNote(n, false);
+			}
+			else
+			{
+				notes.push_back(n);
+			}
+		}
+		bulk->addNotes(notes, false);
+
+		QCOMPARE(ids(bulk), ids(single));
+		QCOMPARE(bulk->length(), single->length());
+	}
+
+	// the binary search has to find the same notes as the linear scan,
+	// also with chords, notes overlapping others and zero-length notes
+	void testFirstNoteFromMatchesLinearScan()
+	{
+		Pattern* pattern = createPattern();
+		QVector<Note> notes;
+		for (int pos = 0; pos < 4 * 48; pos += 12)
+		{
+			notes.push_back(note(12, pos));
+			if (pos % 48 == 0)
+			{
+				// chord with a note lasting over the next ones
+				notes.push_back(note(96, pos, DefaultKey + 4));
+				notes.push_back(note(12, pos, DefaultKey + 7));
+			}
+			if (pos % 36 == 0)
+			{
+				notes.push_back(note(0, pos, DefaultKey - 12));
+				notes.push_back(note(0, pos + 5, DefaultKey - 12));
+			}
+		}
+		pattern->addNotes(notes, false);
+
+		const NoteVector& sorted = pattern->notes();
+		for (int pos = 1; pos <= (int) sorted.last()->pos() + 2; ++pos)
+		{
+			NoteVector::ConstIterator it = pattern->firstNoteFrom(MidiTime(pos));
+			QVERIFY(it == linearFirstNoteFrom(pattern, MidiTime(pos)));
+			QVERIFY(it == sorted.begin() || (*(it - 1))->pos() < pos);
+			QVERIFY(it == sorted.end() || (*it)->pos() >= pos);
+		}
+	}
+
+	void benchmarkBulkInsert()
+	{
+		Pattern* pattern = createPattern();
+		const QVector<Note> notes = benchmarkNotes();
+
+		QBENCHMARK
+		{
+			pattern->clearNotes();
+			pattern->addNotes(notes, false);
+		}
+		QCOMPARE(pattern->notes().size(), int(BENCHMARK_NOTES));
+	}
+
+	void benchmarkIteration()
+	{
+		Pattern* pattern = createPattern();
+		pattern->addNotes(benchmarkNotes(), false);
+
+		int sum = 0;
+		QBENCHMARK
+		{
+			sum = 0;
+			for (const Note* note : pattern->notes())
+			{
+				sum += note->length() + note->key();
+			}
+		}
+		QVERIFY(sum > 0);
+	}
+
+	// what InstrumentTrack::play() does for every tick of the song
+	void benchmarkRangeQuery()
+	{
+		Pattern* pattern = createPattern();
+		pattern->addNotes(benchmarkNotes(), false);
+		const int end = pattern->notes().last()->pos() + 1;
+
+		int found = 0;
+		QBENCHMARK
+		{
+			found = 0;
+			for (int pos = 1; pos < end; pos += 7)
+			{
+				for (NoteVector::ConstIterator it = pattern->firstNoteFrom(MidiTime(pos));
+						it != pattern->notes().end() && (*it)->pos() == pos; ++it)
+				{
+					++found;
+				}
+			}
+		}
+		QVERIFY(found > 0);
+	}
+} PatternTests;
+
+#include "PatternTest.moc"